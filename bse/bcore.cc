@@ -525,6 +525,83 @@ bse_test_feature_toggles()
   b = feature_toggle_bool ("x", ""); TCMP (b, ==, true); // *any* feature?
 }
 
+BSE_INTEGRITY_TEST (bse_test_atomic_bounded_queue);
+static void
+bse_test_atomic_bounded_queue()
+{
+  AtomicBoundedQueue<int> queue (5);
+  TCMP (queue.capacity(), ==, size_t (8));
+  int v = -1;
+  TASSERT (queue.pop (&v) == false);
+  for (int i = 0; i < 8; i++)
+    TASSERT (queue.push (i));
+  TASSERT (queue.push (8) == false);
+  for (int i = 0; i < 4; i++)
+    {
+      TASSERT (queue.pop (&v));
+      TCMP (v, ==, i);
+      TASSERT (queue.push (8 + i));
+    }
+  for (int i = 4; i < 12; i++)
+    {
+      TASSERT (queue.pop (&v));
+      TCMP (v, ==, i);
+    }
+  TASSERT (queue.pop (&v) == false);
+}
+
+BSE_INTEGRITY_TEST (bse_test_spsc_ring);
+static void
+bse_test_spsc_ring()
+{
+  SpscRing<uint> ring (5);
+  TCMP (ring.capacity(), ==, size_t (8));
+  uint v = 0, values[8] = { 0, };
+  TASSERT (ring.pop (&v) == false);
+  for (uint i = 0; i < 8; i++)
+    TASSERT (ring.push (i));
+  TASSERT (ring.push (8) == false);
+  TCMP (ring.space(), ==, size_t (0));
+  TCMP (ring.pop (values, 3), ==, size_t (3));
+  TCMP (values[2], ==, 2);
+  const uint more[4] = { 8, 9, 10, 11 };
+  TASSERT (ring.push (more, 4) == false);       // all or nothing
+  TASSERT (ring.push (more, 3));
+  TCMP (ring.pop (values, 8), ==, size_t (8)); // wraps around
+  for (uint i = 0; i < 8; i++)
+    TCMP (values[i], ==, 3 + i);
+  TASSERT (ring.pop (&v) == false);
+  // concurrent producer and consumer, mixing single and bulk transfers
+  const uint N = 250000;
+  SpscRing<uint> cring (64);
+  std::thread producer ([&cring, N] () {
+      uint block[7];
+      for (uint i = 0; i < N; )
+        {
+          const uint n = i % 3 ? 1 : std::min (7u, N - i);
+          for (uint j = 0; j < n; j++)
+            block[j] = i + j;
+          if (n == 1 ? cring.push (block[0]) : cring.push (block, n))
+            i += n;
+          else
+            std::this_thread::yield();
+        }
+    });
+  uint next = 0;
+  bool ordered = true;
+  while (next < N)
+    {
+      const size_t n = next & 1 ? cring.pop (values) : cring.pop (values, 5);
+      for (size_t j = 0; j < n; j++)
+        ordered &= values[j] == next++;
+      if (!n)
+        std::this_thread::yield();
+    }
+  producer.join();
+  TASSERT (ordered);
+  TASSERT (cring.pop (&v) == false);
+}
+
 } // Anon
 
 // == aidacc/aida.cc ==
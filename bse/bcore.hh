@@ -11,6 +11,7 @@
 #include <numeric>
 #include <algorithm>
 #include <list>
+#include <atomic>
 
 namespace Bse {
 
@@ -367,6 +368,265 @@ public:
   Spinlock& operator=   (const Spinlock&) = delete;
 };
 
+// == WorkStealingDeque ==
+/** Lock-free work-stealing deque with fixed capacity (Chase-Lev).
+ * The owning thread uses push() and pop() at the bottom end, any other thread may steal() from the top end.
+ * The capacity is fixed at reset() time and must be a power of 2, values must be trivially copyable.
+ * A reset() may only be issued while no other thread accesses the deque.
+ */
+template<class Value>
+class WorkStealingDeque {
+  static_assert (std::is_trivially_copyable<Value>::value, "WorkStealingDeque<Value> requires trivially copyable Value");
+  alignas (64) std::atomic<int64> top_ { 0 };
+  alignas (64) std::atomic<int64> bottom_ { 0 };
+  std::vector<std::atomic<Value>> slots_;
+  int64                           mask_ = 0;
+public:
+  /// Empty the deque and ensure room for at least @a capacity elements.
+  void
+  reset (size_t capacity)
+  {
+    size_t n = 1;
+    while (n < capacity)
+      n <<= 1;
+    if (slots_.size() < n)
+      slots_ = std::vector<std::atomic<Value>> (n);
+    mask_ = slots_.size() - 1;
+    top_.store (0, std::memory_order_relaxed);
+    bottom_.store (0, std::memory_order_relaxed);
+  }
+  /// Add @a v at the bottom end, may only be called by the owning thread.
+  void
+  push (Value v)
+  {
+    const int64 b = bottom_.load (std::memory_order_relaxed);
+    BSE_ASSERT_RETURN (b - top_.load (std::memory_order_acquire) <= mask_);
+    slots_[b & mask_].store (v, std::memory_order_relaxed);
+    bottom_.store (b + 1, std::memory_order_release);
+  }
+  /// Remove the most recently pushed value, may only be called by the owning thread.
+  bool
+  pop (Value *v)
+  {
+    const int64 b = bottom_.load (std::memory_order_relaxed) - 1;
+    bottom_.store (b, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    int64 t = top_.load (std::memory_order_relaxed);
+    bool found = false;
+    if (t <= b)
+      {
+        *v = slots_[b & mask_].load (std::memory_order_relaxed);
+        found = true;
+        if (t == b) // last element, compete with stealers
+          {
+            found = top_.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store (b + 1, std::memory_order_relaxed);
+          }
+      }
+    else
+      bottom_.store (b + 1, std::memory_order_relaxed);
+    return found;
+  }
+  /// Remove the least recently pushed value, may be called from any thread.
+  bool
+  steal (Value *v)
+  {
+    int64 t = top_.load (std::memory_order_acquire);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    const int64 b = bottom_.load (std::memory_order_acquire);
+    if (t >= b)
+      return false;
+    *v = slots_[t & mask_].load (std::memory_order_relaxed);
+    return top_.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+  /// Check for pending values, the result is only a snapshot if other threads operate on the deque.
+  bool
+  empty () const
+  {
+    return bottom_.load (std::memory_order_relaxed) <= top_.load (std::memory_order_relaxed);
+  }
+};
+
+// == AtomicBoundedQueue ==
+/** Lock-free multi-producer multi-consumer queue with fixed capacity.
+ * Any thread may push() or pop() without blocking, push() fails once the queue is full.
+ * Each slot carries a sequence number (Vyukov) to hand over values between producers and consumers.
+ */
+template<class Value>
+class AtomicBoundedQueue {
+  static_assert (std::is_trivially_copyable<Value>::value, "AtomicBoundedQueue<Value> requires trivially copyable Value");
+  struct Cell {
+    std::atomic<size_t> seq;
+    Value               value;
+  };
+  std::unique_ptr<Cell[]>          cells_;
+  size_t                           mask_ = 0;
+  alignas (64) std::atomic<size_t> head_ { 0 };
+  alignas (64) std::atomic<size_t> tail_ { 0 };
+public:
+  /// Create a queue with room for at least @a capacity elements.
+  explicit
+  AtomicBoundedQueue (size_t capacity)
+  {
+    size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    cells_.reset (new Cell[n]);
+    for (size_t i = 0; i < n; i++)
+      cells_[i].seq.store (i, std::memory_order_relaxed);
+    mask_ = n - 1;
+  }
+  /// Append @a v at the tail, returns false if the queue is full.
+  bool
+  push (const Value &v)
+  {
+    size_t pos = head_.load (std::memory_order_relaxed);
+    for (;;)
+      {
+        Cell &cell = cells_[pos & mask_];
+        const ssize_t dif = ssize_t (cell.seq.load (std::memory_order_acquire)) - ssize_t (pos);
+        if (dif == 0)
+          {
+            if (head_.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+              {
+                cell.value = v;
+                cell.seq.store (pos + 1, std::memory_order_release);
+                return true;
+              }
+          }
+        else if (dif < 0)
+          return false; // full
+        else
+          pos = head_.load (std::memory_order_relaxed);
+      }
+  }
+  /// Remove the oldest value, returns false if the queue is empty.
+  bool
+  pop (Value *v)
+  {
+    size_t pos = tail_.load (std::memory_order_relaxed);
+    for (;;)
+      {
+        Cell &cell = cells_[pos & mask_];
+        const ssize_t dif = ssize_t (cell.seq.load (std::memory_order_acquire)) - ssize_t (pos + 1);
+        if (dif == 0)
+          {
+            if (tail_.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+              {
+                *v = cell.value;
+                cell.seq.store (pos + mask_ + 1, std::memory_order_release);
+                return true;
+              }
+          }
+        else if (dif < 0)
+          return false; // empty
+        else
+          pos = tail_.load (std::memory_order_relaxed);
+      }
+  }
+  /// Maximum number of elements that the queue can hold.
+  size_t capacity () const { return mask_ + 1; }
+  /*copy*/              AtomicBoundedQueue (const AtomicBoundedQueue&) = delete;
+  AtomicBoundedQueue&   operator=          (const AtomicBoundedQueue&) = delete;
+};
+
+// == SpscRing ==
+/** Lock-free single-producer single-consumer ring buffer with fixed capacity.
+ * Exactly one thread may push() and exactly one other thread may pop(), neither blocks, allocates or locks.
+ */
+template<class Value>
+class SpscRing {
+  static_assert (std::is_trivially_copyable<Value>::value, "SpscRing<Value> requires trivially copyable Value");
+  std::unique_ptr<Value[]>         slots_;
+  size_t                           mask_ = 0;
+  alignas (64) std::atomic<size_t> head_ { 0 };       // written by producer
+  size_t                           tail_cache_ = 0;   // producer copy of tail_
+  alignas (64) std::atomic<size_t> tail_ { 0 };       // written by consumer
+  size_t                           head_cache_ = 0;   // consumer copy of head_
+public:
+  /// Create a ring with room for at least @a capacity elements.
+  explicit
+  SpscRing (size_t capacity)
+  {
+    size_t n = 2;
+    while (n < capacity)
+      n <<= 1;
+    slots_.reset (new Value[n]);
+    mask_ = n - 1;
+  }
+  /// Append @a v, returns false if the ring is full, may only be called by the producer.
+  bool
+  push (const Value &v)
+  {
+    const size_t head = head_.load (std::memory_order_relaxed);
+    if (head - tail_cache_ > mask_)
+      {
+        tail_cache_ = tail_.load (std::memory_order_acquire);
+        if (head - tail_cache_ > mask_)
+          return false;
+      }
+    slots_[head & mask_] = v;
+    head_.store (head + 1, std::memory_order_release);
+    return true;
+  }
+  /// Remove the oldest value, returns false if the ring is empty, may only be called by the consumer.
+  bool
+  pop (Value *v)
+  {
+    const size_t tail = tail_.load (std::memory_order_relaxed);
+    if (tail == head_cache_)
+      {
+        head_cache_ = head_.load (std::memory_order_acquire);
+        if (tail == head_cache_)
+          return false;
+      }
+    *v = slots_[tail & mask_];
+    tail_.store (tail + 1, std::memory_order_release);
+    return true;
+  }
+  /// Append all @a n_values or none, returns false if the ring lacks space, may only be called by the producer.
+  bool
+  push (const Value *values, size_t n_values)
+  {
+    const size_t head = head_.load (std::memory_order_relaxed);
+    if (head - tail_cache_ + n_values > mask_ + 1)
+      {
+        tail_cache_ = tail_.load (std::memory_order_acquire);
+        if (head - tail_cache_ + n_values > mask_ + 1)
+          return false;
+      }
+    const size_t offset = head & mask_, n_first = std::min (n_values, mask_ + 1 - offset);
+    std::copy (values, values + n_first, &slots_[offset]);
+    std::copy (values + n_first, values + n_values, &slots_[0]);
+    head_.store (head + n_values, std::memory_order_release);
+    return true;
+  }
+  /// Remove up to @a max_values of the oldest values, returns the number of values removed, may only be called by the consumer.
+  size_t
+  pop (Value *values, size_t max_values)
+  {
+    const size_t tail = tail_.load (std::memory_order_relaxed);
+    if (tail + max_values > head_cache_)
+      head_cache_ = head_.load (std::memory_order_acquire);
+    const size_t n_values = std::min (max_values, head_cache_ - tail);
+    const size_t offset = tail & mask_, n_first = std::min (n_values, mask_ + 1 - offset);
+    std::copy (&slots_[offset], &slots_[offset] + n_first, values);
+    std::copy (&slots_[0], &slots_[0] + (n_values - n_first), values + n_first);
+    tail_.store (tail + n_values, std::memory_order_release);
+    return n_values;
+  }
+  /// Number of elements that can currently be pushed, only accurate in the producer thread.
+  size_t
+  space () const
+  {
+    return mask_ + 1 - (head_.load (std::memory_order_relaxed) - tail_.load (std::memory_order_acquire));
+  }
+  /// Maximum number of elements that the ring can hold.
+  size_t capacity () const { return mask_ + 1; }
+  /*copy*/  SpscRing  (const SpscRing&) = delete;
+  SpscRing& operator= (const SpscRing&) = delete;
+};
+
 // == AsyncBlockingQueue ==
 /** Asyncronous queue to push/pop values across thread boundaries.
  * The AsyncBlockingQueue is a thread-safe asyncronous queue which blocks in pop() until data is provided through push() from any thread.
@@ -1,6 +1,13 @@
 // Licensed GNU LGPL v2.1 or later: http://www.gnu.org/licenses/lgpl.html
 #include "bseblockutils.hh"
 #include "bse/internal.hh"
+#include "bse/platform.hh"
+#if defined __x86_64__ || defined __amd64__
+#include <immintrin.h>
+#define BSE_BLOCK_X86_KERNELS   1
+#define BSE_TARGET_AVX2         __attribute__ ((__target__ ("avx2,fma")))
+#define BSE_TARGET_AVX512       __attribute__ ((__target__ ("avx512f")))
+#endif
 
 namespace {
 class BlockImpl : virtual public Bse::Block::Impl {
@@ -134,6 +141,462 @@ class BlockImpl : virtual public Bse::Block::Impl {
   }
 };
 static BlockImpl default_block_impl;
+
+#ifdef BSE_BLOCK_X86_KERNELS
+// == AVX2 ==
+BSE_TARGET_AVX2 static inline float
+avx2_reduce_add (__m256 v)
+{
+  __m128 s = _mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_add_ss (s, _mm_movehdup_ps (s));
+  return _mm_cvtss_f32 (s);
+}
+
+BSE_TARGET_AVX2 static inline float
+avx2_reduce_min (__m256 v)
+{
+  __m128 s = _mm_min_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+  s = _mm_min_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_min_ss (s, _mm_movehdup_ps (s));
+  return _mm_cvtss_f32 (s);
+}
+
+BSE_TARGET_AVX2 static inline float
+avx2_reduce_max (__m256 v)
+{
+  __m128 s = _mm_max_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+  s = _mm_max_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_max_ss (s, _mm_movehdup_ps (s));
+  return _mm_cvtss_f32 (s);
+}
+
+/* Unaligned loads and stores are used throughout, they cost nothing extra on AVX
+ * capable CPUs for aligned addresses and avoid alignment prologues.
+ */
+class Avx2BlockImpl : virtual public Bse::Block::Impl {
+  virtual const char*
+  impl_name ()
+  {
+    return "AVX2";
+  }
+  BSE_TARGET_AVX2 virtual void
+  add (guint        n_values,
+       float       *ovalues,
+       const float *ivalues)
+  {
+    guint i = 0;
+    for (; i + 8 <= n_values; i += 8)
+      _mm256_storeu_ps (ovalues + i, _mm256_add_ps (_mm256_loadu_ps (ovalues + i), _mm256_loadu_ps (ivalues + i)));
+    for (; i < n_values; i++)
+      ovalues[i] += ivalues[i];
+  }
+  BSE_TARGET_AVX2 virtual void
+  sub (guint        n_values,
+       float       *ovalues,
+       const float *ivalues)
+  {
+    guint i = 0;
+    for (; i + 8 <= n_values; i += 8)
+      _mm256_storeu_ps (ovalues + i, _mm256_sub_ps (_mm256_loadu_ps (ovalues + i), _mm256_loadu_ps (ivalues + i)));
+    for (; i < n_values; i++)
+      ovalues[i] -= ivalues[i];
+  }
+  BSE_TARGET_AVX2 virtual void
+  mul (guint        n_values,
+       float       *ovalues,
+       const float *ivalues)
+  {
+    guint i = 0;
+    for (; i + 8 <= n_values; i += 8)
+      _mm256_storeu_ps (ovalues + i, _mm256_mul_ps (_mm256_loadu_ps (ovalues + i), _mm256_loadu_ps (ivalues + i)));
+    for (; i < n_values; i++)
+      ovalues[i] *= ivalues[i];
+  }
+  BSE_TARGET_AVX2 virtual void
+  scale (guint        n_values,
+         float       *ovalues,
+         const float *ivalues,
+         const float  level)
+  {
+    const __m256 vlevel = _mm256_set1_ps (level);
+    guint i = 0;
+    for (; i + 8 <= n_values; i += 8)
+      _mm256_storeu_ps (ovalues + i, _mm256_mul_ps (_mm256_loadu_ps (ivalues + i), vlevel));
+    for (; i < n_values; i++)
+      ovalues[i] = ivalues[i] * level;
+  }
+  BSE_TARGET_AVX2 virtual void
+  interleave2 (guint	       n_ivalues,
+               float          *ovalues,         /* length_ovalues = n_ivalues * 2 */
+               const float    *ivalues,
+               guint           offset)          /* 0=left, 1=right */
+  {
+    // duplicate each input value and store it into every other output slot only
+    const __m256i ilo = _mm256_setr_epi32 (0, 0, 1, 1, 2, 2, 3, 3), ihi = _mm256_setr_epi32 (4, 4, 5, 5, 6, 6, 7, 7);
+    const __m256i mask = offset ? _mm256_setr_epi32 (0, -1, 0, -1, 0, -1, 0, -1) : _mm256_setr_epi32 (-1, 0, -1, 0, -1, 0, -1, 0);
+    guint i = 0;
+    for (; i + 8 <= n_ivalues; i += 8)
+      {
+        const __m256 v = _mm256_loadu_ps (ivalues + i);
+        _mm256_maskstore_ps (ovalues + 2 * i, mask, _mm256_permutevar8x32_ps (v, ilo));
+        _mm256_maskstore_ps (ovalues + 2 * i + 8, mask, _mm256_permutevar8x32_ps (v, ihi));
+      }
+    for (; i < n_ivalues; i++)
+      ovalues[2 * i + offset] = ivalues[i];
+  }
+  BSE_TARGET_AVX2 virtual void
+  interleave2_add (guint           n_ivalues,
+                   float          *ovalues,	/* length_ovalues = n_ivalues * 2 */
+                   const float    *ivalues,
+                   guint           offset)      /* 0=left, 1=right */
+  {
+    const __m256i ilo = _mm256_setr_epi32 (0, 0, 1, 1, 2, 2, 3, 3), ihi = _mm256_setr_epi32 (4, 4, 5, 5, 6, 6, 7, 7);
+    const __m256i mask = offset ? _mm256_setr_epi32 (0, -1, 0, -1, 0, -1, 0, -1) : _mm256_setr_epi32 (-1, 0, -1, 0, -1, 0, -1, 0);
+    guint i = 0;
+    for (; i + 8 <= n_ivalues; i += 8)
+      {
+        const __m256 v = _mm256_loadu_ps (ivalues + i);
+        float *o = ovalues + 2 * i;
+        _mm256_maskstore_ps (o, mask, _mm256_add_ps (_mm256_loadu_ps (o), _mm256_permutevar8x32_ps (v, ilo)));
+        _mm256_maskstore_ps (o + 8, mask, _mm256_add_ps (_mm256_loadu_ps (o + 8), _mm256_permutevar8x32_ps (v, ihi)));
+      }
+    for (; i < n_ivalues; i++)
+      ovalues[2 * i + offset] += ivalues[i];
+  }
+  BSE_TARGET_AVX2 virtual void
+  range (guint        n_values,
+         const float *ivalues,
+	 float&       min_value,
+	 float&       max_value)
+  {
+    if (!n_values)
+      {
+        min_value = max_value = 0;
+        return;
+      }
+    __m256 vmin = _mm256_set1_ps (ivalues[0]), vmax = vmin;
+    guint i = 0;
+    for (; i + 8 <= n_values; i += 8)
+      {
+        const __m256 v = _mm256_loadu_ps (ivalues + i);
+        vmin = _mm256_min_ps (vmin, v);
+        vmax = _mm256_max_ps (vmax, v);
+      }
+    float minv = avx2_reduce_min (vmin), maxv = avx2_reduce_max (vmax);
+    for (; i < n_values; i++)
+      {
+        minv = std::min (minv, ivalues[i]);
+        maxv = std::max (maxv, ivalues[i]);
+      }
+    min_value = minv;
+    max_value = maxv;
+  }
+  BSE_TARGET_AVX2 virtual float
+  square_sum (guint        n_values,
+              const float *ivalues)
+  {
+    // two accumulators to hide the FMA latency
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    guint i = 0;
+    for (; i + 16 <= n_values; i += 16)
+      {
+        const __m256 v0 = _mm256_loadu_ps (ivalues + i), v1 = _mm256_loadu_ps (ivalues + i + 8);
+        acc0 = _mm256_fmadd_ps (v0, v0, acc0);
+        acc1 = _mm256_fmadd_ps (v1, v1, acc1);
+      }
+    for (; i + 8 <= n_values; i += 8)
+      {
+        const __m256 v = _mm256_loadu_ps (ivalues + i);
+        acc0 = _mm256_fmadd_ps (v, v, acc0);
+      }
+    float square_sum = avx2_reduce_add (_mm256_add_ps (acc0, acc1));
+    for (; i < n_values; i++)
+      square_sum += ivalues[i] * ivalues[i];
+    return square_sum;
+  }
+  BSE_TARGET_AVX2 virtual float
+  range_and_square_sum (guint        n_values,
+                        const float *ivalues,
+	                float&       min_value,
+	                float&       max_value)
+  {
+    if (!n_values)
+      {
+        min_value = max_value = 0;
+        return 0;
+      }
+    __m256 vmin = _mm256_set1_ps (ivalues[0]), vmax = vmin, acc = _mm256_setzero_ps();
+    guint i = 0;
+    for (; i + 8 <= n_values; i += 8)
+      {
+        const __m256 v = _mm256_loadu_ps (ivalues + i);
+        vmin = _mm256_min_ps (vmin, v);
+        vmax = _mm256_max_ps (vmax, v);
+        acc = _mm256_fmadd_ps (v, v, acc);
+      }
+    float minv = avx2_reduce_min (vmin), maxv = avx2_reduce_max (vmax), square_sum = avx2_reduce_add (acc);
+    for (; i < n_values; i++)
+      {
+        minv = std::min (minv, ivalues[i]);
+        maxv = std::max (maxv, ivalues[i]);
+        square_sum += ivalues[i] * ivalues[i];
+      }
+    min_value = minv;
+    max_value = maxv;
+    return square_sum;
+  }
+};
+static Avx2BlockImpl avx2_block_impl;
+
+// == AVX-512 ==
+// the intrinsics pass _mm512_undefined_ps() as merge source, which trips GCC-12 (bug 105593)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+BSE_TARGET_AVX512 static inline __mmask16
+avx512_tail_mask (guint n)
+{
+  return __mmask16 ((1u << n) - 1);     // n < 16
+}
+
+// fold the four 128 bit lanes, so lane 0 holds the reduction of the lane-wise values
+#define AVX512_FOLD_LANES(OP, v) ({                                             \
+  __m512 __f = OP (v, _mm512_shuffle_f32x4 (v, v, _MM_SHUFFLE (1, 0, 3, 2)));   \
+  __f = OP (__f, _mm512_shuffle_f32x4 (__f, __f, _MM_SHUFFLE (2, 3, 0, 1)));    \
+  _mm512_castps512_ps128 (__f); })
+
+BSE_TARGET_AVX512 static inline float
+avx512_reduce_add (__m512 v)
+{
+  __m128 s = AVX512_FOLD_LANES (_mm512_add_ps, v);
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_add_ss (s, _mm_movehdup_ps (s));
+  return _mm_cvtss_f32 (s);
+}
+
+BSE_TARGET_AVX512 static inline float
+avx512_reduce_min (__m512 v)
+{
+  __m128 s = AVX512_FOLD_LANES (_mm512_min_ps, v);
+  s = _mm_min_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_min_ss (s, _mm_movehdup_ps (s));
+  return _mm_cvtss_f32 (s);
+}
+
+BSE_TARGET_AVX512 static inline float
+avx512_reduce_max (__m512 v)
+{
+  __m128 s = AVX512_FOLD_LANES (_mm512_max_ps, v);
+  s = _mm_max_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_max_ss (s, _mm_movehdup_ps (s));
+  return _mm_cvtss_f32 (s);
+}
+
+/* Tails are handled with masked loads and stores, masked lanes cannot fault. */
+class Avx512BlockImpl : virtual public Bse::Block::Impl {
+  virtual const char*
+  impl_name ()
+  {
+    return "AVX512";
+  }
+  BSE_TARGET_AVX512 virtual void
+  add (guint        n_values,
+       float       *ovalues,
+       const float *ivalues)
+  {
+    guint i = 0;
+    for (; i + 16 <= n_values; i += 16)
+      _mm512_storeu_ps (ovalues + i, _mm512_add_ps (_mm512_loadu_ps (ovalues + i), _mm512_loadu_ps (ivalues + i)));
+    if (i < n_values)
+      {
+        const __mmask16 m = avx512_tail_mask (n_values - i);
+        _mm512_mask_storeu_ps (ovalues + i, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, ovalues + i), _mm512_maskz_loadu_ps (m, ivalues + i)));
+      }
+  }
+  BSE_TARGET_AVX512 virtual void
+  sub (guint        n_values,
+       float       *ovalues,
+       const float *ivalues)
+  {
+    guint i = 0;
+    for (; i + 16 <= n_values; i += 16)
+      _mm512_storeu_ps (ovalues + i, _mm512_sub_ps (_mm512_loadu_ps (ovalues + i), _mm512_loadu_ps (ivalues + i)));
+    if (i < n_values)
+      {
+        const __mmask16 m = avx512_tail_mask (n_values - i);
+        _mm512_mask_storeu_ps (ovalues + i, m, _mm512_sub_ps (_mm512_maskz_loadu_ps (m, ovalues + i), _mm512_maskz_loadu_ps (m, ivalues + i)));
+      }
+  }
+  BSE_TARGET_AVX512 virtual void
+  mul (guint        n_values,
+       float       *ovalues,
+       const float *ivalues)
+  {
+    guint i = 0;
+    for (; i + 16 <= n_values; i += 16)
+      _mm512_storeu_ps (ovalues + i, _mm512_mul_ps (_mm512_loadu_ps (ovalues + i), _mm512_loadu_ps (ivalues + i)));
+    if (i < n_values)
+      {
+        const __mmask16 m = avx512_tail_mask (n_values - i);
+        _mm512_mask_storeu_ps (ovalues + i, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, ovalues + i), _mm512_maskz_loadu_ps (m, ivalues + i)));
+      }
+  }
+  BSE_TARGET_AVX512 virtual void
+  scale (guint        n_values,
+         float       *ovalues,
+         const float *ivalues,
+         const float  level)
+  {
+    const __m512 vlevel = _mm512_set1_ps (level);
+    guint i = 0;
+    for (; i + 16 <= n_values; i += 16)
+      _mm512_storeu_ps (ovalues + i, _mm512_mul_ps (_mm512_loadu_ps (ivalues + i), vlevel));
+    if (i < n_values)
+      {
+        const __mmask16 m = avx512_tail_mask (n_values - i);
+        _mm512_mask_storeu_ps (ovalues + i, m, _mm512_mul_ps (_mm512_maskz_loadu_ps (m, ivalues + i), vlevel));
+      }
+  }
+  BSE_TARGET_AVX512 virtual void
+  interleave2 (guint	       n_ivalues,
+               float          *ovalues,         /* length_ovalues = n_ivalues * 2 */
+               const float    *ivalues,
+               guint           offset)          /* 0=left, 1=right */
+  {
+    const __m512i ilo = _mm512_setr_epi32 (0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+    const __m512i ihi = _mm512_setr_epi32 (8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15);
+    const __mmask16 m = offset ? 0xaaaa : 0x5555;
+    guint i = 0;
+    for (; i + 16 <= n_ivalues; i += 16)
+      {
+        const __m512 v = _mm512_loadu_ps (ivalues + i);
+        _mm512_mask_storeu_ps (ovalues + 2 * i, m, _mm512_permutexvar_ps (ilo, v));
+        _mm512_mask_storeu_ps (ovalues + 2 * i + 16, m, _mm512_permutexvar_ps (ihi, v));
+      }
+    for (; i < n_ivalues; i++)
+      ovalues[2 * i + offset] = ivalues[i];
+  }
+  BSE_TARGET_AVX512 virtual void
+  interleave2_add (guint           n_ivalues,
+                   float          *ovalues,	/* length_ovalues = n_ivalues * 2 */
+                   const float    *ivalues,
+                   guint           offset)      /* 0=left, 1=right */
+  {
+    const __m512i ilo = _mm512_setr_epi32 (0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+    const __m512i ihi = _mm512_setr_epi32 (8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15);
+    const __mmask16 m = offset ? 0xaaaa : 0x5555;
+    guint i = 0;
+    for (; i + 16 <= n_ivalues; i += 16)
+      {
+        const __m512 v = _mm512_loadu_ps (ivalues + i);
+        float *o = ovalues + 2 * i;
+        _mm512_mask_storeu_ps (o, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, o), _mm512_permutexvar_ps (ilo, v)));
+        _mm512_mask_storeu_ps (o + 16, m, _mm512_add_ps (_mm512_maskz_loadu_ps (m, o + 16), _mm512_permutexvar_ps (ihi, v)));
+      }
+    for (; i < n_ivalues; i++)
+      ovalues[2 * i + offset] += ivalues[i];
+  }
+  BSE_TARGET_AVX512 virtual void
+  range (guint        n_values,
+         const float *ivalues,
+	 float&       min_value,
+	 float&       max_value)
+  {
+    if (!n_values)
+      {
+        min_value = max_value = 0;
+        return;
+      }
+    __m512 vmin = _mm512_set1_ps (ivalues[0]), vmax = vmin;
+    guint i = 0;
+    for (; i + 16 <= n_values; i += 16)
+      {
+        const __m512 v = _mm512_loadu_ps (ivalues + i);
+        vmin = _mm512_min_ps (vmin, v);
+        vmax = _mm512_max_ps (vmax, v);
+      }
+    if (i < n_values)
+      {
+        const __mmask16 m = avx512_tail_mask (n_values - i);
+        const __m512 v = _mm512_maskz_loadu_ps (m, ivalues + i);
+        vmin = _mm512_mask_min_ps (vmin, m, vmin, v);
+        vmax = _mm512_mask_max_ps (vmax, m, vmax, v);
+      }
+    min_value = avx512_reduce_min (vmin);
+    max_value = avx512_reduce_max (vmax);
+  }
+  BSE_TARGET_AVX512 virtual float
+  square_sum (guint        n_values,
+              const float *ivalues)
+  {
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    guint i = 0;
+    for (; i + 32 <= n_values; i += 32)
+      {
+        const __m512 v0 = _mm512_loadu_ps (ivalues + i), v1 = _mm512_loadu_ps (ivalues + i + 16);
+        acc0 = _mm512_fmadd_ps (v0, v0, acc0);
+        acc1 = _mm512_fmadd_ps (v1, v1, acc1);
+      }
+    for (; i + 16 <= n_values; i += 16)
+      {
+        const __m512 v = _mm512_loadu_ps (ivalues + i);
+        acc0 = _mm512_fmadd_ps (v, v, acc0);
+      }
+    if (i < n_values)
+      {
+        const __m512 v = _mm512_maskz_loadu_ps (avx512_tail_mask (n_values - i), ivalues + i);
+        acc1 = _mm512_fmadd_ps (v, v, acc1);
+      }
+    return avx512_reduce_add (_mm512_add_ps (acc0, acc1));
+  }
+  BSE_TARGET_AVX512 virtual float
+  range_and_square_sum (guint        n_values,
+                        const float *ivalues,
+	                float&       min_value,
+	                float&       max_value)
+  {
+    if (!n_values)
+      {
+        min_value = max_value = 0;
+        return 0;
+      }
+    __m512 vmin = _mm512_set1_ps (ivalues[0]), vmax = vmin, acc = _mm512_setzero_ps();
+    guint i = 0;
+    for (; i + 16 <= n_values; i += 16)
+      {
+        const __m512 v = _mm512_loadu_ps (ivalues + i);
+        vmin = _mm512_min_ps (vmin, v);
+        vmax = _mm512_max_ps (vmax, v);
+        acc = _mm512_fmadd_ps (v, v, acc);
+      }
+    if (i < n_values)
+      {
+        const __mmask16 m = avx512_tail_mask (n_values - i);
+        const __m512 v = _mm512_maskz_loadu_ps (m, ivalues + i);
+        vmin = _mm512_mask_min_ps (vmin, m, vmin, v);
+        vmax = _mm512_mask_max_ps (vmax, m, vmax, v);
+        acc = _mm512_fmadd_ps (v, v, acc);
+      }
+    min_value = avx512_reduce_min (vmin);
+    max_value = avx512_reduce_max (vmax);
+    return avx512_reduce_add (acc);
+  }
+};
+static Avx512BlockImpl avx512_block_impl;
+#pragma GCC diagnostic pop
+#endif // BSE_BLOCK_X86_KERNELS
+
+// Pick the widest kernels supported by CPU and OS, $BSE_BLOCK_IMPL=FPU forces the default.
+static Bse::Block::Impl*
+select_block_impl ()
+{
+  const std::vector<Bse::Block::Impl*> impls = Bse::Block::available_impls();
+  std::vector<const char*> names;
+  for (Bse::Block::Impl *impl : impls)
+    names.push_back (Bse::Block::impl_name (impl));
+  return impls[Bse::cpu_select_impl ("BSE_BLOCK_IMPL", names)];
+}
 } // Anon
 
 namespace Bse {
@@ -146,6 +609,31 @@ Block::default_singleton ()
 
 Block::Impl *Block::singleton = &default_block_impl;
 
+/// List the implementations usable on this machine, widest kernels first, the default last.
+std::vector<Block::Impl*>
+Block::available_impls ()
+{
+  std::vector<Impl*> impls;
+#ifdef BSE_BLOCK_X86_KERNELS
+  if (cpu_has_features ("AVX512F"))
+    impls.push_back (&avx512_block_impl);
+  if (cpu_has_features ("AVX2 FMA"))
+    impls.push_back (&avx2_block_impl);
+#endif
+  impls.push_back (&default_block_impl);
+  return impls;
+}
+
+/// Make `impl` the current implementation, `nullptr` restores the default.
+void
+Block::substitute (Impl *impl)
+{
+  Impl::substitute (impl);
+}
+
+// kernels are selected during static construction, the default is used until then
+static const bool block_impl_selected = (Block::substitute (select_block_impl()), true);
+
 Block::Impl*
 Block::current_singleton ()
 {
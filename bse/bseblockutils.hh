@@ -150,6 +150,9 @@ public:
   };
   static Impl*  default_singleton       ();
   static Impl*  current_singleton       ();
+  static std::vector<Impl*> available_impls ();
+  static void   substitute              (Impl *impl);
+  static const char* impl_name          (Impl *impl)      { return impl->impl_name(); }
 private:
   static Impl  *singleton;
 };
@@ -8,6 +8,7 @@
 #include "bseengineschedule.hh"
 #include "bseieee754.hh"
 #include "bsestartup.hh"        // for TaskRegistry
+#include "profiler.hh"
 #include "bse/internal.hh"
 #include <string.h>
 #include <unistd.h>
@@ -19,22 +20,6 @@
 #define TJOB_DEBUG(...) Bse::debug ("tjob", __VA_ARGS__)
 
 #define	NODE_FLAG_RECONNECT(node)  G_STMT_START { /*(node)->needs_reset = TRUE*/; } G_STMT_END
-/* --- time stamping (debugging) --- */
-#define	ToyprofStamp		struct timeval
-#define	toyprof_clock_name()	("Glibc gettimeofday(2)")
-#define toyprof_stampinit()	/* nothing */
-#define	toyprof_stamp(st)	gettimeofday (&(st), 0)
-#define	toyprof_stamp_ticks()	(1000000)
-static inline guint64
-toyprof_elapsed (ToyprofStamp fstamp,
-		 ToyprofStamp lstamp)
-{
-  guint64 first = fstamp.tv_sec * toyprof_stamp_ticks () + fstamp.tv_usec;
-  guint64 last  = lstamp.tv_sec * toyprof_stamp_ticks () + lstamp.tv_usec;
-  return last - first;
-}
-
-
 /* --- typedefs & structures --- */
 typedef struct _Poll Poll;
 struct _Poll
@@ -848,41 +833,21 @@ master_process_locked_node (Bse::Module *node,
     }
 }
 
-static bool bse_profile_modules = 0;	/* set to 1 in gdb to get profile output */
-
-struct ProfileData {
-  uint64 profile_maxtime;
-  Bse::Module *profile_node;
-};
-
 static void
-thread_process_nodes (const uint n_values, ProfileData *profile)
+thread_process_nodes (const uint worker, const uint n_values)
 {
-  Bse::Module *node = _engine_pop_unprocessed_node ();
+  if (!_engine_process_enter())
+    return;
+  Bse::Module *node = _engine_pop_unprocessed_node (worker);
   while (node)
     {
-      ToyprofStamp profile_stamp1;
-
-      if (UNLIKELY (profile))
-        toyprof_stamp (profile_stamp1);
-
+      const Bse::Profiler::Ticks stamp = Bse::Profiler::ticks();
       master_process_locked_node (node, n_values);
-
-      if (UNLIKELY (profile))
-        {
-          ToyprofStamp profile_stamp2;
-          toyprof_stamp (profile_stamp2);
-          uint64 duration = toyprof_elapsed (profile_stamp1, profile_stamp2);
-          if (duration > profile->profile_maxtime)
-            {
-              profile->profile_maxtime = duration;
-              profile->profile_node = node;
-            }
-        }
-
-      _engine_push_processed_node (node);
-      node = _engine_pop_unprocessed_node ();
+      Bse::Profiler::record (node, typeid (*node), (const void*) node->klass.process, stamp, Bse::Profiler::ticks());
+      _engine_push_processed_node (worker, node);
+      node = _engine_pop_unprocessed_node (worker);
     }
+  _engine_process_leave();
 }
 
 namespace BseInternal {
@@ -897,10 +862,9 @@ engine_start_slaves ()
 {
   assert_return (slaves_running == false);
   slaves_running = true;
-  const uint n_cpus = Bse::this_thread_online_cpus();
-  const uint n_slaves = std::max (1u, n_cpus) - 1;
+  const uint n_slaves = _engine_n_workers() - 1;      // worker 0 is the master thread
   for (uint i = 0; i < n_slaves; i++)
-    slave_threads.push_back (new std::thread (engine_run_slave));
+    slave_threads.push_back (new std::thread (engine_run_slave, 1 + i));
 }
 
 void
@@ -927,14 +891,15 @@ engine_wakeup_slaves()
 }
 
 void
-engine_run_slave ()
+engine_run_slave (uint worker)
 {
   std::string myid = Bse::string_format ("DSP-#%u", ++slave_counter);
   Bse::this_thread_set_name (myid);
   Bse::TaskRegistry::add (myid, Bse::this_thread_getpid(), Bse::this_thread_gettid());
+  Bse::Profiler::register_thread();
   while (slaves_running)
     {
-      thread_process_nodes (bse_engine_block_size(), NULL); // FIXME: merge profile data
+      thread_process_nodes (worker, bse_engine_block_size());
       std::unique_lock<std::mutex> slave_lock (slave_mutex);
       if (!slaves_running)
         break;
@@ -951,8 +916,7 @@ master_process_flow (void)
   const guint64 current_stamp = Bse::TickStamp::current();
   guint n_values = bse_engine_block_size();
   guint64 final_counter = current_stamp + n_values;
-  ProfileData profile_data = { 0, NULL };
-  ProfileData *profile = bse_profile_modules ? &profile_data : NULL;
+  const uint64 busy_start = Bse::timestamp_benchmark();
 
   assert_return (master_need_process == TRUE);
 
@@ -964,7 +928,7 @@ master_process_flow (void)
       _engine_set_schedule (master_schedule);
       BseInternal::engine_wakeup_slaves();
 
-      thread_process_nodes (n_values, profile);
+      thread_process_nodes (0, n_values);
 
       /* walk unscheduled nodes with flow jobs */
       Bse::Module *node = _engine_mnl_head ();
@@ -995,24 +959,11 @@ master_process_flow (void)
             master_take_probes (node, current_stamp, n_values, PROBE_SCHEDULED);
         }
 
-      if (UNLIKELY (profile))
-	{
-	  if (profile->profile_node)
-	    {
-	      if (profile->profile_maxtime > uint64 (bse_profile_modules))
-		Bse::printout ("Excess Node: %p  Duration: %llu usecs     (%p)         \n",
-                               profile->profile_node, (long long unsigned int) profile->profile_maxtime,
-                               &profile->profile_node->klass);
-	      else
-		Bse::printout ("Slowest Node: %p  Duration: %llu usecs     (%p)         \r",
-                               profile->profile_node, (long long unsigned int) profile->profile_maxtime,
-                               &profile->profile_node->klass);
-	    }
-	}
-
       _engine_unset_schedule (master_schedule);
       master_tick_stamp_inc ();
       _engine_recycle_const_values (FALSE);
+      Bse::Profiler::record_block (Bse::timestamp_benchmark() - busy_start,
+                                   n_values * uint64 (1000000000) / bse_engine_sample_freq());
     }
   master_need_process = FALSE;
 }
@@ -1197,6 +1148,7 @@ MasterThread::master_thread()
   const char *const myid = "DSP-Master";
   Bse::this_thread_set_name (myid);
   Bse::TaskRegistry::add (myid, Bse::this_thread_getpid(), Bse::this_thread_gettid());
+  Bse::Profiler::register_thread();
 
   /* assert pollfd equality, since we're simply casting structures */
   static_assert (sizeof (struct pollfd) == sizeof (GPollFD), "");
@@ -1214,7 +1166,6 @@ MasterThread::master_thread()
   master_pollfds[0].events = G_IO_IN;
   master_n_pollfds = 1;
   master_pollfds_changed = TRUE;
-  toyprof_stampinit ();
   while (master_thread_running)
     {
       BseEngineLoop loop;
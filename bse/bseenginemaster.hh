@@ -27,7 +27,7 @@ public:
 
 namespace BseInternal {
 
-void    engine_run_slave        ();
+void    engine_run_slave        (uint worker);
 void    engine_start_slaves     ();
 void    engine_stop_slaves      ();
 void    engine_wakeup_slaves    ();
@@ -58,6 +58,7 @@ public:
   Module                *mnl_next = NULL;
   Module                *mnl_prev = NULL;
   guint                  sched_leaf_level = 0;
+  guint                  sched_task = ~0;               // index into EngineSchedule.tasks while secured
   guint64                local_active = 0;              // local suspend state stamp
   Module                *toplevel_next = NULL;          // master-consumer-list, FIXME: overkill, using a SfiRing is good enough
   SfiRing               *output_nodes = NULL;           // EngineNode* ring of nodes in ->outputs[]
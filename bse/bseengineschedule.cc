@@ -24,10 +24,10 @@ _engine_schedule_new (void)
   sched->cycles = NULL;
   sched->secured = FALSE;
   sched->in_pqueue = FALSE;
-  sched->cur_leaf_level = ~0;
-  sched->cur_node = NULL;
-  sched->cur_cycle = NULL;
   sched->vnodes = NULL;
+  sched->n_tasks = 0;
+  sched->tasks = NULL;
+  sched->task_outputs = NULL;
 
   return sched;
 }
@@ -101,10 +101,8 @@ _engine_schedule_debug_dump (EngineSchedule *sched)
 
       Bse::printerr ("  n_items=%u, n_vnodes=%u, leaf_levels=%u, secured=%u,\n",
                      sched->n_items, sfi_ring_length (sched->vnodes), sched->leaf_levels, sched->secured);
-      Bse::printerr ("  in_pqueue=%u, cur_leaf_level=%u,\n",
-                     sched->in_pqueue, sched->cur_leaf_level);
-      Bse::printerr ("  cur_node=%p, cur_cycle=%p,\n",
-                     sched->cur_node, sched->cur_cycle);
+      Bse::printerr ("  in_pqueue=%u, n_tasks=%u,\n",
+                     sched->in_pqueue, sched->n_tasks);
       for (i = 0; i < sched->leaf_levels; i++)
 	{
 	  SfiRing *ring, *head = sched->nodes[i];
@@ -259,83 +257,77 @@ _engine_schedule_restart (EngineSchedule *sched)
 {
   assert_return (sched != NULL);
   assert_return (sched->secured == TRUE);
-  assert_return (sched->cur_leaf_level == sched->leaf_levels);
-  assert_return (sched->cur_node == NULL);
-  assert_return (sched->cur_cycle == NULL);
+  assert_return (sched->in_pqueue == FALSE);
 
-  sched->cur_leaf_level = 0;
-  if (sched->leaf_levels > 0)
-    {
-      sched->cur_node = sched->nodes[0];
-      sched->cur_cycle = sched->cycles[0];
-    }
+  for (guint i = 0; i < sched->n_tasks; i++)
+    sched->tasks[i].pending.store (sched->tasks[i].n_inputs, std::memory_order_relaxed);
 }
-void
-_engine_schedule_secure (EngineSchedule *sched)
+
+static inline void
+task_add_input (EngineSchedule *sched, guint task, Bse::Module *inode, std::vector<std::pair<guint,guint>> &edges)
 {
-  assert_return (sched != NULL);
-  assert_return (sched->secured == FALSE);
-  sched->secured = TRUE;
-  sched->cur_leaf_level = sched->leaf_levels;
-  if (CHECK_DEBUG())
-    _engine_schedule_debug_dump (sched);
+  /* inputs from cycles or virtual nodes are not tracked, processing pulls those in under lock */
+  if (inode && inode->sched_task < sched->n_tasks)
+    edges.push_back (std::make_pair (inode->sched_task, task));
 }
+
+/* Setup the task graph used by the DSP threads. Each popable node becomes a task with
+ * a counter of pending input tasks, tasks are readied once all their inputs are processed.
+ * Tasks are ordered by leaf level, so all input tasks have lower indices than their outputs.
+ */
 static void
-schedule_advance (EngineSchedule *sched)
+schedule_setup_tasks (EngineSchedule *sched)
 {
-  while (!sched->cur_node && !sched->cur_cycle && sched->cur_leaf_level < sched->leaf_levels)
+  guint i, j, k, n_tasks = 0;
+  for (i = 0; i < sched->leaf_levels; i++)
+    n_tasks += sfi_ring_length (sched->nodes[i]);
+  sched->tasks = n_tasks ? new EngineTask[n_tasks] : NULL;
+  for (i = 0; i < sched->leaf_levels; i++)
+    for (SfiRing *ring = sched->nodes[i]; ring; ring = sfi_ring_walk (ring, sched->nodes[i]))
+      {
+        Bse::Module *node = (Bse::Module*) ring->data;
+        EngineTask *task = &sched->tasks[sched->n_tasks];
+        node->sched_task = sched->n_tasks++;
+        task->node = node;
+        task->n_inputs = 0;
+        task->pending = 0;
+        task->n_outputs = 0;
+        task->outputs = NULL;
+      }
+  /* collect unique (input, output) task edges */
+  std::vector<std::pair<guint,guint>> edges;
+  for (i = 0; i < sched->n_tasks; i++)
     {
-      sched->cur_leaf_level += 1;
-      if (sched->cur_leaf_level < sched->leaf_levels)
-	{
-	  sched->cur_node = sched->nodes[sched->cur_leaf_level];
-	  sched->cur_cycle = sched->cycles[sched->cur_leaf_level];
-	}
+      Bse::Module *node = sched->tasks[i].node;
+      for (j = 0; j < BSE_MODULE_N_ISTREAMS (node); j++)
+        task_add_input (sched, i, node->inputs[j].real_node, edges);
+      for (j = 0; j < BSE_MODULE_N_JSTREAMS (node); j++)
+        for (k = 0; k < node->jstreams[j].n_connections; k++)
+          task_add_input (sched, i, node->jinputs[j][k].real_node, edges);
     }
-}
-
-Bse::Module*
-_engine_schedule_pop_node (EngineSchedule *sched)
-{
-  assert_return (sched != NULL, NULL);
-  assert_return (sched->secured == TRUE, NULL);
-  assert_return (sched->cur_leaf_level <= sched->leaf_levels, NULL);
-  do
+  std::sort (edges.begin(), edges.end());
+  edges.erase (std::unique (edges.begin(), edges.end()), edges.end());
+  sched->task_outputs = edges.empty() ? NULL : g_new (guint, edges.size());
+  for (i = 0; i < edges.size(); i++)
     {
-      uint leaf_level = sched->cur_leaf_level;
-      if (sched->cur_node)
-	{
-	  Bse::Module *node = (Bse::Module*) sched->cur_node->data;
-	  sched->cur_node = sfi_ring_walk (sched->cur_node, sched->nodes[leaf_level]);
-	  return node;
-	}
-      schedule_advance (sched);
+      EngineTask *itask = &sched->tasks[edges[i].first];
+      if (!itask->outputs)
+        itask->outputs = sched->task_outputs + i;
+      itask->outputs[itask->n_outputs++] = edges[i].second;
+      sched->tasks[edges[i].second].n_inputs += 1;
     }
-  while (sched->cur_node);
-  /* nothing to hand out, either we're empty or still have cycles pending */
-  return NULL;
 }
 
-SfiRing*
-_engine_schedule_pop_cycle (EngineSchedule *sched)
+void
+_engine_schedule_secure (EngineSchedule *sched)
 {
-  assert_return (sched != NULL, NULL);
-  assert_return (sched->secured == TRUE, NULL);
-  assert_return (sched->cur_leaf_level <= sched->leaf_levels, NULL);
-  do
-    {
-      guint leaf_level = sched->cur_leaf_level;
-      if (sched->cur_cycle)
-	{
-	  SfiRing *cycle = (SfiRing*) sched->cur_cycle->data;
-	  sched->cur_cycle = sfi_ring_walk (sched->cur_cycle, sched->cycles[leaf_level]);
-	  return cycle;
-	}
-      schedule_advance (sched);
-    }
-  while (sched->cur_cycle);
-  /* nothing to hand out, either we're empty or still have nodes pending */
-  return NULL;
+  assert_return (sched != NULL);
+  assert_return (sched->secured == FALSE);
+  assert_return (sched->n_tasks == 0);
+  schedule_setup_tasks (sched);
+  sched->secured = TRUE;
+  if (CHECK_DEBUG())
+    _engine_schedule_debug_dump (sched);
 }
 
 void
@@ -344,12 +336,15 @@ _engine_schedule_unsecure (EngineSchedule *sched)
   assert_return (sched != NULL);
   assert_return (sched->secured == TRUE);
   assert_return (sched->in_pqueue == FALSE);
-  assert_return (sched->cur_leaf_level == sched->leaf_levels);
-  assert_return (sched->cur_node == NULL);
-  assert_return (sched->cur_cycle == NULL);
 
+  for (guint i = 0; i < sched->n_tasks; i++)
+    sched->tasks[i].node->sched_task = ~0;
+  delete[] sched->tasks;
+  sched->tasks = NULL;
+  g_free (sched->task_outputs);
+  sched->task_outputs = NULL;
+  sched->n_tasks = 0;
   sched->secured = FALSE;
-  sched->cur_leaf_level = ~0;
 }
 
 void
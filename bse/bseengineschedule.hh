@@ -14,6 +14,13 @@ struct EngineQuery {
   SfiRing *cycles;	/* of type Cycle* */
   SfiRing *cycle_nodes;	/* of type Bse::Module* */
 };
+struct EngineTask {
+  Bse::Module      *node;
+  guint             n_inputs;	/* number of input tasks */
+  std::atomic<uint> pending;	/* input tasks still unprocessed in the current block */
+  guint             n_outputs;
+  guint            *outputs;	/* indices of tasks depending on this one */
+};
 struct EngineSchedule {
   guint     n_items;
   guint     leaf_levels;
@@ -21,12 +28,11 @@ struct EngineSchedule {
   SfiRing **cycles;	/* SfiRing* */
   guint	    secured : 1;
   guint	    in_pqueue : 1;
-  guint	    cur_leaf_level;
-  SfiRing  *cur_node;
-  SfiRing  *cur_cycle;
   SfiRing  *vnodes;	/* virtual modules */
+  guint	    n_tasks;	/* popable nodes, setup by _engine_schedule_secure() */
+  EngineTask *tasks;	/* [n_tasks] */
+  guint    *task_outputs;	/* storage for tasks[].outputs */
 };
-#define	BSE_ENGINE_SCHEDULE_NONPOPABLE(schedule)        ((schedule)->cur_leaf_level >= (schedule)->leaf_levels)
 
 
 /* --- MasterThread --- */
@@ -36,8 +42,6 @@ void		_engine_schedule_destroy	(EngineSchedule	*schedule);
 void		_engine_schedule_consumer_node	(EngineSchedule	*schedule,
 						 Bse::Module	*node);
 void		_engine_schedule_secure		(EngineSchedule	*schedule);
-Bse::Module*	_engine_schedule_pop_node	(EngineSchedule	*schedule);
-SfiRing*	_engine_schedule_pop_cycle	(EngineSchedule	*schedule);
 void		_engine_schedule_restart	(EngineSchedule	*schedule);
 void		_engine_schedule_unsecure	(EngineSchedule	*schedule);
 
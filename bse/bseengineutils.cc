@@ -11,6 +11,9 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #define LOG_INTERN      SfiLogger ("internals", NULL, NULL)
 
@@ -353,11 +356,21 @@ bse_engine_has_garbage (void)
 
 
 /* --- node processing queue --- */
+/* Every DSP thread owns a work-stealing deque of ready tasks (see EngineTask). Processing
+ * a node decrements the pending input counters of its output tasks and pushes those that
+ * became ready onto the local deque, so other deques are only accessed when stealing and
+ * pqueue_mutex is only taken for trash job collection and the end of block handshake.
+ * Threads that find nothing to steal spin briefly and then park on the pqueue_ready futex,
+ * which is bumped whenever tasks become ready or the block is done.
+ */
 static std::mutex        pqueue_mutex;
-static EngineSchedule   *pqueue_schedule = NULL;
-static guint             pqueue_n_nodes = 0;
-static guint             pqueue_n_cycles = 0;
+static std::atomic<EngineSchedule*> pqueue_schedule { NULL };
+static std::atomic<guint> pqueue_n_pending { 0 };       /* tasks left to process in this block */
+static std::atomic<guint> pqueue_n_busy { 0 };          /* threads between _engine_process_enter() and _engine_process_leave() */
 static std::condition_variable pqueue_done_cond;
+static std::atomic<int>   pqueue_ready { 0 };           /* futex, changes when tasks became ready */
+static std::atomic<guint> pqueue_n_parked { 0 };        /* threads waiting on pqueue_ready */
+static Bse::WorkStealingDeque<guint> *pqueue_deques = NULL;
 static Bse::EngineTimedJob    *pqueue_trash_tjobs_head = NULL;
 static Bse::EngineTimedJob    *pqueue_trash_tjobs_tail = NULL;
 
@@ -382,43 +395,64 @@ engine_fetch_process_queue_trash_jobs_U (Bse::EngineTimedJob **trash_tjobs_head,
   else
     *trash_tjobs_head = *trash_tjobs_tail = NULL;
 }
+/// Number of threads processing nodes, the master thread plus all slave threads.
+guint
+_engine_n_workers (void)
+{
+  static const guint n_workers = std::max (1, Bse::this_thread_online_cpus());
+  return n_workers;
+}
 void
 _engine_set_schedule (EngineSchedule *sched)
 {
   assert_return (sched != NULL);
   assert_return (sched->secured == TRUE);
-  pqueue_mutex.lock();
   if (UNLIKELY (pqueue_schedule != NULL))
     {
-      pqueue_mutex.unlock();
       Bse::warning ("%s: schedule already set", __func__);
       return;
     }
-  pqueue_schedule = sched;
+  /* no worker accesses the deques while no schedule is set, so they can be seeded from here */
+  const guint n_workers = _engine_n_workers();
+  if (UNLIKELY (!pqueue_deques))
+    pqueue_deques = new Bse::WorkStealingDeque<guint>[n_workers];
+  for (guint i = 0; i < n_workers; i++)
+    pqueue_deques[i].reset (sched->n_tasks);      /* only allocates after reschedules */
+  /* distribute initially ready tasks, in reverse so owners pop expensive nodes first */
+  guint w = 0;
+  for (guint t = sched->n_tasks; t > 0; t--)
+    if (sched->tasks[t - 1].n_inputs == 0)
+      {
+        pqueue_deques[w].push (t - 1);
+        w = w + 1 < n_workers ? w + 1 : 0;
+      }
+  pqueue_n_pending = sched->n_tasks;
   sched->in_pqueue = TRUE;
-  pqueue_mutex.unlock();
+  pqueue_schedule = sched;
 }
 void
 _engine_unset_schedule (EngineSchedule *sched)
 {
   Bse::EngineTimedJob *trash_tjobs_head, *trash_tjobs_tail;
   assert_return (sched != NULL);
-  pqueue_mutex.lock();
   if (UNLIKELY (pqueue_schedule != sched))
     {
-      pqueue_mutex.unlock();
       Bse::warning ("%s: schedule(%p) not currently set", __func__, sched);
       return;
     }
-  if (UNLIKELY (pqueue_n_nodes || pqueue_n_cycles))
+  if (UNLIKELY (pqueue_n_pending))
     Bse::warning ("%s: schedule(%p) still busy", __func__, sched);
-  sched->in_pqueue = FALSE;
   pqueue_schedule = NULL;
+  std::unique_lock<std::mutex> pqueue_guard (pqueue_mutex);
+  /* wait for late threads to leave, before the deques may be reset */
+  while (pqueue_n_busy)
+    pqueue_done_cond.wait (pqueue_guard);
+  sched->in_pqueue = FALSE;
   /* see engine_fetch_process_queue_trash_jobs_U() on the limitations regarding pqueue trash jobs */
   trash_tjobs_head = pqueue_trash_tjobs_head;
   trash_tjobs_tail = pqueue_trash_tjobs_tail;
   pqueue_trash_tjobs_head = pqueue_trash_tjobs_tail = NULL;
-  pqueue_mutex.unlock();
+  pqueue_guard.unlock();
   if (trash_tjobs_head) /* move trash user jobs */
     {
       cqueue_trans_mutex.lock();
@@ -431,18 +465,67 @@ _engine_unset_schedule (EngineSchedule *sched)
       cqueue_trans_mutex.unlock();
     }
 }
+gboolean
+_engine_process_enter (void)
+{
+  pqueue_n_busy += 1;
+  if (pqueue_schedule != NULL)
+    return TRUE;
+  _engine_process_leave();
+  return FALSE;
+}
+void
+_engine_process_leave (void)
+{
+  if (pqueue_n_busy.fetch_sub (1) == 1)
+    {
+      std::lock_guard<std::mutex> pqueue_guard (pqueue_mutex);
+      pqueue_done_cond.notify_all();
+    }
+}
+static inline void
+pqueue_futex_wait (std::atomic<int> &word, int value)
+{
+  static_assert (sizeof (word) == sizeof (int), "");
+  syscall (SYS_futex, &word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+static inline void
+pqueue_notify_ready (void)
+{
+  pqueue_ready.fetch_add (1);
+  if (pqueue_n_parked.load() > 0)
+    syscall (SYS_futex, &pqueue_ready, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
 Bse::Module*
-_engine_pop_unprocessed_node (void)
+_engine_pop_unprocessed_node (guint worker)
 {
-  Bse::Module *node;
-  pqueue_mutex.lock();
-  node = pqueue_schedule ? _engine_schedule_pop_node (pqueue_schedule) : NULL;
-  if (node)
+  EngineSchedule *sched = pqueue_schedule.load (std::memory_order_relaxed);
+  guint task;
+  if (!pqueue_deques[worker].pop (&task))
     {
-      pqueue_n_nodes += 1;
-      node->lock();
+      const guint n_workers = _engine_n_workers();
+      for (guint spins = 0; ; spins++)
+        {
+          if (pqueue_n_pending.load() == 0)
+            return NULL;
+          const int ready = pqueue_ready.load();
+          bool stolen = false;
+          for (guint i = 1; i < n_workers && !stolen; i++)
+            stolen = pqueue_deques[(worker + i) % n_workers].steal (&task);
+          if (stolen)
+            break;
+          if (spins < 64)
+            continue;
+          /* inputs of all remaining tasks are still being processed, park until tasks become ready */
+          pqueue_n_parked += 1;
+          if (pqueue_n_pending.load() != 0)
+            pqueue_futex_wait (pqueue_ready, ready);    /* returns early if tasks became ready meanwhile */
+          pqueue_n_parked -= 1;
+          spins = 0;
+        }
     }
-  pqueue_mutex.unlock();
+  Bse::Module *node = sched->tasks[task].node;
+  node->lock();
   return node;
 }
 static inline void
@@ -469,41 +552,44 @@ _engine_node_collect_jobs (Bse::Module *node)
   pqueue_mutex.unlock();
 }
 void
-_engine_push_processed_node (Bse::Module *node)
+_engine_push_processed_node (guint        worker,
+                             Bse::Module *node)
 {
   assert_return (node != NULL);
-  assert_return (pqueue_n_nodes > 0);
   assert_return (BSE_MODULE_IS_SCHEDULED (node));
-  pqueue_mutex.lock();
-  assert_return (pqueue_n_nodes > 0);        /* paranoid */
-  collect_user_jobs_L (node);
-  pqueue_n_nodes -= 1;
+  EngineSchedule *sched = pqueue_schedule.load (std::memory_order_relaxed);
+  assert_return (node->sched_task < sched->n_tasks);
+  const EngineTask *task = &sched->tasks[node->sched_task];
+  if (UNLIKELY (node->tjob_head != NULL))
+    {
+      pqueue_mutex.lock();
+      collect_user_jobs_L (node);
+      pqueue_mutex.unlock();
+    }
   node->unlock();
-  if (!pqueue_n_nodes && !pqueue_n_cycles && BSE_ENGINE_SCHEDULE_NONPOPABLE (pqueue_schedule))
-    pqueue_done_cond.notify_one();
-  pqueue_mutex.unlock();
-}
-
-SfiRing*
-_engine_pop_unprocessed_cycle (void)
-{
-  return NULL;
-}
-
-void
-_engine_push_processed_cycle (SfiRing *cycle)
-{
-  assert_return (cycle != NULL);
-  assert_return (pqueue_n_cycles > 0);
-  Bse::Module *node = (Bse::Module*) cycle->data;
-  assert_return (BSE_MODULE_IS_SCHEDULED (node));
+  /* ready output tasks */
+  guint n_readied = 0;
+  for (guint i = 0; i < task->n_outputs; i++)
+    if (sched->tasks[task->outputs[i]].pending.fetch_sub (1) == 1)
+      {
+        pqueue_deques[worker].push (task->outputs[i]);
+        n_readied++;
+      }
+  if (pqueue_n_pending.fetch_sub (1) == 1)
+    {
+      pqueue_notify_ready();    /* release parked threads */
+      std::lock_guard<std::mutex> pqueue_guard (pqueue_mutex);
+      pqueue_done_cond.notify_all();
+    }
+  else if (n_readied > 1)        /* this thread pops one of them right away */
+    pqueue_notify_ready();
 }
 
 void
 _engine_wait_on_unprocessed (void)
 {
   std::unique_lock<std::mutex> pqueue_guard (pqueue_mutex);
-  while (pqueue_n_nodes || pqueue_n_cycles || !BSE_ENGINE_SCHEDULE_NONPOPABLE (pqueue_schedule))
+  while (pqueue_n_pending)
     pqueue_done_cond.wait (pqueue_guard);
 }
 
@@ -41,12 +41,14 @@ gboolean	_engine_job_pending	(void);
 
 
 /* --- node processing queue --- */
+guint	    _engine_n_workers			(void);
 void	    _engine_set_schedule		(EngineSchedule	*schedule);
 void	    _engine_unset_schedule		(EngineSchedule	*schedule);
-Bse::Module* _engine_pop_unprocessed_node	(void);
-void	    _engine_push_processed_node		(Bse::Module	*node);
-SfiRing*    _engine_pop_unprocessed_cycle	(void);
-void	    _engine_push_processed_cycle	(SfiRing	*cycle);
+gboolean    _engine_process_enter		(void);
+void	    _engine_process_leave		(void);
+Bse::Module* _engine_pop_unprocessed_node	(guint		 worker);
+void	    _engine_push_processed_node		(guint		 worker,
+						 Bse::Module	*node);
 void	    _engine_wait_on_unprocessed		(void);
 
 #endif /* __BSE_ENGINE_UTIL_H__ */
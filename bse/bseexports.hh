@@ -110,6 +110,8 @@ typedef struct {
 #define BSE_EXPORT_FLAG_SSE2     (0x1ull << 5)
 #define BSE_EXPORT_FLAG_SSE3     (0x1ull << 6)
 #define BSE_EXPORT_FLAG_SSE4     (0x1ull << 7)
+#define BSE_EXPORT_FLAG_AVX2     (0x1ull << 8)
+#define BSE_EXPORT_FLAG_AVX512F  (0x1ull << 9)
 
 #define BSE_EXPORT_CONFIG       (BSE_EXPORT_CONFIG__MMX | BSE_EXPORT_CONFIG__3DNOW | \
                                  BSE_EXPORT_CONFIG__SSE | BSE_EXPORT_CONFIG__SSE2 |  \
@@ -10,6 +10,7 @@
 #include "bse/internal.hh"
 #include <gobject/gvaluecollector.h>
 #include <string.h>
+#include <map>
 
 /* --- prototypes --- */
 static void             bse_item_class_init_base        (BseItemClass           *klass);
@@ -844,28 +845,185 @@ bse_item_undo_close (BseUndoStack *ustack)
     bse_undo_group_close (ustack);
 }
 
+/* Undo backups keep the stored item text as a delta against a keyframe, the
+ * last complete text stored for the same item. Edits usually touch a small
+ * portion of an item, so consecutive backups share most of their text.
+ * Property values are interned into a value table shared by all backups of
+ * an item, a backup only keeps the table indices of its values. The n-th value
+ * is compared with the n-th value of the previous backup, so unchanged values
+ * are stored once. Sample data is referenced through shared data handles and
+ * never copied. Keyframes and value tables are accounted as shared memory of
+ * the undo stack, for as long as any backup refers to them.
+ */
+typedef std::shared_ptr<const std::string> UndoKeyframeP;
+struct UndoValueTable {
+  BseUndoStack      *ustack = NULL;
+  SfiSeq            *values = sfi_seq_new();
+  std::vector<guint> last;              // indices of the most recent backup
+  size_t             n_bytes = 0;
+  /*dtor*/
+  ~UndoValueTable ()
+  {
+    bse_undo_stack_share_bytes (ustack, -gssize (n_bytes));
+    sfi_seq_unref (values);
+  }
+};
+typedef std::shared_ptr<UndoValueTable> UndoValueTableP;
+struct UndoItemHistory {
+  std::weak_ptr<const std::string> keyframe;
+  std::weak_ptr<UndoValueTable>    vtable;
+};
+typedef std::pair<BseUndoStack*, std::string> UndoItemKey;
+static std::map<UndoItemKey, UndoItemHistory> undo_histories;
+
+struct UndoBackup {
+  BseUndoStack      *ustack = NULL;
+  gchar             *upath = NULL;
+  UndoKeyframeP      keyframe;
+  size_t             prefix = 0, suffix = 0;    // bytes shared with keyframe
+  std::string        delta;
+  UndoValueTableP    vtable;
+  std::vector<guint> value_indices;
+  BseStorageSnapshot snapshot;
+  /*dtor*/
+  ~UndoBackup ()
+  {
+    if (keyframe && keyframe.use_count() == 1)  // last reference
+      bse_undo_stack_share_bytes (ustack, -gssize (keyframe->size()));
+    g_free (upath);
+  }
+  std::string
+  text () const
+  {
+    return keyframe->substr (0, prefix) + delta + keyframe->substr (keyframe->size() - suffix);
+  }
+  SfiSeq*
+  values () const
+  {
+    if (!vtable)
+      return NULL;
+    SfiSeq *seq = sfi_seq_new();
+    for (guint index : value_indices)
+      sfi_seq_append (seq, sfi_seq_get (vtable->values, index));
+    return seq;
+  }
+};
+
+static size_t
+undo_backup_encode_text (UndoBackup        *backup,
+                         UndoItemHistory   &history,
+                         const std::string &text)
+{
+  UndoKeyframeP keyframe = history.keyframe.lock();
+  if (keyframe)
+    {
+      const std::string &kf = *keyframe;
+      const size_t l = std::min (text.size(), kf.size());
+      size_t prefix = 0, suffix = 0;
+      while (prefix < l && text[prefix] == kf[prefix])
+        prefix++;
+      while (suffix < l - prefix && text[text.size() - 1 - suffix] == kf[kf.size() - 1 - suffix])
+        suffix++;
+      if (prefix + suffix >= text.size() / 2)
+        {
+          backup->keyframe = keyframe;
+          backup->prefix = prefix;
+          backup->suffix = suffix;
+          backup->delta = text.substr (prefix, text.size() - prefix - suffix);
+          return backup->delta.size();
+        }
+    }
+  keyframe = std::make_shared<const std::string> (text);
+  history.keyframe = keyframe;
+  bse_undo_stack_share_bytes (backup->ustack, keyframe->size());
+  backup->keyframe = keyframe;
+  backup->prefix = text.size();
+  backup->suffix = 0;
+  return 0;
+}
+
+static size_t
+undo_backup_intern_values (UndoBackup      *backup,
+                           UndoItemHistory &history)
+{
+  SfiSeq *values = backup->snapshot.values;
+  backup->snapshot.values = NULL;
+  return_unless (values != NULL, 0);
+  UndoValueTableP vtable = history.vtable.lock();
+  if (!vtable)
+    {
+      vtable = std::make_shared<UndoValueTable>();
+      vtable->ustack = backup->ustack;
+      history.vtable = vtable;
+    }
+  const guint n_values = sfi_seq_length (values);
+  backup->value_indices.resize (n_values);
+  size_t n_bytes = 0;
+  for (guint i = 0; i < n_values; i++)
+    {
+      const GValue *value = sfi_seq_get (values, i);
+      if (i < vtable->last.size() && sfi_value_equal_deep (value, sfi_seq_get (vtable->values, vtable->last[i])))
+        backup->value_indices[i] = vtable->last[i];
+      else
+        {
+          backup->value_indices[i] = sfi_seq_length (vtable->values);
+          sfi_seq_append (vtable->values, value);
+          n_bytes += sfi_value_bytes_deep (value);
+        }
+    }
+  sfi_seq_unref (values);
+  vtable->last = backup->value_indices;
+  vtable->n_bytes += n_bytes;
+  bse_undo_stack_share_bytes (backup->ustack, n_bytes);
+  backup->vtable = vtable;
+  return n_values * sizeof (backup->value_indices[0]);
+}
+
+/// Store @a text and the snapshot values of @a backup relative to previous backups, returns the bytes owned by @a backup.
+static size_t
+undo_backup_encode (UndoBackup        *backup,
+                    const std::string &text)
+{
+  const UndoItemKey key (backup->ustack, backup->upath);
+  if (undo_histories.find (key) == undo_histories.end())
+    {
+      // forget items whose backups are all gone
+      for (auto it = undo_histories.begin(); it != undo_histories.end();)
+        if (it->second.keyframe.expired() && it->second.vtable.expired())
+          it = undo_histories.erase (it);
+        else
+          ++it;
+    }
+  UndoItemHistory &history = undo_histories[key];
+  const size_t n_text_bytes = undo_backup_encode_text (backup, history, text);
+  return n_text_bytes + undo_backup_intern_values (backup, history);
+}
+
 static void
 undo_restore_item (BseUndoStep  *ustep,
                    BseUndoStack *ustack)
 {
-  BseItem *item = (BseItem*) bse_undo_pointer_unpack ((const char*) ustep->data[0].v_pointer, ustack);
-  BseStorage *storage = BSE_STORAGE (ustep->data[1].v_pointer);
+  UndoBackup *backup = (UndoBackup*) ustep->data[0].v_pointer;
+  BseItem *item = (BseItem*) bse_undo_pointer_unpack (backup->upath, ustack);
+  BseStorage *storage = (BseStorage*) bse_object_new (BSE_TYPE_STORAGE, NULL);
   GTokenType expected_token = G_TOKEN_NONE;
 
+  backup->snapshot.values = backup->values();
+  bse_storage_input_snapshot (storage, backup->text(), &backup->snapshot, "<undo-storage>");
   expected_token = bse_storage_restore_item (storage, item);
   if (expected_token != G_TOKEN_NONE)
     bse_storage_unexp_token (storage, expected_token);
 
   bse_storage_finish_parsing (storage);
+  bse_storage_reset (storage);
+  g_object_unref (storage);
 }
 
 static void
 unde_free_item (BseUndoStep *ustep)
 {
-  BseStorage *storage = BSE_STORAGE (ustep->data[1].v_pointer);
-  g_free (ustep->data[0].v_pointer);
-  bse_storage_reset (storage);
-  g_object_unref (storage);
+  UndoBackup *backup = (UndoBackup*) ustep->data[0].v_pointer;
+  delete backup;
 }
 
 void
@@ -875,10 +1033,15 @@ bse_item_push_undo_storage (BseItem         *self,
 {
   if (!BSE_ITEM_INTERNAL (self) && !BSE_UNDO_STACK_VOID (ustack))
     {
-      BseUndoStep *ustep = bse_undo_step_new (undo_restore_item, unde_free_item, 2);
-      bse_storage_turn_readable (storage, "<undo-storage>");
-      ustep->data[0].v_pointer = bse_undo_pointer_pack (self, ustack);
-      ustep->data[1].v_pointer = g_object_ref (storage);
+      BseUndoStep *ustep = bse_undo_step_new (undo_restore_item, unde_free_item, 1);
+      UndoBackup *backup = new UndoBackup();
+      backup->ustack = ustack;
+      backup->upath = bse_undo_pointer_pack (self, ustack);
+      const std::string text = bse_storage_take_snapshot (storage, &backup->snapshot);
+      const size_t n_delta_bytes = undo_backup_encode (backup, text);
+      ustep->data[0].v_pointer = backup;
+      ustep->n_bytes += sizeof (*backup) + strlen (backup->upath) + backup->snapshot.n_bytes() + n_delta_bytes;
+      Bse::debug ("undo", "undo backup: %zu byte delta of %zu bytes", n_delta_bytes, text.size());
       bse_undo_stack_push (ustack, ustep);
     }
   else
@@ -1309,3 +1472,86 @@ ItemImpl::apply_idl_property_need_undo (const StringVector &kvlist)
 }
 
 } // Bse
+
+// == Testing ==
+#include "testing.hh"
+
+namespace { // Anon
+using namespace Bse;
+
+BSE_INTEGRITY_TEST (bse_test_undo_backup_deltas);
+static void
+bse_test_undo_backup_deltas()
+{
+  BseUndoStack *ustack = g_new0 (BseUndoStack, 1);
+  std::string t1, t2, t3;
+  for (uint i = 0; i < 100; i++)
+    {
+      t1 += string_format ("(modify-param \"p%u\" %u)\n", i, i);
+      t2 += string_format ("(modify-param \"p%u\" %u)\n", i, i == 50 ? 7 : i);
+      t3 += string_format ("(insert-part \"%u\" 0x%x)\n", i * 3, i * 17);
+    }
+  UndoBackup *b1 = new UndoBackup(), *b2 = new UndoBackup(), *b3 = new UndoBackup(), *b4 = new UndoBackup();
+  b1->ustack = b2->ustack = b3->ustack = b4->ustack = ustack;
+  b1->upath = g_strdup ("item:1");
+  b2->upath = g_strdup ("item:1");
+  b3->upath = g_strdup ("item:2");
+  b4->upath = g_strdup ("item:1");
+  // the first backup of an item creates a keyframe
+  TCMP (undo_backup_encode (b1, t1), ==, size_t (0));
+  TCMP (bse_undo_stack_bytes (ustack), ==, t1.size());
+  TASSERT (b1->text() == t1);
+  // similar backups of the same item are stored as deltas
+  const size_t n_delta = undo_backup_encode (b2, t2);
+  TASSERT (n_delta > 0 && n_delta < 8);
+  TASSERT (b2->keyframe == b1->keyframe);
+  TASSERT (b2->text() == t2);
+  TCMP (bse_undo_stack_bytes (ustack), ==, t1.size());
+  // other items and dissimilar texts start new keyframes
+  TCMP (undo_backup_encode (b3, t1), ==, size_t (0));
+  TASSERT (b3->keyframe != b1->keyframe);
+  TCMP (undo_backup_encode (b4, t3), ==, size_t (0));
+  TASSERT (b4->text() == t3);
+  TCMP (bse_undo_stack_bytes (ustack), ==, 2 * t1.size() + t3.size());
+  // keyframes stay accounted while deltas refer to them
+  delete b1;
+  TCMP (bse_undo_stack_bytes (ustack), ==, 2 * t1.size() + t3.size());
+  TASSERT (b2->text() == t2);
+  delete b2;
+  TCMP (bse_undo_stack_bytes (ustack), ==, t1.size() + t3.size());
+  delete b3;
+  delete b4;
+  TCMP (bse_undo_stack_bytes (ustack), ==, size_t (0));
+  // values are shared across backups of the same item
+  UndoBackup *v1 = new UndoBackup(), *v2 = new UndoBackup();
+  v1->ustack = v2->ustack = ustack;
+  v1->upath = g_strdup ("item:3");
+  v2->upath = g_strdup ("item:3");
+  v1->snapshot.values = sfi_seq_new();
+  sfi_seq_append_real (v1->snapshot.values, 0.5);
+  sfi_seq_append_string (v1->snapshot.values, "unchanged");
+  sfi_seq_append_int (v1->snapshot.values, 1);
+  v2->snapshot.values = sfi_seq_copy_deep (v1->snapshot.values);
+  sfi_value_set_int (sfi_seq_get (v2->snapshot.values, 2), 2);
+  undo_backup_encode (v1, t1);
+  undo_backup_encode (v2, t1);
+  TASSERT (v1->vtable == v2->vtable);
+  TCMP (sfi_seq_length (v1->vtable->values), ==, 4u);
+  TCMP (v1->vtable->n_bytes, ==, 4 * sizeof (GValue) + strlen ("unchanged") + 1);
+  TCMP (bse_undo_stack_bytes (ustack), ==, t1.size() + v1->vtable->n_bytes);
+  SfiSeq *values = v2->values();
+  TCMP (sfi_seq_length (values), ==, 3u);
+  TCMP (sfi_seq_get_real (values, 0), ==, 0.5);
+  TCMP (String (sfi_seq_get_string (values, 1)), ==, "unchanged");
+  TCMP (sfi_seq_get_int (values, 2), ==, 2);
+  sfi_seq_unref (values);
+  values = v1->values();
+  TCMP (sfi_seq_get_int (values, 2), ==, 1);
+  sfi_seq_unref (values);
+  delete v1;
+  delete v2;
+  TCMP (bse_undo_stack_bytes (ustack), ==, size_t (0));
+  g_free (ustack);
+}
+
+} // Anon
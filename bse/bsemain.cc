@@ -471,6 +471,7 @@ GlobalPreferences::defaults ()
   prefs.synth_control_freq = 1500;
   prefs.midi_driver = config_string ("midi-driver", "auto");
   prefs.invert_sustain = false;
+  prefs.undo_memory = 256;
   prefs.license_default = "Creative Commons Attribution-ShareAlike 4.0 (https://creativecommons.org/licenses/by-sa/4.0/)";
   // dynamic defaults
   const String default_user_path = Path::join (Path::user_home(), "Beast");
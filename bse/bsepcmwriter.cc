@@ -8,6 +8,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <thread>
 
 // == prototypes ==
 static void	   bse_pcm_writer_init			(BsePcmWriter      *pdev);
@@ -15,7 +16,6 @@ static void	   bse_pcm_writer_class_init		(BsePcmWriterClass *klass);
 static void	   bse_pcm_writer_finalize		(GObject           *object);
 
 // == variables ==
-static std::atomic<uint64> atomic_trigger_tick {-uint64 (1)};
 static gpointer parent_class = NULL;
 
 // == functions ==
@@ -50,6 +50,12 @@ static void
 bse_pcm_writer_init (BsePcmWriter *self)
 {
   new (&self->mutex) std::mutex();
+  new (&self->n_overruns) std::atomic<uint64> (0);
+  new (&self->running) std::atomic<bool> (false);
+  new (&self->trigger_tick) std::atomic<uint64> (-uint64 (1));
+  self->fd = -1;
+  self->ring = NULL;
+  self->thread = NULL;
 }
 
 static void
@@ -63,14 +69,105 @@ bse_pcm_writer_finalize (GObject *object)
     }
   /* chain parent class' handler */
   G_OBJECT_CLASS (parent_class)->finalize (object);
+  self->running.~atomic();
+  self->trigger_tick.~atomic();
+  self->n_overruns.~atomic();
   self->mutex.~mutex();
 }
 
+// == disk thread ==
+#define RING_SECONDS            (2)                     /* ring capacity in seconds of audio */
+#define WRITE_CHUNK_VALUES      (64 * 1024)             /* maximum number of values per write() */
+#define DRAIN_INTERVAL_MS       (10)
+
+static gboolean
+bsethread_halt_recording (gpointer data)
+{
+  bse_server_stop_recording (bse_server_get());
+  return false;
+}
+
+static GslWaveFormatType
+pcm_writer_format (uint n_bits)
+{
+  switch (n_bits)
+    {
+    case 32:    return GSL_WAVE_FORMAT_FLOAT;
+    case 24:    return GSL_WAVE_FORMAT_SIGNED_24;
+    default:    return GSL_WAVE_FORMAT_SIGNED_16;
+    }
+}
+
+static void
+pcm_writer_store (BsePcmWriter *self, float *values, size_t n_values, uint8 *bytes)
+{
+  const uint bw = self->n_bits / 8;
+  if (self->broken || self->halted)
+    return;
+  const GslWaveFormatType format = pcm_writer_format (self->n_bits);
+  size_t n_bytes;
+  const uint8 *data;
+  if (format == GSL_WAVE_FORMAT_FLOAT && G_BYTE_ORDER == G_LITTLE_ENDIAN)
+    {
+      n_bytes = n_values * bw;  /* WAV float data is little endian, like our own */
+      data = (const uint8*) values;
+    }
+  else
+    {
+      n_bytes = gsl_conv_from_float_clip (format, G_LITTLE_ENDIAN, values, bytes, n_values);
+      data = bytes;
+    }
+  if (self->recorded_maximum)
+    n_bytes = bw * MIN (n_bytes / bw, self->recorded_maximum - self->n_bytes / bw);
+  while (n_bytes)
+    {
+      ssize_t j;
+      do
+        j = write (self->fd, data, n_bytes);
+      while (j < 0 && errno == EINTR);
+      if (j <= 0)
+        {
+          Bse::info ("failed to write %zu bytes to WAV file: %s", n_bytes, g_strerror (j < 0 ? errno : EIO));
+          self->broken = true;
+          return;
+        }
+      self->n_bytes += j;
+      data += j;
+      n_bytes -= j;
+    }
+  if (self->recorded_maximum && self->n_bytes >= bw * self->recorded_maximum)
+    {
+      self->halted = true;
+      bse_idle_next (bsethread_halt_recording, NULL);
+    }
+}
+
+static void
+pcm_writer_thread (BsePcmWriter *self)
+{
+  Bse::this_thread_set_name ("PcmWriter");
+  std::unique_ptr<float[]> fbuffer (new float[WRITE_CHUNK_VALUES]);
+  std::unique_ptr<uint8[]> bbuffer (new uint8[WRITE_CHUNK_VALUES * 4]);
+  bool running;
+  do
+    {
+      running = self->running.load(); // check before draining, so the last drain sees all values
+      size_t n;
+      while ((n = self->ring->pop (fbuffer.get(), WRITE_CHUNK_VALUES)) > 0)
+        pcm_writer_store (self, fbuffer.get(), n, bbuffer.get());
+      if (running)
+        std::this_thread::sleep_for (std::chrono::milliseconds (DRAIN_INTERVAL_MS));
+    }
+  while (running);
+}
+
+// == PCM writer API ==
 Bse::Error
 bse_pcm_writer_open (BsePcmWriter *self,
 		     const gchar  *file,
 		     guint         n_channels,
 		     guint         sample_freq,
+                     guint         n_bits,
                      uint64        recorded_maximum)
 {
   gint fd;
@@ -79,10 +176,14 @@ bse_pcm_writer_open (BsePcmWriter *self,
   assert_return (file != NULL, Bse::Error::INTERNAL);
   assert_return (n_channels > 0, Bse::Error::INTERNAL);
   assert_return (sample_freq >= 1000, Bse::Error::INTERNAL);
+  assert_return (n_bits == 16 || n_bits == 24 || n_bits == 32, Bse::Error::INTERNAL);
   self->mutex.lock();
+  self->n_bits = n_bits;
   self->n_bytes = 0;
+  self->n_queued = 0;
+  self->n_overruns = 0;
   self->recorded_maximum = recorded_maximum;
-  self->start_tick = atomic_trigger_tick;
+  self->start_tick = self->trigger_tick;
   fd = open (file, O_WRONLY | O_CREAT | O_TRUNC, 0666);
   if (fd < 0)
     {
@@ -90,7 +191,7 @@ bse_pcm_writer_open (BsePcmWriter *self,
       return bse_error_from_errno (errno, Bse::Error::FILE_OPEN_FAILED);
     }
 
-  errno = bse_wave_file_dump_header (fd, 0x7fff0000, 16, n_channels, sample_freq);
+  errno = bse_wave_file_dump_header (fd, 0x7fff0000, n_bits, n_channels, sample_freq);
   if (errno)
     {
       close (fd);
@@ -99,16 +200,30 @@ bse_pcm_writer_open (BsePcmWriter *self,
     }
   self->fd = fd;
   self->open = TRUE;
-  self->broken = FALSE;
+  self->broken = false;
+  self->halted = false;
+  self->freewheel = false;
+  self->ring = new Bse::SpscRing<float> (RING_SECONDS * n_channels * sample_freq);
+  self->running = true;
+  self->thread = new std::thread (pcm_writer_thread, self);
   self->mutex.unlock();
   return Bse::Error::NONE;
 }
+
 void
 bse_pcm_writer_close (BsePcmWriter *self)
 {
   assert_return (BSE_IS_PCM_WRITER (self));
   assert_return (self->open);
   self->mutex.lock();
+  self->running = false;
+  self->thread->join();         // drains the ring
+  delete self->thread;
+  self->thread = NULL;
+  delete self->ring;
+  self->ring = NULL;
+  if (self->n_overruns)
+    Bse::info ("%s: disk writer overruns, %u values were dropped", G_STRLOC, uint (self->n_overruns));
   bse_wave_file_patch_length (self->fd, self->n_bytes);
   close (self->fd);
   self->fd = -1;
@@ -117,11 +232,20 @@ bse_pcm_writer_close (BsePcmWriter *self)
   errno = 0;
 }
 
-static gboolean
-bsethread_halt_recording (gpointer data)
+/// Number of values dropped by bse_pcm_writer_write() because the disk thread fell behind.
+uint64
+bse_pcm_writer_overruns (BsePcmWriter *self)
 {
-  bse_server_stop_recording (bse_server_get());
-  return false;
+  assert_return (BSE_IS_PCM_WRITER (self), 0);
+  return self->n_overruns;
+}
+
+/// Start recording at @a start_tick, values for earlier stamps are discarded.
+void
+bse_pcm_writer_trigger (BsePcmWriter *self, uint64 start_tick)
+{
+  assert_return (BSE_IS_PCM_WRITER (self));
+  self->trigger_tick = start_tick;
 }
 
 void
@@ -133,9 +257,7 @@ bse_pcm_writer_write (BsePcmWriter *self, size_t n_values, const float *values,
   assert_return (values != NULL);
   if (UNLIKELY (start_stamp + n_values <= self->start_tick))
     {
-      self->mutex.lock();
-      self->start_tick = atomic_trigger_tick;
-      self->mutex.unlock();
+      self->start_tick = self->trigger_tick;
       if (start_stamp + n_values <= self->start_tick)
         return; // writer not yet activated
     }
@@ -146,36 +268,22 @@ bse_pcm_writer_write (BsePcmWriter *self, size_t n_values, const float *values,
       values += delta;
       start_stamp += delta;
     }
-  self->mutex.lock();
-  const uint bw = 2; /* 16bit */
-  if (!self->broken && (!self->recorded_maximum || self->n_bytes < bw * self->recorded_maximum))
+  if (self->recorded_maximum)
     {
-      guint j;
-      guint8 *dest = g_new (guint8, n_values * bw);
-      uint n_bytes = gsl_conv_from_float_clip (GSL_WAVE_FORMAT_SIGNED_16,
-                                               G_BYTE_ORDER,
-                                               values,
-                                               dest,
-                                               n_values);
-      if (self->recorded_maximum)
-        n_bytes = bw * MIN (n_bytes / bw, self->recorded_maximum - self->n_bytes / bw);
-      do
-	j = write (self->fd, dest, n_bytes);
-      while (j < 0 && errno == EINTR);
-      if (j > 0)
-        {
-          self->n_bytes += j;
-          if (self->recorded_maximum && self->n_bytes >= bw * self->recorded_maximum)
-            bse_idle_next (bsethread_halt_recording, NULL);
-        }
-      g_free (dest);
-      if (j < 0 && errno)
-	{
- 	  Bse::info ("failed to write %u bytes to WAV file: %s", n_bytes, g_strerror (errno));
-	  self->broken = TRUE;
-	}
+      return_unless (self->n_queued < self->recorded_maximum);
+      n_values = MIN (n_values, self->recorded_maximum - self->n_queued);
     }
-  self->mutex.unlock();
+  // never block, allocate or syscall here, the disk thread picks up queued values
+  bool queued = self->ring->push (values, n_values);
+  while (!queued && self->freewheel)    // offline rendering is paced by the disk instead
+    {
+      std::this_thread::sleep_for (std::chrono::milliseconds (1));
+      queued = self->ring->push (values, n_values);
+    }
+  if (queued)
+    self->n_queued += n_values;
+  else
+    self->n_overruns += n_values;
 }
 
 namespace Bse {
@@ -190,13 +298,7 @@ PcmWriterImpl::~PcmWriterImpl ()
 void
 PcmWriterImpl::trigger_tick (uint64 start_tick)
 {
-  /* FIXME: workaround for the lack of per-project engine instantiations.
-   * There really should be a single engine instance per-project, and a
-   * single pcm-writer instance per engine (if any). Then trigger_tick()
-   * becomes a method on the per-project pcm-writer instead of a static
-   * function that only works for WAV capturing of a single instance.
-   */
-  atomic_trigger_tick = start_tick;
+  bse_pcm_writer_trigger (as<BsePcmWriter*>(), start_tick);
 }
 
 } // Bse
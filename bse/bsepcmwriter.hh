@@ -17,21 +17,32 @@
 struct BsePcmWriter : BseItem {
   std::mutex	mutex;
   guint		open : 1;
-  guint		broken : 1;
+  bool		broken;                 /* written by disk thread */
+  bool		halted;                 /* written by disk thread */
+  bool		freewheel;              /* wait for the disk instead of dropping values */
   gint		fd;
-  Bse::uint64	n_bytes;
+  guint		n_bits;
+  Bse::uint64	n_bytes;                /* written by disk thread */
+  Bse::uint64	n_queued;               /* written by engine thread */
   Bse::uint64   recorded_maximum;
   Bse::uint64   start_tick;
+  std::atomic<Bse::uint64> trigger_tick;/* stamp at which recording starts */
+  std::atomic<Bse::uint64> n_overruns;  /* values dropped due to a full ring */
+  std::atomic<bool>        running;
+  Bse::SpscRing<float>    *ring;
+  std::thread             *thread;
 };
 struct BsePcmWriterClass : BseItemClass
 {};
 
-Bse::Error bse_pcm_writer_open	(BsePcmWriter *pdev, const gchar *file, guint n_channels,
-                                 guint sample_freq, Bse::uint64 recorded_maximum);
-void	   bse_pcm_writer_close	(BsePcmWriter *pdev);
-/* writing is lock protected */
-void	   bse_pcm_writer_write	(BsePcmWriter *pdev, size_t n_values,
-                                 const float *values, Bse::uint64 start_stamp);
+Bse::Error  bse_pcm_writer_open     (BsePcmWriter *pdev, const gchar *file, guint n_channels, guint sample_freq,
+                                     guint n_bits, Bse::uint64 recorded_maximum);
+void	    bse_pcm_writer_close    (BsePcmWriter *pdev);
+/* writing is lock-free, values are handed to a disk thread */
+void	    bse_pcm_writer_write    (BsePcmWriter *pdev, size_t n_values,
+                                     const float *values, Bse::uint64 start_stamp);
+Bse::uint64 bse_pcm_writer_overruns (BsePcmWriter *pdev);
+void        bse_pcm_writer_trigger  (BsePcmWriter *pdev, Bse::uint64 start_tick);
 
 namespace Bse {
 
@@ -40,7 +51,7 @@ protected:
   virtual    ~PcmWriterImpl ();
 public:
   explicit    PcmWriterImpl (BseObject*);
-  static void trigger_tick  (uint64 start_tick);
+  void        trigger_tick  (uint64 start_tick);
 };
 
 } // Bse
@@ -180,6 +180,10 @@ runtime_export_config (void)
         emask |= BSE_EXPORT_FLAG_SSE3;
       if (cinfo.find (" SSE4.2 ") != cinfo.npos)
         emask |= BSE_EXPORT_FLAG_SSE4;
+      if (cinfo.find (" AVX2 ") != cinfo.npos && cinfo.find (" FMA ") != cinfo.npos)
+        emask |= BSE_EXPORT_FLAG_AVX2;
+      if (cinfo.find (" AVX512F ") != cinfo.npos)
+        emask |= BSE_EXPORT_FLAG_AVX512F;
     }
   return emask;
 }
@@ -16,7 +16,6 @@
 #include "bsemidireceiver.hh"
 #include "gslcommon.hh"
 #include "bseengine.hh"
-#include "bsepcmwriter.hh"
 #include "bsemidifile.hh"
 #include "bsesoundfontrepo.hh"
 #include "path.hh"
@@ -798,7 +797,7 @@ bse_project_start_playback (BseProject *self)
 	songs = sfi_ring_append (songs, super);
     }
   if (!songs) // start pcm-writer ASAP if no songs are present
-    Bse::PcmWriterImpl::trigger_tick (Bse::TickStamp::current());
+    bse_server_trigger_recording (bse_server_get(), Bse::TickStamp::current());
   /* enfore MasterThread roundtrip */
   bse_trans_add (trans, bse_job_nop());
   bse_trans_commit (trans);
@@ -808,7 +807,7 @@ bse_project_start_playback (BseProject *self)
   if (seen_synth || songs)
     bse_project_state_changed (self, Bse::ProjectState::PLAYING);
   /* then, start the sequencer */
-  while (songs) // start_song will synchronize PcmWriterImpl::trigger_tick
+  while (songs) // start_song will synchronize bse_server_trigger_recording()
     Bse::Sequencer::instance().start_song ((BseSong*) sfi_ring_pop_head (&songs), 0);
 }
 
@@ -1242,9 +1241,14 @@ ProjectImpl::restore_from_file (const String &file_name)
             project_xml = zip_storage.fetch_file ("project.xml");
           if (zip_storage.has_file ("bse_storage.scm"))
             {
-              // move "bse_storage.scm" out of the way for future imports into this zip_storage
-              const String bsestorage_scm = zip_storage.move_to_temporary ("bse_storage.scm");
-              scm_filename = !bsestorage_scm.empty() ? zip_storage.fetch_file (bsestorage_scm) : "" /*error*/;
+              // read in place if possible, so sample data is only loaded when used
+              scm_filename = zip_storage.fetch_window ("bse_storage.scm");
+              if (scm_filename.empty())
+                {
+                  // move "bse_storage.scm" out of the way for future imports into this zip_storage
+                  const String bsestorage_scm = zip_storage.move_to_temporary ("bse_storage.scm");
+                  scm_filename = !bsestorage_scm.empty() ? zip_storage.fetch_file (bsestorage_scm) : "" /*error*/;
+                }
             }
           if (project_xml.empty() && scm_filename.empty())
             return Bse::Error::IO; // import failed
@@ -8,7 +8,7 @@
 #include "bseproject.hh"
 #include "bsemidireceiver.hh"
 #include "bsemain.hh"
-#include "bsepcmwriter.hh"
+#include "bseserver.hh"
 #include "bseieee754.hh"
 #include "bsestartup.hh"        // for TaskRegistry
 #include "bse/internal.hh"
@@ -243,7 +243,7 @@ Sequencer::start_song (BseSong *song, uint64 start_stamp)
   start_stamp = MAX (start_stamp, 1);
 
   // synchornize pcm-writer output with song start
-  PcmWriterImpl::trigger_tick (start_stamp);
+  bse_server_trigger_recording (bse_server_get(), start_stamp);
 
   g_object_ref (song);
   BSE_SEQUENCER_LOCK();
@@ -329,6 +329,20 @@ Sequencer::thread_lagging (uint n_blocks)
 
 static std::atomic<bool> sequencer_thread_running { false };
 
+/// Block until the sequencer has processed all events up to its future horizon for the current stamp.
+void
+Sequencer::wait_ahead ()
+{
+  // used by freewheeling drivers to run the sequencer in lock step with the engine
+  const uint64 next_stamp = Bse::TickStamp::current() + BSE_SEQUENCER_FUTURE_BLOCKS * bse_engine_block_size();
+  std::unique_lock<std::mutex> locker (sequencer_mutex_);
+  while (stamp_ < next_stamp && sequencer_thread_running)
+    {
+      wakeup();
+      stamp_cond_.wait (locker);
+    }
+}
+
 void
 Sequencer::sequencer_thread ()
 {
@@ -386,9 +400,11 @@ Sequencer::sequencer_thread ()
 	    }
 	}
       stamp_ = next_stamp;
+      stamp_cond_.notify_all();                 // wake up threads in wait_ahead()
       wakeup->awake_after (cur_stamp + bse_engine_block_size ());
     }
   while (pool_poll_Lm (-1) && sequencer_thread_running);
+  stamp_cond_.notify_all();
   BSE_SEQUENCER_UNLOCK();
   SDEBUG ("thrdstop: now=%llu", Bse::TickStamp::current());
   Bse::TaskRegistry::remove (Bse::this_thread_gettid());
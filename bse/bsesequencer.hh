@@ -15,6 +15,7 @@ class Sequencer {
   uint64     stamp_;            // sequencer time (ahead of real time)
   SfiRing   *songs_;
   std::condition_variable watch_cond_;
+  std::condition_variable stamp_cond_;
   PollPool  *poll_pool_;
   EventFd    event_fd_;
   std::thread thread_;
@@ -39,6 +40,7 @@ public:
   void          start_song	(BseSong *song, uint64 start_stamp);
   void          remove_song	(BseSong *song);
   bool          thread_lagging  (uint n_blocks);
+  void          wait_ahead      ();
   void          wakeup          ()      { event_fd_.wakeup(); }
   static std::mutex& sequencer_mutex () { return sequencer_mutex_; }
   static Sequencer&  instance        () { return *singleton_; }
@@ -5,6 +5,7 @@
 #include "gslcommon.hh"
 #include "bsemain.hh"		/* threads enter/leave */
 #include "bsepcmwriter.hh"
+#include "bseundostack.hh"
 #include "bsecxxplugin.hh"
 #include "gsldatahandle-mad.hh"
 #include "gslvorbis-enc.hh"
@@ -12,6 +13,7 @@
 #include "devicecrawler.hh"
 #include "storage.hh"
 #include "path.hh"
+#include "profiler.hh"
 #include "internal.hh"
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -107,6 +109,8 @@ bse_server_init (BseServer *self)
   self->set_flag (BSE_ITEM_FLAG_SINGLETON);
 
   self->dev_use_count = 0;
+  self->wave_bits = 16;
+  self->wave_trigger_tick = -Bse::uint64 (1);
   self->pcm_writer = NULL;
 
   /* keep the server singleton alive */
@@ -260,9 +264,11 @@ bse_server_stop_recording (BseServer *self)
 void
 bse_server_start_recording (BseServer      *self,
                             const char     *wave_file,
-                            double          n_seconds)
+                            double          n_seconds,
+                            guint           n_bits)
 {
   self->wave_seconds = MAX (n_seconds, 0);
+  self->wave_bits = n_bits == 24 || n_bits == 32 ? n_bits : 16;
   self->wave_file = g_strdup_stripped (wave_file ? wave_file : "");
   if (!self->wave_file[0])
     {
@@ -273,6 +279,15 @@ bse_server_start_recording (BseServer      *self,
   impl->notify ("wave_file");
 }
 
+/// Synchronize the start of WAV recording with the playback start of a project.
+void
+bse_server_trigger_recording (BseServer *self, Bse::uint64 start_tick)
+{
+  self->wave_trigger_tick = start_tick;
+  if (self->pcm_writer)
+    bse_pcm_writer_trigger (self->pcm_writer, start_tick);
+}
+
 Bse::Error
 bse_server_open_devices (BseServer *self)
 {
@@ -308,9 +323,10 @@ bse_server_open_devices (BseServer *self)
 	{
 	  Bse::Error error;
 	  self->pcm_writer = (BsePcmWriter*) bse_object_new (BSE_TYPE_PCM_WRITER, NULL);
+          bse_pcm_writer_trigger (self->pcm_writer, self->wave_trigger_tick);
           const uint n_channels = 2;
 	  error = bse_pcm_writer_open (self->pcm_writer, self->wave_file,
-                                       n_channels, bse_engine_sample_freq (),
+                                       n_channels, bse_engine_sample_freq (), self->wave_bits,
                                        n_channels * bse_engine_sample_freq() * self->wave_seconds);
 	  if (error != 0)
 	    {
@@ -326,6 +342,8 @@ bse_server_open_devices (BseServer *self)
 	      g_object_unref (self->pcm_writer);
 	      self->pcm_writer = NULL;
 	    }
+          else
+            self->pcm_writer->freewheel = impl->pcm_driver()->freewheeling();
 	}
       bse_trans_add (trans, bse_pcm_omodule_change_driver (self->pcm_omodule, impl->pcm_driver().get(), self->pcm_writer));
       bse_trans_commit (trans);
@@ -647,6 +665,14 @@ ServerImpl::ServerImpl (BseObject *bobj) :
   engine_ = new AudioSignal::Engine { bse_engine_sample_freq(), *audio_timing };
   BseServer *self = const_cast<ServerImpl*> (this)->as<BseServer*>();
   bse_pcm_module_set_processor_engine (self->pcm_omodule, engine_);
+  profiler_block_ = allocate_shared_block (ptrdiff_t (ProfilerField::END_BYTE));
+  Profiler::set_telemetry ((char*) profiler_block_.mem_start);
+  // fold per-thread timing samples into histograms before render thread buffers fill up
+  std::function<bool()> profiler_collect = [] () {
+    Profiler::collect();
+    return true;                                // keep interval timer alive
+  };
+  profiler_timer_ = exec_timeout (profiler_collect, 250);
 }
 
 ServerImpl::~ServerImpl ()
@@ -657,6 +683,9 @@ ServerImpl::~ServerImpl ()
   if (self->pcm_omodule)
     bse_pcm_module_set_processor_engine (self->pcm_omodule, nullptr);
   delete engine_;
+  exec_handler_clear (profiler_timer_);
+  Profiler::set_telemetry (nullptr);
+  release_shared_block (profiler_block_);
 }
 
 AudioSignal::Engine&
@@ -869,10 +898,10 @@ ServerImpl::load_ladspa ()
 }
 
 void
-ServerImpl::start_recording (const String &wave_file, double n_seconds)
+ServerImpl::start_recording (const String &wave_file, double n_seconds, int n_bits)
 {
   BseServer *server = as<BseServer*>();
-  bse_server_start_recording (server, wave_file.c_str(), n_seconds);
+  bse_server_start_recording (server, wave_file.c_str(), n_seconds, n_bits);
 }
 
 bool
@@ -1010,6 +1039,13 @@ void
 ServerImpl::set_prefs (const Preferences &preferences)
 {
   global_prefs->assign (preferences);
+  const gsize undo_bytes = gsize (global_prefs->undo_memory) * 1024 * 1024;
+  for (auto project : ProjectImpl::project_list())
+    {
+      BseProject *bproject = project->as<BseProject*>();
+      bse_undo_stack_limit_bytes (bproject->undo_stack, undo_bytes);
+      bse_undo_stack_limit_bytes (bproject->redo_stack, undo_bytes);
+    }
 }
 
 bool
@@ -1084,6 +1120,7 @@ struct FragmentBroadcaster {
   ShmFragmentSeq plan;
   SharedMemory   smem;
   uint           timerid = 0;
+  std::string    binary;        // reused across timer calls to avoid per message allocations
 };
 static std::vector<FragmentBroadcaster> fbroadcasters;
 
@@ -1099,7 +1136,7 @@ broadcast_timer (ptrdiff_t conid)
   FragmentBroadcaster &broad = fbroadcasters[i];
   const SharedMemory &smem = broad.smem;
   const char *shm_start = (char*) smem.shm_start;
-  std::string binary;
+  std::string &binary = broad.binary;
   binary.resize (broad.binary_size);
   char *data = &binary[0];
   for (const auto &frag : broad.plan)           // offsets and lengths were validated earlier
@@ -1113,6 +1150,7 @@ broadcast_timer (ptrdiff_t conid)
       broad.binary_sender = nullptr;
       broad.plan.clear();
       broad.smem = SharedMemory();
+      broad.binary = std::string();
     }
 }
 
@@ -1182,6 +1220,43 @@ ServerImpl::broadcast_shm_fragments (const ShmFragmentSeq &plan, int interval_ms
   broad.timerid = exec_timeout (broadcast_timer_func, std::max (interval_ms, 16));
 }
 
+int64
+ServerImpl::get_profiler_shm_offset (ProfilerField fld)
+{
+  return profiler_block_.mem_offset + ptrdiff_t (fld);
+}
+
+ProfileReport
+ServerImpl::profile_report ()
+{
+  ProfileReport report;
+  for (const Profiler::Entry &e : Profiler::entries())
+    {
+      ProfileEntry entry;
+      entry.name = e.name;
+      entry.count = e.count;
+      entry.p50_usecs = e.p50_usecs;
+      entry.p99_usecs = e.p99_usecs;
+      entry.max_usecs = e.max_usecs;
+      entry.total_usecs = e.total_usecs;
+      report.entries.push_back (entry);
+    }
+  const Profiler::Stats stats = Profiler::stats();
+  report.blocks = stats.blocks;
+  report.xruns = stats.xruns;
+  report.dropped = stats.dropped;
+  report.dsp_load = stats.dsp_load;
+  report.dsp_load_avg = stats.dsp_load_avg;
+  report.dsp_load_max = stats.dsp_load_max;
+  return report;
+}
+
+void
+ServerImpl::profile_reset ()
+{
+  Profiler::reset();
+}
+
 static constexpr ssize_t SHARED_MEMORY_AREA_SIZE = 8 * 1024 * 1024;
 static size_t current_shared_memory_area_size = SHARED_MEMORY_AREA_SIZE;
 
@@ -1358,7 +1433,8 @@ ServerImpl::open_pcm_driver (uint mix_freq, uint latency, uint *block_size)
   config.mix_freq = mix_freq;
   config.latency_ms = latency;
   config.block_length = *block_size;
-  pcm_driver_ = PcmDriver::open (get_prefs().pcm_driver, Driver::READWRITE, Driver::WRITEONLY, config, &error);
+  const String devid = freewheel_ ? "null=freewheel" : get_prefs().pcm_driver;
+  pcm_driver_ = PcmDriver::open (devid, Driver::READWRITE, Driver::WRITEONLY, config, &error);
   if (pcm_driver_)
     *block_size = pcm_driver_->block_length();
   else // !pcm_driver_
@@ -1377,6 +1453,14 @@ ServerImpl::open_pcm_driver (uint mix_freq, uint latency, uint *block_size)
   return pcm_driver_ ? Error::NONE : error;
 }
 
+/// Render offline into the null driver as fast as possible instead of using the preferred PCM driver.
+void
+ServerImpl::freewheel (bool enabled)
+{
+  assert_return (pcm_driver_ == nullptr);
+  freewheel_ = enabled;
+}
+
 void
 ServerImpl::require_pcm_input()
 {
@@ -16,6 +16,8 @@ struct BseServer : BseContainer {
   GSList	  *children;
   gchar		  *wave_file;
   double           wave_seconds;
+  guint            wave_bits;
+  Bse::uint64      wave_trigger_tick;
   guint		   dev_use_count;
   BseModule       *pcm_imodule;
   BseModule       *pcm_omodule;
@@ -27,7 +29,8 @@ struct BseServerClass : BseContainerClass
 
 BseServer*  bse_server_get			  (void);
 void        bse_server_stop_recording             (BseServer *server);
-void        bse_server_start_recording            (BseServer *server, const char *wave_file, double n_seconds);
+void        bse_server_start_recording            (BseServer *server, const char *wave_file, double n_seconds, guint n_bits = 16);
+void        bse_server_trigger_recording          (BseServer *server, Bse::uint64 start_tick);
 Bse::Error  bse_server_open_devices		  (BseServer *server);
 void	    bse_server_close_devices              (BseServer *server);
 void	    bse_server_shutdown                   (BseServer *server);
@@ -59,6 +62,9 @@ class ServerImpl : public virtual ServerIface, public virtual ContainerImpl {
   MidiDriverP        midi_driver_;
   AudioSignal::Engine     *engine_ = nullptr;
   AudioSignal::ProcessorP  midi_proc_;
+  bool                     freewheel_ = false;
+  SharedBlock              profiler_block_;
+  uint                     profiler_timer_ = 0;
 protected:
   virtual             ~ServerImpl            ();
 public:
@@ -77,6 +83,8 @@ public:
   Error               open_pcm_driver       (uint mix_freq, uint latency, uint *block_size);
   void                require_pcm_input     ();
   void                close_pcm_driver      ();
+  bool                freewheel             () const { return freewheel_; }
+  void                freewheel             (bool enabled);
   void                add_pcm_output_processor (AudioSignal::ProcessorP procp);
   void                del_pcm_output_processor (AudioSignal::ProcessorP procp);
   void                add_event_input       (AudioSignal::Processor &proc);
@@ -89,6 +97,9 @@ public:
   virtual LegacyObjectIfaceP    from_proxy       (int64_t proxyid) override;
   virtual SharedMemory  get_shared_memory   () override;
   virtual void    broadcast_shm_fragments   (const ShmFragmentSeq &plan, int interval_ms) override;
+  virtual int64         get_profiler_shm_offset (ProfilerField fld) override;
+  virtual ProfileReport profile_report          () override;
+  virtual void          profile_reset           () override;
   virtual String        get_mp3_version     () override;
   virtual String        get_vorbis_version  () override;
   virtual String        get_ladspa_path     () override;
@@ -101,7 +112,7 @@ public:
   virtual String        get_custom_effect_dir () override;
   virtual String        get_custom_instrument_dir () override;
   virtual void   purge_stale_cachedirs   () override;
-  virtual void   start_recording         (const String &wave_file, double n_seconds) override;
+  virtual void   start_recording         (const String &wave_file, double n_seconds, int n_bits) override;
   virtual void   load_assets             () override;
   virtual void   load_ladspa             () override;
   virtual bool   can_load                (const String &file_name) override;
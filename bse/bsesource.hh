@@ -279,6 +279,7 @@ class SourceImpl : public ItemImpl, public virtual SourceIface {
   void                 cmon_delete             ();
   SharedBlock          cmon_get_block          ();
   char*                cmon_monitor_field_start (uint ochannel);
+  SharedBlock          cmon_get_ring           (uint ochannel);
   friend void ::bse_source_set_context_omodule (BseSource*, uint, BseModule*, BseTrans*);
   friend void ::bse_source_reset               (BseSource*);
   friend void ::bse_source_prepare             (BseSource*);
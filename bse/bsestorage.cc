@@ -181,20 +181,102 @@ bse_storage_turn_readable (BseStorage  *self,
   self->n_dblocks = 0;
   auto blobs = self->data.blobs;
   self->data.blobs.clear();
+  SfiSeq *values = sfi_wstore_steal_values (self->wstore);
 
   bse_storage_input_text (self, text, storage_name);
   self->free_me = text;
   self->dblocks = dblocks;
   self->n_dblocks = n_dblocks;
   self->data.blobs = blobs;
+  sfi_rstore_input_values (self->rstore, values);
+  if (values)
+    sfi_seq_unref (values);
   self->set_flag (BSE_STORAGE_DBLOCK_CONTAINED);
 }
 
+static void
+storage_dblocks_free (BseStorageDBlock *dblocks,
+                      guint             n_dblocks)
+{
+  for (guint i = 0; i < n_dblocks; i++)
+    {
+      bse_id_free (dblocks[i].id);
+      if (dblocks[i].needs_close)
+        gsl_data_handle_close (dblocks[i].dhandle);
+      gsl_data_handle_unref (dblocks[i].dhandle);
+    }
+  g_free (dblocks);
+}
+
+BseStorageSnapshot::~BseStorageSnapshot ()
+{
+  storage_dblocks_free (dblocks, n_dblocks);
+  if (values)
+    sfi_seq_unref (values);
+}
+
+size_t
+BseStorageSnapshot::n_bytes () const
+{
+  // data handles and blobs are shared by reference, only the bookkeeping and values are owned
+  size_t n = n_dblocks * sizeof (dblocks[0]) + blobs.capacity() * sizeof (blobs[0]);
+  const guint n_values = values ? sfi_seq_length (values) : 0;
+  for (guint i = 0; i < n_values; i++)
+    n += sfi_value_bytes_deep (sfi_seq_get (values, i));
+  return n;
+}
+
+/// Finish writing @a self and move its data blocks, blobs and binary values into @a snapshot, returns the stored text.
+std::string
+bse_storage_take_snapshot (BseStorage         *self,
+                           BseStorageSnapshot *snapshot)
+{
+  assert_return (BSE_IS_STORAGE (self), "");
+  assert_return (BSE_STORAGE_DBLOCK_CONTAINED (self), "");
+  assert_return (self->wstore, "");
+  assert_return (self->wstore->flushed == FALSE, "");
+  assert_return (self->wstore->bblocks == NULL, "");
+  assert_return (snapshot && snapshot->n_dblocks == 0 && snapshot->blobs.empty() && !snapshot->values, "");
+
+  bse_storage_break (self);
+  guint l;
+  const gchar *cmem = sfi_wstore_peek_text (self->wstore, &l);
+  std::string text (cmem, l);
+  snapshot->dblocks = self->dblocks;
+  snapshot->n_dblocks = self->n_dblocks;
+  self->dblocks = NULL;
+  self->n_dblocks = 0;
+  snapshot->blobs.swap (self->data.blobs);
+  snapshot->values = sfi_wstore_steal_values (self->wstore);
+  bse_storage_reset (self);
+  return text;
+}
+
+/// Prepare @a self for reading @a text, with data blocks, blobs and binary values taken back from @a snapshot.
 void
-bse_storage_reset (BseStorage *self)
+bse_storage_input_snapshot (BseStorage         *self,
+                            const std::string  &text,
+                            BseStorageSnapshot *snapshot,
+                            const gchar        *storage_name)
 {
-  guint i;
+  assert_return (BSE_IS_STORAGE (self));
+  assert_return (snapshot != NULL);
+
+  gchar *mem = g_strndup (text.data(), text.size());
+  bse_storage_input_text (self, mem, storage_name);
+  self->free_me = mem;
+  self->dblocks = snapshot->dblocks;
+  self->n_dblocks = snapshot->n_dblocks;
+  snapshot->dblocks = NULL;
+  snapshot->n_dblocks = 0;
+  self->data.blobs.swap (snapshot->blobs);
+  sfi_rstore_input_values (self->rstore, snapshot->values);
+  self->set_flag (BSE_STORAGE_DBLOCK_CONTAINED);
+}
 
+void
+bse_storage_reset (BseStorage *self)
+{
   assert_return (BSE_IS_STORAGE (self));
 
   if (self->rstore)
@@ -223,14 +305,7 @@ bse_storage_reset (BseStorage *self)
   self->minor_version = BSE_MINOR_VERSION;
   self->micro_version = BSE_MICRO_VERSION;
 
-  for (i = 0; i < self->n_dblocks; i++)
-    {
-      bse_id_free (self->dblocks[i].id);
-      if (self->dblocks[i].needs_close)
-        gsl_data_handle_close (self->dblocks[i].dhandle);
-      gsl_data_handle_unref (self->dblocks[i].dhandle);
-    }
-  g_free (self->dblocks);
+  storage_dblocks_free (self->dblocks, self->n_dblocks);
   self->dblocks = NULL;
   self->n_dblocks = 0;
 
@@ -295,7 +370,11 @@ bse_storage_prepare_write (BseStorage    *self,
   self->referenced_items = sfi_ppool_new ();
   mode = BseStorageMode (mode & BSE_STORAGE_MODE_MASK);
   if (mode & BSE_STORAGE_DBLOCK_CONTAINED)
-    mode = BseStorageMode (mode | BSE_STORAGE_SELF_CONTAINED);
+    {
+      mode = BseStorageMode (mode | BSE_STORAGE_SELF_CONTAINED);
+      // in-memory storage, keep property values in binary form
+      sfi_wstore_use_values (self->wstore);
+    }
   self->set_flag (mode);
   bse_storage_break (self);
   bse_storage_printf (self, "(bse-version \"%u.%u.%u\")\n\n", BSE_MAJOR_VERSION, BSE_MINOR_VERSION, BSE_MICRO_VERSION);
@@ -96,6 +96,18 @@ struct BseStorageClass : BseObjectClass
 
 typedef class BseStorage::Blob BseStorageBlob;
 
+/// Data blocks, blobs and binary values detached from a self contained storage, e.g. to keep undo backups without parser state.
+struct BseStorageSnapshot {
+  guint                          n_dblocks = 0;
+  BseStorageDBlock              *dblocks = NULL;
+  std::vector<BseStorage::BlobP> blobs;
+  SfiSeq                        *values = NULL;
+  explicit BseStorageSnapshot   () {}
+  /*dtor*/ ~BseStorageSnapshot  ();
+  size_t   n_bytes              () const;
+  BSE_CLASS_NON_COPYABLE (BseStorageSnapshot);
+};
+
 /* --- compatibility file parsing --- */
 void         bse_storage_compat_dhreset         (BseStorage             *self);
 void         bse_storage_compat_dhmixf          (BseStorage             *self,
@@ -112,6 +124,12 @@ void         bse_storage_prepare_write          (BseStorage             *self,
                                                  BseStorageMode          mode);
 void         bse_storage_turn_readable          (BseStorage             *self,
                                                  const gchar            *storage_name);
+std::string  bse_storage_take_snapshot          (BseStorage             *self,
+                                                 BseStorageSnapshot     *snapshot);
+void         bse_storage_input_snapshot         (BseStorage             *self,
+                                                 const std::string      &text,
+                                                 BseStorageSnapshot     *snapshot,
+                                                 const gchar            *storage_name);
 Bse::Error bse_storage_input_file             (BseStorage             *self,
                                                  const gchar            *file_name);
 void         bse_storage_input_text             (BseStorage             *self,
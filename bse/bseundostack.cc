@@ -2,6 +2,7 @@
 #include "bseundostack.hh"
 #include "bseproject.hh"
 #include "bsecontainer.hh"
+#include "bsemain.hh"
 #include "bse/internal.hh"
 #include <string.h>
 
@@ -35,18 +36,23 @@ bse_undo_stack_new (BseProject   *project,
   self->project = project;
   self->notify = notify;
   self->max_steps = 999;
+  self->max_bytes = gsize (Bse::global_prefs->undo_memory) * 1024 * 1024;
   return self;
 }
 
-void
-bse_undo_stack_limit (BseUndoStack *self,
-                      guint         max_steps)
+static void
+undo_stack_shrink (BseUndoStack *self)
 {
-  self->max_steps = max_steps;
-  while (self->n_undo_groups > self->max_steps)
+  /* evict the oldest groups beyond the step limit or memory budget, the most
+   * recent group is kept regardless of its size, unless all steps are disabled
+   */
+  while (self->n_undo_groups > self->max_steps ||
+         (self->max_bytes && self->n_bytes > self->max_bytes && self->n_undo_groups > 1))
     {
       BseUndoGroup *group = (BseUndoGroup*) sfi_ring_pop_tail (&self->undo_groups);
       self->n_undo_groups--;
+      self->n_bytes -= group->n_bytes;
+      UDEBUG ("undo evict: %s (%zu bytes)", group->name, group->n_bytes);
       while (group->undo_steps)
         bse_undo_step_free ((BseUndoStep*) sfi_ring_pop_head (&group->undo_steps));
       g_free (group->name);
@@ -54,6 +60,37 @@ bse_undo_stack_limit (BseUndoStack *self,
     }
 }
 
+void
+bse_undo_stack_limit (BseUndoStack *self,
+                      guint         max_steps)
+{
+  self->max_steps = max_steps;
+  undo_stack_shrink (self);
+}
+
+void
+bse_undo_stack_limit_bytes (BseUndoStack *self,
+                            gsize         max_bytes)
+{
+  self->max_bytes = max_bytes;
+  undo_stack_shrink (self);
+}
+
+/// Account memory shared by several undo steps, the last step holding it releases it with a negative @a n_bytes.
+void
+bse_undo_stack_share_bytes (BseUndoStack *self,
+                            gssize        n_bytes)
+{
+  assert_return (n_bytes >= 0 || self->n_bytes >= gsize (-n_bytes));
+  self->n_bytes += n_bytes;
+}
+
+gsize
+bse_undo_stack_bytes (BseUndoStack *self)
+{
+  return self->n_bytes;
+}
+
 void
 bse_undo_stack_clear (BseUndoStack *self)
 {
@@ -138,6 +175,7 @@ bse_undo_stack_push (BseUndoStack *self,
       UDEBUG ("undo step:  *    ((BseUndoFunc) %p) (%s)", ustep->undo_func, debug_name);
       ustep->debug_name = g_strdup (debug_name);
       self->group->undo_steps = sfi_ring_push_head (self->group->undo_steps, ustep);
+      self->group->n_bytes += ustep->n_bytes;
     }
 }
 
@@ -158,6 +196,7 @@ bse_undo_stack_push_add_on (BseUndoStack *self,
       UDEBUG ("undo step:  *    ((BseUndoFunc) %p) [AddOn to current group]", ustep->undo_func);
       ustep->debug_name = g_strdup ("AddOn");
       self->group->undo_steps = sfi_ring_push_head (self->group->undo_steps, ustep);
+      self->group->n_bytes += ustep->n_bytes;
     }
   else if (self->undo_groups)
     {
@@ -166,6 +205,8 @@ bse_undo_stack_push_add_on (BseUndoStack *self,
       UDEBUG ("undo step:  *    ((BseUndoFunc) %p) [AddOn to last group]", ustep->undo_func);
       ustep->debug_name = g_strdup ("AddOn");
       group->undo_steps = sfi_ring_push_head (group->undo_steps, ustep);
+      group->n_bytes += ustep->n_bytes;
+      self->n_bytes += ustep->n_bytes;
     }
   else
     {
@@ -208,6 +249,8 @@ bse_undo_group_close (BseUndoStack *self)
               mgroup->name = g_strdup (self->merge_name);
               mgroup->undo_steps = sfi_ring_concat (self->group->undo_steps,
                                                     mgroup->undo_steps);
+              mgroup->n_bytes += self->group->n_bytes;
+              self->n_bytes += self->group->n_bytes;
               g_free (self->group->name);
               g_free (self->group);
               if (!self->dirt_counter)  /* ensure dirty */
@@ -216,6 +259,7 @@ bse_undo_group_close (BseUndoStack *self)
           else
             {
               self->n_undo_groups++;
+              self->n_bytes += self->group->n_bytes;
               self->undo_groups = sfi_ring_push_head (self->undo_groups, self->group);
               self->merge_next = self->n_merge_requests > 0;
               self->dirt_counter++;
@@ -299,6 +343,7 @@ bse_undo_stack_undo (BseUndoStack *self)
   if (group)
     {
       self->n_undo_groups--;
+      self->n_bytes -= group->n_bytes;
       self->dirt_counter--;
       UDEBUG ("EXECUTE UNDO: %s", group->name);
       if (CHECK_UDEBUG())
@@ -333,10 +378,12 @@ bse_undo_step_new (BseUndoFunc     undo_func,
 {
   assert_return (undo_func != NULL, NULL);
 
-  BseUndoStep *ustep = (BseUndoStep*) g_malloc0 (sizeof (BseUndoStep) + sizeof (ustep->data) * (MAX (n_data_fields, 1) - 1));
+  const gsize n_bytes = sizeof (BseUndoStep) + sizeof (ustep->data) * (MAX (n_data_fields, 1) - 1);
+  BseUndoStep *ustep = (BseUndoStep*) g_malloc0 (n_bytes);
   ustep->undo_func = undo_func;
   ustep->free_func = free_func;
   ustep->debug_name = NULL;
+  ustep->n_bytes = n_bytes;
   return ustep;
 }
 
@@ -404,3 +451,59 @@ bse_undo_pointer_unpack (const gchar  *packed_pointer,
 
   return item;
 }
+
+// == Testing ==
+#include "testing.hh"
+
+namespace { // Anon
+using namespace Bse;
+
+static void
+test_undo_nop (BseUndoStep *ustep, BseUndoStack *ustack)
+{}
+
+static void
+test_undo_push_group (BseUndoStack *ustack, gsize n_bytes)
+{
+  bse_undo_group_open (ustack, "test-step");
+  BseUndoStep *ustep = bse_undo_step_new (test_undo_nop, NULL, 1);
+  ustep->n_bytes += n_bytes;
+  bse_undo_stack_push (ustack, ustep);
+  bse_undo_group_close (ustack);
+}
+
+BSE_INTEGRITY_TEST (bse_test_undo_stack_budget);
+static void
+bse_test_undo_stack_budget()
+{
+  BseUndoStack *ustack = g_new0 (BseUndoStack, 1);
+  ustack->max_steps = 999;
+  bse_undo_stack_limit_bytes (ustack, 10000);
+  const gsize step_bytes = sizeof (BseUndoStep) + 2000;
+  // the oldest groups are evicted once the budget is exceeded
+  for (uint i = 0; i < 8; i++)
+    {
+      test_undo_push_group (ustack, 2000);
+      TASSERT (bse_undo_stack_bytes (ustack) <= 10000);
+    }
+  TCMP (bse_undo_stack_depth (ustack), ==, 10000 / step_bytes);
+  TCMP (bse_undo_stack_bytes (ustack), ==, bse_undo_stack_depth (ustack) * step_bytes);
+  // shared memory counts against the budget
+  bse_undo_stack_share_bytes (ustack, 5000);
+  test_undo_push_group (ustack, 2000);
+  TCMP (bse_undo_stack_depth (ustack), ==, (10000 - 5000) / step_bytes);
+  bse_undo_stack_share_bytes (ustack, -5000);
+  // lowering the budget evicts immediately, but keeps the most recent group
+  bse_undo_stack_limit_bytes (ustack, 1);
+  TCMP (bse_undo_stack_depth (ustack), ==, 1u);
+  TCMP (bse_undo_stack_bytes (ustack), ==, step_bytes);
+  bse_undo_stack_limit_bytes (ustack, 0);
+  for (uint i = 0; i < 8; i++)
+    test_undo_push_group (ustack, 2000);
+  TCMP (bse_undo_stack_depth (ustack), ==, 9u);
+  bse_undo_stack_clear (ustack);
+  TCMP (bse_undo_stack_bytes (ustack), ==, gsize (0));
+  bse_undo_stack_destroy (ustack);
+}
+
+} // Anon
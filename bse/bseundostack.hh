@@ -13,6 +13,7 @@ typedef struct {
   SfiTime        stamp;
   gchar         *name;
   SfiRing       *undo_steps;
+  gsize          n_bytes;       /* memory held by undo_steps */
 } BseUndoGroup;
 typedef void (*BseUndoNotify)   (BseProject     *project,
                                  BseUndoStack   *ustack,
@@ -27,6 +28,8 @@ struct _BseUndoStack
   guint         max_steps;
   guint         ignore_steps;
   guint         n_undo_groups;
+  gsize         max_bytes;      /* 0 for unlimited */
+  gsize         n_bytes;        /* memory held by undo_groups and shared by their steps */
   SfiRing      *undo_groups;
   gint          dirt_counter; /* signed! */
   guint         n_merge_requests;
@@ -41,6 +44,7 @@ struct _BseUndoStep
   BseUndoFunc   undo_func;
   BseUndoFree   free_func;
   gchar        *debug_name;
+  gsize         n_bytes;        /* accounted memory, including data owned via data[] */
   union {
     gpointer    v_pointer;
     glong       v_long;
@@ -55,6 +59,11 @@ BseUndoStack*      bse_undo_stack_new            (BseProject     *project,
                                                   BseUndoNotify   notify);
 void               bse_undo_stack_limit          (BseUndoStack   *self,
                                                   guint           max_steps);
+void               bse_undo_stack_limit_bytes    (BseUndoStack   *self,
+                                                  gsize           max_bytes);
+void               bse_undo_stack_share_bytes    (BseUndoStack   *self,
+                                                  gssize          n_bytes);
+gsize              bse_undo_stack_bytes          (BseUndoStack   *self);
 void               bse_undo_group_open           (BseUndoStack   *self,
                                                   const gchar    *name);
 void               bse_undo_stack_ignore_steps   (BseUndoStack   *self);
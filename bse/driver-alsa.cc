@@ -5,6 +5,7 @@
 #include "gsldatautils.hh"
 #include "bsesequencer.hh"
 #include "bsemididecoder.hh"
+#include "profiler.hh"
 
 #define ADEBUG(...)             Bse::debug ("alsa", __VA_ARGS__)
 #define MDEBUG(...)             Bse::debug ("midievent", __VA_ARGS__)
@@ -538,7 +539,11 @@ public:
     if (n_frames_avail < 0 ||   // error condition, probably an underrun (-EPIPE)
         (n_frames_avail == 0 && // check RUNNING state
          snd_pcm_state (read_handle_ ? read_handle_ : write_handle_) != SND_PCM_STATE_RUNNING))
-      pcm_retrigger();
+      {
+        if (n_frames_avail < 0)
+          Profiler::count_xrun();
+        pcm_retrigger();
+      }
     if (n_frames_avail < period_size_)
       {
         // not enough data? sync with hardware pointer
@@ -582,6 +587,7 @@ public:
         if (n_frames < 0) // errors during read, could be underrun (-EPIPE)
           {
             ADEBUG ("PCM: %s: read() error: %s", alsadev_, snd_strerror (n_frames));
+            Profiler::count_xrun();
             snd_lib_error_set_handler (silent_error_handler);
             snd_pcm_prepare (read_handle_);     // force retrigger
             snd_lib_error_set_handler (NULL);
@@ -623,6 +629,7 @@ public:
         if (n < 0)                      // errors during write, could be overrun (-EPIPE)
           {
             ADEBUG ("PCM: %s: write() error: %s", alsadev_, snd_strerror (n));
+            Profiler::count_xrun();
             snd_lib_error_set_handler (silent_error_handler);
             snd_pcm_prepare (write_handle_);    // force retrigger
             snd_lib_error_set_handler (NULL);
@@ -233,7 +233,7 @@ public:
   close () override
   {
     assert_return (opened());
-    flags_ &= ~size_t (Flags::OPENED | Flags::READABLE | Flags::WRITABLE);
+    flags_ &= ~size_t (Flags::OPENED | Flags::READABLE | Flags::WRITABLE | Flags::FREEWHEEL);
   }
   virtual Error
   open (IODir iodir, const PcmDriverConfig &config) override
@@ -241,10 +241,12 @@ public:
     assert_return (!opened(), Error::INTERNAL);
     // setup request
     const bool nosleep = true;
+    const bool freewheel = devid_ == "freewheel";
     const bool require_readable = iodir == READONLY || iodir == READWRITE;
     const bool require_writable = iodir == WRITEONLY || iodir == READWRITE;
     flags_ |= Flags::READABLE * require_readable;
     flags_ |= Flags::WRITABLE * require_writable;
+    flags_ |= Flags::FREEWHEEL * freewheel;
     n_channels_ = config.n_channels;
     mix_freq_ = config.mix_freq;
     block_size_ = config.block_length;
@@ -257,6 +259,13 @@ public:
   virtual bool
   pcm_check_io (long *timeoutp) override
   {
+    if (freewheeling())
+      {
+        // render as fast as possible, with sequencer events processed for every block
+        Sequencer::instance().wait_ahead();
+        *timeoutp = 0;
+        return true;
+      }
     // keep the sequencer busy or we will constantly timeout
     Sequencer::instance().wakeup();
     *timeoutp = 1;
@@ -299,6 +308,12 @@ public:
     entry.writeonly = false;
     entry.priority = Driver::PNULL;
     entries.push_back (entry);
+    entry.devid = "freewheel";
+    entry.device_name = "Null PCM Driver (freewheeling)";
+    entry.device_info = _("Discard all PCM output and render as fast as possible, for offline rendering");
+    entry.notice = "";
+    entry.priority = Driver::PNULL + Driver::WDEV;
+    entries.push_back (entry);
   }
 };
 
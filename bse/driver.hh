@@ -9,7 +9,7 @@ namespace Bse {
 
 class Driver : public std::enable_shared_from_this<Driver> {
 protected:
-  struct Flags { enum { OPENED = 1, READABLE = 2, WRITABLE = 4, }; };
+  struct Flags { enum { OPENED = 1, READABLE = 2, WRITABLE = 4, FREEWHEEL = 8, }; };
   const String       devid_;
   size_t             flags_ = 0;
   explicit           Driver     (const String &devid);
@@ -37,6 +37,7 @@ public:
   bool           opened        () const        { return flags_ & Flags::OPENED; }
   bool           readable      () const        { return flags_ & Flags::READABLE; }
   bool           writable      () const        { return flags_ & Flags::WRITABLE; }
+  bool           freewheeling  () const        { return flags_ & Flags::FREEWHEEL; }
   virtual String devid         () const        { return devid_; }
   virtual void   close         () = 0;
   // registry
@@ -10,46 +10,158 @@
 #include <string.h>
 #include <errno.h>
 #include <time.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <unordered_map>
+#include <thread>
 
 
 /* --- macros --- */
-#define	NODEP_INDEX(dcache, node_p)	((node_p) - (dcache)->nodes)
-#define	UPPER_POWER2(n)			(sfi_alloc_upper_power2 (MAX (n, 4)))
 #define	CONFIG_NODE_SIZE()		(BSE_DCACHE_BLOCK_SIZE)
 #define	AGE_EPSILON			(3)	/* must be < resident set */
 #define	LOW_PERSISTENCY_RESIDENT_SET    (5)
+#define	N_SHARDS			(16)	/* power of 2, consecutive nodes use different shards */
+#define	READ_AHEAD_NODES		(4)	/* nodes prefetched after each reading position */
+#define	N_READ_AHEAD_THREADS		(2)
+#define	READ_AHEAD_QUEUE_SIZE		(1024)
 
 /* we use one global lock to protect the dcache list, the list
  * count (length) and the number of aged (unused) nodes.
- * also, each dcache has its own mutext to protect updates in
- * the reference count, nodes or node data blocks.
- * in order to avoid deadlocks, if both locks need
- * to be held, they always have to be acquired in the order
- * 1) global lock, 2) dcache lock.
- * asyncronous data block filling for a new node occours without
- * the dcache lock being held (as most calls to GslDataHandle
- * functions).
- * however, assignment of the newly acquired data is again
- * protected by the dcache lock. concurrent API entries
- * which require demand loading of such data will wait on
- * a global condition which is always signaled once a new data
- * block read has been completed. using one global condition
- * is considered sufficient until shown otherwise by further
- * profiling/debugging measures.
+ * each dcache has its own mutex to protect the open and reference
+ * counts and to serialize node sweeps. the nodes are kept in
+ * N_SHARDS hash tables per dcache, each shard has a spinlock that
+ * protects its table and the reference counts and ages of its nodes.
+ * in order to avoid deadlocks, if several locks need to be held,
+ * they always have to be acquired in the order
+ * 1) global lock, 2) dcache lock, 3) shard lock.
+ * data blocks of new nodes are filled without any lock being held,
+ * either by a read-ahead thread or by the first thread that demands
+ * the data. the read-ahead threads prefetch the nodes following each
+ * reading position, so audio threads usually find their data ready.
+ * the node state doubles as futex, so threads blocking on a node that
+ * is being filled are only woken up once that node's data is assigned.
+ * audio threads pass read-ahead requests and cache sweeps through a
+ * lock-free queue, the read-ahead threads create the nodes and free
+ * them. only demanding a node that wasn't prefetched allocates in the
+ * calling thread. after prefetching a node, the read-ahead threads also
+ * page in the data handle values of the nodes to be prefetched next, so
+ * mapped files don't stall audio threads that demand a node early.
  */
+struct alignas (64) _GslDataCacheShard
+{
+  Bse::Spinlock                                 spinlock;
+  std::unordered_map<int64, GslDataCacheNode*>  nodes;  /* by node number */
+};
+enum {
+  NODE_QUEUED  = 0,     /* no data, waiting for a read-ahead thread */
+  NODE_LOADING = 1,     /* data is being read */
+  NODE_WAITING = 2,     /* data is being read, other threads are waiting */
+  NODE_READY   = 3,     /* data has been assigned */
+};
+
 /* --- prototypes --- */
 static void			dcache_free		(GslDataCache	*dcache);
-static GslDataCacheNode*	data_cache_new_node_L	(GslDataCache	*dcache,
-							 int64		 offset,
-							 guint		 pos,
-							 gboolean	 demand_load);
+static void                     data_cache_free_node    (GslDataCache   *dcache,
+                                                         GslDataCacheNode *node);
+static void                     data_cache_fill_node    (GslDataCache   *dcache,
+                                                         GslDataCacheNode *node);
 
 /* --- variables --- */
 static Bse::Spinlock           global_dcache_spinlock;
-static std::condition_variable global_dcache_cond_node_filled;
 static SfiRing	              *global_dcache_list = NULL;
 static guint                   global_dcache_count = 0;
 static guint                   global_dcache_n_aged_nodes = 0;
+static std::atomic<bool>       global_dcache_sweep_queued { false };
+
+static inline void
+node_futex_wait (std::atomic<int> &state, int value)
+{
+  static_assert (sizeof (state) == sizeof (int), "");
+  syscall (SYS_futex, &state, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+static inline void
+node_futex_wake (std::atomic<int> &state, int n_waiters = INT_MAX)
+{
+  syscall (SYS_futex, &state, FUTEX_WAKE_PRIVATE, n_waiters, NULL, NULL, 0);
+}
+
+/* --- read-ahead --- */
+static void     data_cache_prefetch     (GslDataCache   *dcache,
+                                         int64           nodeno);
+static void     data_cache_sweep        (void);
+
+namespace {
+struct ReadAheadJob {
+  GslDataCache *dcache;
+  int64         nodeno;
+};
+
+/* jobs are passed through a lock-free queue, so audio threads can
+ * submit them without locking or allocating. node creation, dcache
+ * validation and reading all happen in the read-ahead threads.
+ */
+class ReadAheadPool {
+  Bse::AtomicBoundedQueue<ReadAheadJob> jobs_ { READ_AHEAD_QUEUE_SIZE };
+  std::atomic<int>                      stamp_ { 0 };   /* futex, changes with every submit */
+  std::atomic<int>                      n_sleeping_ { 0 };
+  std::atomic<bool>                     quit_ { false };
+  std::vector<std::thread>              threads_;
+  void
+  run (uint id)
+  {
+    Bse::this_thread_set_name (Bse::string_format ("DCacheRead-%u", id));
+    for (;;)
+      {
+        const int stamp = stamp_.load();
+        if (quit_.load())
+          break;
+        ReadAheadJob job;
+        if (jobs_.pop (&job))
+          {
+            if (job.dcache)
+              data_cache_prefetch (job.dcache, job.nodeno);
+            else
+              data_cache_sweep();
+          }
+        else
+          {
+            n_sleeping_ += 1;
+            node_futex_wait (stamp_, stamp);    /* returns early if a job was submitted meanwhile */
+            n_sleeping_ -= 1;
+          }
+      }
+  }
+public:
+  void
+  start ()
+  {
+    for (uint i = 0; i < N_READ_AHEAD_THREADS; i++)
+      threads_.push_back (std::thread (&ReadAheadPool::run, this, i));
+  }
+  /* queue node `nodeno` for prefetching, returns false if the queue is full */
+  bool
+  submit (GslDataCache *dcache, int64 nodeno)
+  {
+    if (!jobs_.push ({ dcache, nodeno }))
+      return false;
+    stamp_ += 1;
+    if (n_sleeping_.load() > 0)
+      node_futex_wake (stamp_, 1);
+    return true;
+  }
+  ~ReadAheadPool()
+  {
+    quit_ = true;
+    stamp_ += 1;
+    node_futex_wake (stamp_);
+    for (auto &thread : threads_)
+      thread.join();
+  }
+};
+static ReadAheadPool read_ahead_pool;
+} // Anon
 
 /* --- functions --- */
 void
@@ -59,6 +171,7 @@ _gsl_init_data_caches (void)
   assert_return (initialized == FALSE);
   initialized++;
   static_assert (AGE_EPSILON < LOW_PERSISTENCY_RESIDENT_SET, "");
+  read_ahead_pool.start();
 }
 GslDataCache*
 gsl_data_cache_new (GslDataHandle *dhandle,
@@ -73,8 +186,7 @@ gsl_data_cache_new (GslDataHandle *dhandle,
   assert_return (node_size == sfi_alloc_upper_power2 (node_size), NULL);
   assert_return (padding < node_size / 2, NULL);
   /* allocate new closed dcache if necessary */
-  dcache = sfi_new_struct (GslDataCache, 1);
-  new (&dcache->mutex) std::mutex();
+  dcache = new GslDataCache();
   dcache->dhandle = gsl_data_handle_ref (dhandle);
   dcache->open_count = 0;
   dcache->ref_count = 1;
@@ -82,8 +194,9 @@ gsl_data_cache_new (GslDataHandle *dhandle,
   dcache->padding = padding;
   dcache->max_age = 0;
   dcache->high_persistency = FALSE;
+  dcache->n_values = 0;
   dcache->n_nodes = 0;
-  dcache->nodes = g_renew (GslDataCacheNode*, NULL, UPPER_POWER2 (dcache->n_nodes));
+  dcache->shards = new GslDataCacheShard[N_SHARDS];
   global_dcache_spinlock.lock();
   global_dcache_list = sfi_ring_append (global_dcache_list, dcache);
   global_dcache_count++;
@@ -108,6 +221,7 @@ gsl_data_cache_open (GslDataCache *dcache)
       else
 	{
           dcache->high_persistency = gsl_data_handle_needs_cache (dcache->dhandle);
+          dcache->n_values = gsl_data_handle_length (dcache->dhandle);
 	  dcache->open_count = 1;
 	  dcache->ref_count++;
 	}
@@ -116,6 +230,43 @@ gsl_data_cache_open (GslDataCache *dcache)
     dcache->open_count++;
   dcache->mutex.unlock();
 }
+/* borrowed node data becomes invalid when the dhandle is closed, so free
+ * unused nodes and copy the rest, returns the number of freed nodes.
+ */
+static guint
+data_cache_return_borrowed_L (GslDataCache *dcache)
+{
+  const guint size = dcache->node_size + (dcache->padding << 1);
+  guint n_freed = 0;
+  for (guint i = 0; i < N_SHARDS; i++)
+    {
+      GslDataCacheShard &shard = dcache->shards[i];
+      shard.spinlock.lock();
+      for (auto it = shard.nodes.begin(); it != shard.nodes.end();)
+        {
+          GslDataCacheNode *node = it->second;
+          if (!node->borrowed)
+            ++it;
+          else if (!node->ref_count)
+            {
+              data_cache_free_node (dcache, node);
+              it = shard.nodes.erase (it);
+              n_freed++;
+            }
+          else
+            {
+              GslDataType *data = sfi_new_struct (GslDataType, size);
+              memcpy (data, node->data - dcache->padding, size * sizeof (data[0]));
+              node->data = data + dcache->padding;
+              node->borrowed = FALSE;
+              ++it;
+            }
+        }
+      shard.spinlock.unlock();
+    }
+  dcache->n_nodes -= n_freed;
+  return n_freed;
+}
 void
 gsl_data_cache_close (GslDataCache *dcache)
 {
@@ -126,12 +277,20 @@ gsl_data_cache_close (GslDataCache *dcache)
   dcache->mutex.lock();
   dcache->open_count--;
   need_unref = !dcache->open_count;
+  guint n_freed = 0;
   if (!dcache->open_count)
     {
       dcache->high_persistency = FALSE;
+      n_freed = data_cache_return_borrowed_L (dcache);
       gsl_data_handle_close (dcache->dhandle);
     }
   dcache->mutex.unlock();
+  if (n_freed)
+    {
+      global_dcache_spinlock.lock();
+      global_dcache_n_aged_nodes -= n_freed;
+      global_dcache_spinlock.unlock();
+    }
   if (need_unref)
     gsl_data_cache_unref (dcache);
 }
@@ -147,23 +306,24 @@ gsl_data_cache_ref (GslDataCache *dcache)
   return dcache;
 }
 static void
+data_cache_free_node (GslDataCache     *dcache,
+                      GslDataCacheNode *node)
+{
+  if (node->data && !node->borrowed)
+    sfi_delete_structs (GslDataType, dcache->node_size + (dcache->padding << 1), node->data - dcache->padding);
+  delete node;
+}
+static void
 dcache_free (GslDataCache *dcache)
 {
-  guint i;
   assert_return (dcache->ref_count == 0);
   assert_return (dcache->open_count == 0);
   gsl_data_handle_unref (dcache->dhandle);
-  for (i = 0; i < dcache->n_nodes; i++)
-    {
-      GslDataCacheNode *node = dcache->nodes[i];
-      guint size;
-      size = dcache->node_size + (dcache->padding << 1);
-      sfi_delete_structs (GslDataType, size, node->data - dcache->padding);
-      sfi_delete_struct (GslDataCacheNode, node);
-    }
-  g_free (dcache->nodes);
-  dcache->mutex.~mutex();
-  sfi_delete_struct (GslDataCache, dcache);
+  for (guint i = 0; i < N_SHARDS; i++)
+    for (auto &entry : dcache->shards[i].nodes)
+      data_cache_free_node (dcache, entry.second);
+  delete[] dcache->shards;
+  delete dcache;
 }
 void
 gsl_data_cache_unref (GslDataCache *dcache)
@@ -205,69 +365,58 @@ gsl_data_cache_unref (GslDataCache *dcache)
     }
 }
 
-static inline GslDataCacheNode**
-data_cache_lookup_nextmost_node_L (GslDataCache *dcache,
-				   int64         offset)
+static inline GslDataCacheShard&
+data_cache_shard (GslDataCache *dcache,
+                  int64         nodeno)
 {
-  if (dcache->n_nodes > 0)
-    {
-      GslDataCacheNode **check, **nodes = dcache->nodes;
-      guint n_nodes = dcache->n_nodes, node_size = dcache->node_size;
-
-      /* caller has to figure himself whether we return nextmost vs. exact match */
-      nodes -= 1;
-      do
-	{
-	  int cmp;
-	  uint i;
-
-	  i = (n_nodes + 1) >> 1;
-	  check = nodes + i;
-	  cmp = offset < (*check)->offset ? -1 : offset >= (*check)->offset + node_size;
-	  if (cmp == 0)
-	    return check;	/* exact match */
-	  else if (cmp > 0)
-	    {
-	      n_nodes -= i;
-	      nodes = check;
-	    }
-	  else /* if (cmp < 0) */
-	    n_nodes = i - 1;
-	}
-      while (n_nodes);
+  return dcache->shards[nodeno & (N_SHARDS - 1)];
+}
 
-      return check; /* nextmost */
-    }
-  return NULL;
+/* create a node without data, referenced once */
+static GslDataCacheNode*
+data_cache_new_node_S (GslDataCache      *dcache,
+                       GslDataCacheShard &shard,
+		       int64	          nodeno)
+{
+  GslDataCacheNode *dnode = new GslDataCacheNode();
+  dnode->offset = nodeno * dcache->node_size;
+  dnode->ref_count = 1;
+  dnode->age = 0;
+  dnode->data = NULL;
+  dnode->borrowed = FALSE;
+  dnode->state = NODE_QUEUED;
+  shard.nodes[nodeno] = dnode;
+  dcache->n_nodes++;
+  return dnode;
 }
 
-static inline GslDataCacheNode*
-data_cache_new_node_L (GslDataCache *dcache,
-		       int64	     offset,
-		       guint	     pos,
-		       gboolean	     demand_load)
+/* read node data, the caller must have moved node->state to NODE_LOADING */
+static void
+data_cache_fill_node (GslDataCache     *dcache,
+                      GslDataCacheNode *dnode)
 {
-  GslDataCacheNode **node_p, *dnode;
   GslDataType *data, *node_data;
-  guint new_node_array_size, old_node_array_size = UPPER_POWER2 (dcache->n_nodes);
-  int64 dhandle_length;
-  guint i, size;
+  int64 offset;
+  guint size;
   gint result;
 
-  i = dcache->n_nodes++;
-  new_node_array_size = UPPER_POWER2 (dcache->n_nodes);
-  if (old_node_array_size != new_node_array_size)
-    dcache->nodes = g_renew (GslDataCacheNode*, dcache->nodes, new_node_array_size);
-  node_p = dcache->nodes + pos;
-  memmove (node_p + 1, node_p, (i - pos) * sizeof (*node_p));
-  dnode = sfi_new_struct (GslDataCacheNode, 1);
-  (*node_p) = dnode;
-  dnode->offset = offset & ~(dcache->node_size - 1);
-  dnode->ref_count = 1;
-  dnode->age = 0;
-  dnode->data = NULL;
-  dcache->mutex.unlock();
   size = dcache->node_size + (dcache->padding << 1);
+  /* plain float handles can serve nodes and their padding from memory */
+  int64 n_peek = 0;
+  const gfloat *values = dnode->offset >= dcache->padding ?
+                         gsl_data_handle_peek_values (dcache->dhandle, dnode->offset - dcache->padding, &n_peek) : NULL;
+  if (values && n_peek >= size)
+    {
+      /* fault the pages in here, so audio threads don't stall on them */
+      const volatile gfloat *pages = values;
+      for (guint i = 0; i < size; i += 4096 / sizeof (gfloat))
+        (void) pages[i];
+      dnode->borrowed = TRUE;
+      dnode->data = const_cast<GslDataType*> (values + dcache->padding);
+      if (dnode->state.exchange (NODE_READY, std::memory_order_release) == NODE_WAITING)
+        node_futex_wake (dnode->state);
+      return;
+    }
   data = sfi_new_struct (GslDataType, size);
   node_data = data + dcache->padding;
   offset = dnode->offset;
@@ -282,35 +431,9 @@ data_cache_new_node_L (GslDataCache *dcache,
     }
   else
     offset -= dcache->padding;
-  if (!demand_load)
-    g_message (G_STRLOC ":FIXME: lazy data loading not yet supported");
-
-  /* copy over data from previous node */
-  GslDataCacheNode *prev_node = pos ? dcache->nodes[pos - 1] : NULL;
-  if (prev_node)
-    {
-      int64 prev_node_size = dcache->node_size;
-      int64 prev_node_offset = prev_node->offset;
-      GslDataType *prev_node_data = prev_node->data;
-
-      /* padding around prev_node */
-      prev_node_size += dcache->padding << 1;
-      prev_node_offset -= dcache->padding;
-      prev_node_data -= dcache->padding;
-
-      /* check for overlap */
-      if (offset < prev_node_offset + prev_node_size)
-        {
-          int64 overlap = prev_node_offset + prev_node_size - offset;
-          memcpy (data, prev_node_data + offset - prev_node_offset, overlap * sizeof (data[0]));
-          size -= overlap;
-          offset += overlap;
-          data += overlap;
-        }
-    }
 
   /* fill from data handle */
-  dhandle_length = gsl_data_handle_length (dcache->dhandle);
+  const int64 dhandle_length = dcache->n_values;
   do
     {
       if (offset >= dhandle_length)
@@ -331,79 +454,152 @@ data_cache_new_node_L (GslDataCache *dcache,
     }
   while (size && result > 0);
   memset (data, 0, size * sizeof (data[0]));
-  dcache->mutex.lock();
   dnode->data = node_data;
-  global_dcache_cond_node_filled.notify_all();
-  return dnode;
+  if (dnode->state.exchange (NODE_READY, std::memory_order_release) == NODE_WAITING)
+    node_futex_wake (dnode->state);
+}
+
+/* block until node->data is assigned, reads the data if no read-ahead thread got to it yet */
+static void
+data_cache_wait_node (GslDataCache     *dcache,
+                      GslDataCacheNode *dnode)
+{
+  for (int state = dnode->state.load (std::memory_order_acquire); state != NODE_READY;
+       state = dnode->state.load (std::memory_order_acquire))
+    switch (state)
+      {
+      case NODE_QUEUED:
+        if (dnode->state.compare_exchange_strong (state, NODE_LOADING, std::memory_order_acquire))
+          data_cache_fill_node (dcache, dnode);
+        break;
+      case NODE_LOADING:
+        if (!dnode->state.compare_exchange_strong (state, NODE_WAITING, std::memory_order_acquire))
+          break;
+        /* fall through */
+      case NODE_WAITING:
+        node_futex_wait (dnode->state, NODE_WAITING);
+        break;
+      }
+}
+
+/* queue missing nodes after nodeno for the read-ahead threads, doesn't allocate */
+static void
+data_cache_read_ahead (GslDataCache *dcache,
+                       int64         nodeno)
+{
+  const int64 last = MIN (nodeno + READ_AHEAD_NODES, (dcache->n_values - 1) / dcache->node_size);
+  for (int64 n = nodeno + 1; n <= last; n++)
+    {
+      GslDataCacheShard &shard = data_cache_shard (dcache, n);
+      shard.spinlock.lock();
+      const bool missing = shard.nodes.find (n) == shard.nodes.end();
+      shard.spinlock.unlock();
+      if (missing && !read_ahead_pool.submit (dcache, n))
+        break;          /* queue is full, demand loading still works */
+    }
 }
+
+/* read node `nodeno` from a read-ahead thread, the dcache may have been closed or freed since the job was queued */
+static void
+data_cache_prefetch (GslDataCache *dcache,
+                     int64         nodeno)
+{
+  /* keep the dcache open while reading, if it's still alive and open */
+  bool alive = false;
+  global_dcache_spinlock.lock();
+  if (sfi_ring_find (global_dcache_list, dcache))
+    {
+      dcache->mutex.lock();
+      alive = dcache->open_count > 0 && nodeno * dcache->node_size < dcache->n_values;
+      if (alive)
+        dcache->open_count++;
+      dcache->mutex.unlock();
+    }
+  global_dcache_spinlock.unlock();
+  if (!alive)
+    return;
+  GslDataCacheShard &shard = data_cache_shard (dcache, nodeno);
+  GslDataCacheNode *node;
+  gboolean rejuvenate_node = FALSE;
+  shard.spinlock.lock();
+  auto it = shard.nodes.find (nodeno);
+  if (it != shard.nodes.end())
+    {
+      node = it->second;
+      rejuvenate_node = !node->ref_count;
+      node->ref_count++;
+    }
+  else
+    node = data_cache_new_node_S (dcache, shard, nodeno);
+  shard.spinlock.unlock();
+  if (rejuvenate_node)
+    {
+      global_dcache_spinlock.lock();
+      global_dcache_n_aged_nodes--;
+      global_dcache_spinlock.unlock();
+    }
+  int state = NODE_QUEUED;      /* a demanding thread may have claimed the node already */
+  if (node->state.compare_exchange_strong (state, NODE_LOADING, std::memory_order_acquire))
+    data_cache_fill_node (dcache, node);
+  gsl_data_cache_unref_node (dcache, node);
+  const int64 next_offset = (nodeno + 1) * dcache->node_size;
+  if (next_offset < dcache->n_values)
+    gsl_data_handle_prefault (dcache->dhandle, next_offset, READ_AHEAD_NODES * dcache->node_size + dcache->padding);
+  gsl_data_cache_close (dcache);
+}
+
 GslDataCacheNode*
 gsl_data_cache_ref_node (GslDataCache       *dcache,
 			 int64               offset,
 			 GslDataCacheRequest load_request)
 {
-  GslDataCacheNode **node_p, *node;
-  guint insertion_pos;
   assert_return (dcache != NULL, NULL);
   assert_return (dcache->ref_count > 0, NULL);
   assert_return (dcache->open_count > 0, NULL);
-  assert_return (offset < gsl_data_handle_length (dcache->dhandle), NULL);
-  std::unique_lock<std::mutex> dcache_lock (dcache->mutex);
-  node_p = data_cache_lookup_nextmost_node_L (dcache, offset);
-  if (node_p)
+  assert_return (offset >= 0 && offset < dcache->n_values, NULL);
+  const int64 nodeno = offset / dcache->node_size;
+  GslDataCacheShard &shard = data_cache_shard (dcache, nodeno);
+  GslDataCacheNode *node = NULL;
+  gboolean rejuvenate_node = FALSE, new_node = FALSE;
+  shard.spinlock.lock();
+  auto it = shard.nodes.find (nodeno);
+  if (it != shard.nodes.end())
     {
-      node = *node_p;
-      if (offset >= node->offset && offset < node->offset + dcache->node_size)
-	{
-	  gboolean rejuvenate_node = !node->ref_count;
-
-	  if (load_request == GSL_DATA_CACHE_PEEK)
-	    {
-	      if (node->data)
-		node->ref_count++;
-	      else
-		node = NULL;
-	      dcache_lock.unlock();
-	      if (node && rejuvenate_node)
-		{
-		  global_dcache_spinlock.lock(); /* different lock */
-		  global_dcache_n_aged_nodes--;
-		  global_dcache_spinlock.unlock();
-		}
-	      return node;
-	    }
-	  node->ref_count++;
-	  if (load_request == GSL_DATA_CACHE_DEMAND_LOAD)
-	    while (!node->data)
-	      global_dcache_cond_node_filled.wait (dcache_lock);
-	  dcache_lock.unlock();
-	  /* printerr ("hit: %d :%d: %d\n", node->offset, offset, node->offset + dcache->node_size); */
-	  if (rejuvenate_node)
-	    {
-	      global_dcache_spinlock.lock(); /* different lock */
-	      global_dcache_n_aged_nodes--;
-	      global_dcache_spinlock.unlock();
-	    }
-	  return node;					/* exact match */
-	}
-      insertion_pos = NODEP_INDEX (dcache, node_p);	/* insert before neighbour */
-      if (offset > node->offset)			/* insert after neighbour */
-	insertion_pos += 1;
-      /* printerr ("mis: %d :%d: %d\n", node->offset, offset, node->offset + dcache->node_size); */
+      node = it->second;
+      if (load_request == GSL_DATA_CACHE_PEEK && node->state.load (std::memory_order_acquire) != NODE_READY)
+        node = NULL;
+      else
+        {
+          rejuvenate_node = !node->ref_count;
+          node->ref_count++;
+        }
     }
-  else
-    insertion_pos = 0;	/* insert at start */
-  if (load_request != GSL_DATA_CACHE_PEEK)
-    node = data_cache_new_node_L (dcache, offset, insertion_pos, load_request == GSL_DATA_CACHE_DEMAND_LOAD);
-  else
-    node = NULL;
+  else if (load_request != GSL_DATA_CACHE_PEEK)
+    {
+      node = data_cache_new_node_S (dcache, shard, nodeno);
+      new_node = TRUE;
+    }
+  shard.spinlock.unlock();
+  if (rejuvenate_node)
+    {
+      global_dcache_spinlock.lock(); /* different lock */
+      global_dcache_n_aged_nodes--;
+      global_dcache_spinlock.unlock();
+    }
+  if (!node || load_request == GSL_DATA_CACHE_PEEK)
+    return node;
+  if (load_request == GSL_DATA_CACHE_DEMAND_LOAD)
+    data_cache_wait_node (dcache, node);
+  else if (new_node && !read_ahead_pool.submit (dcache, nodeno))
+    data_cache_wait_node (dcache, node);        /* GSL_DATA_CACHE_REQUEST, but the queue is full */
+  data_cache_read_ahead (dcache, nodeno);
   return node;
 }
 static gboolean /* still locked */
 data_cache_free_olders_Lunlock (GslDataCache *dcache,
 				guint         max_lru)	/* how many lru nodes to keep */
 {
-  GslDataCacheNode **slot_p;
-  guint i, rejuvenate, size;
+  guint rejuvenate;
   guint n_freed = 0;
 
   assert_return (dcache != NULL, TRUE);
@@ -412,40 +608,37 @@ data_cache_free_olders_Lunlock (GslDataCache *dcache,
    * AGE_EPSILON attempts to prevent.
    */
   max_lru = MAX (AGE_EPSILON, max_lru);
-  if (max_lru >= dcache->max_age)
+  const guint max_age = dcache->max_age;
+  if (max_lru >= max_age)
     return TRUE;
 
-  rejuvenate = dcache->max_age - max_lru;
+  rejuvenate = max_age - max_lru;
   if (0)
     Bse::printout ("start sweep: dcache (%p) with %u nodes, max_age: %u, rejuvenate: %u (max_lru: %u)\n",
-                   dcache, dcache->n_nodes, dcache->max_age, rejuvenate, max_lru);
-  size = dcache->node_size + (dcache->padding << 1);
-  slot_p = NULL;
-  for (i = 0; i < dcache->n_nodes; i++)
+                   dcache, guint (dcache->n_nodes), max_age, rejuvenate, max_lru);
+  for (guint i = 0; i < N_SHARDS; i++)
     {
-      GslDataCacheNode *node = dcache->nodes[i];
-
-      if (!node->ref_count && node->age <= rejuvenate)
-	{
-	  sfi_delete_structs (GslDataType, size, node->data - dcache->padding);
-	  sfi_delete_struct (GslDataCacheNode, node);
-	  if (!slot_p)
-	    slot_p = dcache->nodes + i;
-	  n_freed++;
-	}
-      else
-	{
-	  node->age -= MIN (rejuvenate, node->age);
-	  if (slot_p)
-	    {
-	      *slot_p = node;
-	      slot_p++;
-	    }
-	}
+      GslDataCacheShard &shard = dcache->shards[i];
+      shard.spinlock.lock();
+      for (auto it = shard.nodes.begin(); it != shard.nodes.end();)
+        {
+          GslDataCacheNode *node = it->second;
+          if (!node->ref_count && node->age <= rejuvenate)
+            {
+              data_cache_free_node (dcache, node);
+              it = shard.nodes.erase (it);
+              n_freed++;
+            }
+          else
+            {
+              node->age -= MIN (rejuvenate, node->age);
+              ++it;
+            }
+        }
+      shard.spinlock.unlock();
     }
-  dcache->max_age = max_lru;
-  if (slot_p)
-    dcache->n_nodes = NODEP_INDEX (dcache, slot_p);
+  dcache->max_age -= rejuvenate;        /* preserves concurrent increments */
+  dcache->n_nodes -= n_freed;
   dcache->mutex.unlock();
   if (n_freed)
     {
@@ -457,87 +650,107 @@ data_cache_free_olders_Lunlock (GslDataCache *dcache,
     Bse::printerr ("freed %u nodes (%u bytes) remaining %u bytes (this dcache: n_nodes=%u)\n",
                    n_freed, n_freed * CONFIG_NODE_SIZE (),
                    global_dcache_n_aged_nodes * CONFIG_NODE_SIZE (),
-                   dcache->n_nodes);
+                   guint (dcache->n_nodes));
   return FALSE;
 }
 void
 gsl_data_cache_unref_node (GslDataCache     *dcache,
 			   GslDataCacheNode *node)
 {
-  GslDataCacheNode **node_p;
   gboolean check_cache;
   assert_return (dcache != NULL);
   assert_return (node != NULL);
-  assert_return (node->ref_count > 0);
-  dcache->mutex.lock();
-  node_p = data_cache_lookup_nextmost_node_L (dcache, node->offset);
-  assert_return (node_p && *node_p == node);	/* paranoid check lookup, yeah! */
+  const int64 nodeno = node->offset / dcache->node_size;
+  GslDataCacheShard &shard = data_cache_shard (dcache, nodeno);
+  shard.spinlock.lock();
+  auto it = shard.nodes.find (nodeno);
+  const bool valid_node = it != shard.nodes.end() && it->second == node && node->ref_count > 0;
+  if (!valid_node)
+    {
+      shard.spinlock.unlock();
+      assert_return (valid_node);	/* paranoid check lookup, yeah! */
+    }
   node->ref_count -= 1;
   check_cache = !node->ref_count;
-  if (!node->ref_count &&
-      (node->age + AGE_EPSILON <= dcache->max_age ||
-       dcache->max_age < AGE_EPSILON))
-    node->age = ++dcache->max_age;
-  dcache->mutex.unlock();
+  if (!node->ref_count)
+    {
+      const guint max_age = dcache->max_age;
+      if (node->age + AGE_EPSILON <= max_age || max_age < AGE_EPSILON)
+        node->age = ++dcache->max_age;
+    }
+  shard.spinlock.unlock();
   if (check_cache)
     {
-      guint node_size = CONFIG_NODE_SIZE ();
-      guint cache_mem = BSE_DCACHE_CACHE_MEMORY;
-      guint current_mem;
       global_dcache_spinlock.lock();
       global_dcache_n_aged_nodes++;
-      current_mem = node_size * global_dcache_n_aged_nodes;
-      if (current_mem > cache_mem)              /* round-robin cache trashing */
-	{
-	  bool needs_unlock;
-	  dcache = (GslDataCache*) sfi_ring_pop_head (&global_dcache_list);
-	  dcache->mutex.lock();
-	  dcache->ref_count++;
-	  global_dcache_list = sfi_ring_append (global_dcache_list, dcache);
-	  // uint dcache_count = global_dcache_count;
-	  global_dcache_spinlock.unlock();
+      const bool overflow = CONFIG_NODE_SIZE () * global_dcache_n_aged_nodes > BSE_DCACHE_CACHE_MEMORY;
+      global_dcache_spinlock.unlock();
+      /* sweeps lock a dcache and free nodes, so they are left to the read-ahead threads */
+      if (overflow && !global_dcache_sweep_queued.exchange (true) && !read_ahead_pool.submit (NULL, 0))
+        global_dcache_sweep_queued = false;
+    }
+}
+/* round-robin cache trashing, called from a read-ahead thread */
+static void
+data_cache_sweep (void)
+{
+  global_dcache_sweep_queued = false;
+  guint node_size = CONFIG_NODE_SIZE ();
+  guint cache_mem = BSE_DCACHE_CACHE_MEMORY;
+  guint current_mem;
+  global_dcache_spinlock.lock();
+  current_mem = node_size * global_dcache_n_aged_nodes;
+  if (current_mem > cache_mem && global_dcache_list)
+    {
+      bool needs_unlock;
+      GslDataCache *dcache = (GslDataCache*) sfi_ring_pop_head (&global_dcache_list);
+      dcache->mutex.lock();
+      dcache->ref_count++;
+      global_dcache_list = sfi_ring_append (global_dcache_list, dcache);
+      // uint dcache_count = global_dcache_count;
+      global_dcache_spinlock.unlock();
 #define DEBUG_TRASHING 0
 #if DEBUG_TRASHING
-          gint debug_gnaged = global_dcache_n_aged_nodes;
+      gint debug_gnaged = global_dcache_n_aged_nodes;
 #endif
-          if (dcache->high_persistency) /* hard/slow to refill */
-            {
-              /* try to free the actual cache overflow from the
-               * dcache we just picked, but don't free more than
-               * 25% of its nodes yet.
-               * overflow is actual overhang + ~6% of cache size,
-               * so cache sweeps are triggered less frequently.
-               */
-              current_mem -= cache_mem;		/* overhang */
-              current_mem += cache_mem >> 4;	/* overflow = overhang + 6% */
-              current_mem /= node_size;		/* n_nodes to free */
-              current_mem = MIN (current_mem, dcache->n_nodes);
-              guint max_lru = dcache->n_nodes;
-              max_lru >>= 1;                    /* keep at least 75% of n_nodes */
-              max_lru += max_lru >> 1;
-              max_lru = MAX (max_lru, dcache->n_nodes - current_mem);
-              needs_unlock = data_cache_free_olders_Lunlock (dcache, MAX (max_lru, LOW_PERSISTENCY_RESIDENT_SET));
-            }
-          else  /* low persistency - easy to refill */
-            {
-              guint max_lru = dcache->n_nodes;
-              max_lru >>= 2;                    /* keep only 25% of n_nodes */
-              needs_unlock = data_cache_free_olders_Lunlock (dcache, MAX (max_lru, LOW_PERSISTENCY_RESIDENT_SET));
-            }
+      const guint n_nodes = dcache->n_nodes;
+      if (dcache->high_persistency) /* hard/slow to refill */
+        {
+          /* try to free the actual cache overflow from the
+           * dcache we just picked, but don't free more than
+           * 25% of its nodes yet.
+           * overflow is actual overhang + ~6% of cache size,
+           * so cache sweeps are triggered less frequently.
+           */
+          current_mem -= cache_mem;		/* overhang */
+          current_mem += cache_mem >> 4;	/* overflow = overhang + 6% */
+          current_mem /= node_size;		/* n_nodes to free */
+          current_mem = MIN (current_mem, n_nodes);
+          guint max_lru = n_nodes;
+          max_lru >>= 1;                    /* keep at least 75% of n_nodes */
+          max_lru += max_lru >> 1;
+          max_lru = MAX (max_lru, n_nodes - current_mem);
+          needs_unlock = data_cache_free_olders_Lunlock (dcache, MAX (max_lru, LOW_PERSISTENCY_RESIDENT_SET));
+        }
+      else  /* low persistency - easy to refill */
+        {
+          guint max_lru = n_nodes;
+          max_lru >>= 2;                    /* keep only 25% of n_nodes */
+          needs_unlock = data_cache_free_olders_Lunlock (dcache, MAX (max_lru, LOW_PERSISTENCY_RESIDENT_SET));
+        }
 #if DEBUG_TRASHING
-          if (dcache->dhandle->open_count)
-            Bse::printerr ("shrunk dcache by: dhandle=%p - %s - highp=%d: %d bytes (kept: %d)\n",
-                           dcache->dhandle, gsl_data_handle_name (dcache->dhandle),
-                           dcache->high_persistency,
-                           -(gint) node_size * (debug_gnaged - global_dcache_n_aged_nodes),
-                           node_size * dcache->n_nodes);
+      if (dcache->dhandle->open_count)
+        Bse::printerr ("shrunk dcache by: dhandle=%p - %s - highp=%d: %d bytes (kept: %d)\n",
+                       dcache->dhandle, gsl_data_handle_name (dcache->dhandle),
+                       dcache->high_persistency,
+                       -(gint) node_size * (debug_gnaged - global_dcache_n_aged_nodes),
+                       node_size * guint (dcache->n_nodes));
 #endif
-	  if (needs_unlock)
-	    dcache->mutex.unlock();
-	}
-      else
-	global_dcache_spinlock.unlock();
+      if (needs_unlock)
+        dcache->mutex.unlock();
     }
+  else
+    global_dcache_spinlock.unlock();
 }
 void
 gsl_data_cache_free_olders (GslDataCache *dcache,
@@ -11,25 +11,29 @@
 /* --- typedefs & structures --- */
 typedef gfloat                     GslDataType;
 typedef struct _GslDataCacheNode   GslDataCacheNode;
+typedef struct _GslDataCacheShard  GslDataCacheShard;
 struct _GslDataCache
 {
   GslDataHandle	       *dhandle;
   guint			open_count;
-  std::mutex            mutex;
+  std::mutex            mutex;                  /* protects open_count, ref_count and node sweeps */
   guint			ref_count;
   guint			node_size;	        /* power of 2, const for all dcaches */
   guint			padding;	        /* n_values around blocks */
-  guint			max_age;
+  std::atomic<guint>	max_age;
   gboolean		high_persistency;       /* valid for opened caches only */
-  guint			n_nodes;
-  GslDataCacheNode    **nodes;
+  int64                 n_values;               /* dhandle length, valid for opened caches only */
+  std::atomic<guint>	n_nodes;
+  GslDataCacheShard    *shards;                 /* node tables, indexed by node number */
 };
 struct _GslDataCacheNode
 {
-  int64	        offset;
-  guint		ref_count;
-  guint		age;
-  GslDataType  *data;	/* NULL while busy */
+  int64	           offset;
+  guint		   ref_count;
+  guint		   age;
+  GslDataType     *data;	/* NULL while busy */
+  gboolean         borrowed;    /* data points into dhandle memory, see gsl_data_handle_peek_values() */
+  std::atomic<int> state;       /* futex word, signals data assignments */
 };
 typedef enum
 {
@@ -7,6 +7,8 @@
 #include "bse/internal.hh"
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 /* --- typedefs --- */
 typedef struct {
@@ -144,6 +146,53 @@ gsl_data_handle_read (GslDataHandle *dhandle,
   dhandle->spinlock.unlock();
   return l;
 }
+/**
+ * @param dhandle	an opened DataHandle
+ * @param value_offset	first value to access
+ * @param n_values	location to store the number of accessible values
+ * @return		pointer to the values at @a value_offset or NULL
+ *
+ * Access the data of handles that keep their values in memory as plain
+ * floats (memory handles, mmapped float WAV files) without copying.
+ * The returned pointer stays valid until @a dhandle is closed, handles
+ * that need to convert their values return NULL and need to be read
+ * via gsl_data_handle_read().
+ */
+const gfloat*
+gsl_data_handle_peek_values (GslDataHandle *dhandle,
+                             int64          value_offset,
+                             int64         *n_values)
+{
+  assert_return (dhandle != NULL, NULL);
+  assert_return (dhandle->open_count > 0, NULL);
+  assert_return (n_values != NULL, NULL);
+  assert_return (value_offset >= 0 && value_offset < dhandle->setup.n_values, NULL);
+  *n_values = 0;
+  if (!dhandle->vtable->peek)
+    return NULL;
+  return dhandle->vtable->peek (dhandle, value_offset, n_values);
+}
+/**
+ * @param dhandle	an opened DataHandle
+ * @param value_offset	first value to page in
+ * @param n_values	number of values to page in
+ *
+ * Make sure the values of handles that map their data from files are
+ * resident, so later reads and peeked values don't block on disk I/O.
+ * This may block and is meant to be called from read-ahead threads,
+ * handles that don't map their data ignore it.
+ */
+void
+gsl_data_handle_prefault (GslDataHandle *dhandle,
+                          int64          value_offset,
+                          int64          n_values)
+{
+  assert_return (dhandle != NULL);
+  assert_return (dhandle->open_count > 0);
+  assert_return (value_offset >= 0);
+  if (dhandle->vtable->prefault && value_offset < dhandle->setup.n_values && n_values > 0)
+    dhandle->vtable->prefault (dhandle, value_offset, MIN (n_values, dhandle->setup.n_values - value_offset));
+}
 GslDataHandle*
 gsl_data_handle_get_source (GslDataHandle *dhandle)
 {
@@ -335,6 +384,17 @@ mem_handle_read (GslDataHandle *dhandle,
   return n_values;
 }
 
+static const gfloat*
+mem_handle_peek (GslDataHandle *dhandle,
+                 int64          voffset,
+                 int64         *n_values)
+{
+  MemHandle *mhandle = (MemHandle*) dhandle;
+
+  *n_values = mhandle->n_values - voffset;
+  return mhandle->values + voffset;
+}
+
 GslDataHandle*
 gsl_data_handle_new_mem (guint         n_channels,
 			 guint         bit_depth,
@@ -351,6 +411,7 @@ gsl_data_handle_new_mem (guint         n_channels,
     NULL,
     NULL,
     mem_handle_destroy,
+    mem_handle_peek,
   };
   MemHandle *mhandle;
   gboolean success;
@@ -1399,8 +1460,17 @@ typedef struct {
   int64	            requested_length;
   gchar           **xinfos;
   gfloat            mix_freq;
+  /* mmapped sample data (open_count > 0) */
+  const guint8     *map_start;
+  size_t            map_length;
+  const guint8     *map_values;
+  std::atomic<int64> resident_start;   /* byte range last paged in by wave_handle_prefault() */
+  std::atomic<int64> resident_end;
 } WaveHandle;
 
+/* minimum payload to be mmapped, smaller files are simply read */
+#define WAVE_HANDLE_MMAP_MIN     (64 * 1024)
+
 static inline guint G_GNUC_CONST
 wave_format_bit_depth (const GslWaveFormatType format)
 {
@@ -1465,6 +1535,39 @@ wave_handle_destroy (GslDataHandle *dhandle)
   sfi_delete_struct (WaveHandle, whandle);
 }
 
+static void
+wave_handle_map (WaveHandle *whandle,
+                 int64       n_bytes)
+{
+  /* map the sample data of uncompressed files, so reads are served from the
+   * page cache without a syscall and float data can be accessed in place
+   */
+  const int64 fwidth = wave_format_byte_width (whandle->format);
+  const int64 alignment = fwidth == 3 ? 1 : fwidth;
+  whandle->map_start = NULL;
+  whandle->map_length = 0;
+  whandle->map_values = NULL;
+  whandle->resident_start = 0;
+  whandle->resident_end = 0;
+  const int64 file_offset = whandle->hfile->base + whandle->byte_offset;  /* hfile may be an archive window */
+  if (n_bytes < WAVE_HANDLE_MMAP_MIN || file_offset % alignment)
+    return;     /* unaligned sample access would need memcpy anyway */
+  if (whandle->format == GSL_WAVE_FORMAT_SIGNED_24_PAD4)
+    return;     /* frame width differs from wave_format_byte_width() */
+  const int64 page_mask = sysconf (_SC_PAGESIZE) - 1;
+  const int64 map_offset = file_offset & ~page_mask;
+  const int64 map_length = file_offset - map_offset + n_bytes;
+  if (map_length != int64 (size_t (map_length)))
+    return;     /* exceeds address space */
+  void *mem = mmap (NULL, map_length, PROT_READ, MAP_SHARED, whandle->hfile->fd, map_offset);
+  if (mem == MAP_FAILED)
+    return;     /* fallback to gsl_hfile_pread() */
+  madvise (mem, map_length, MADV_SEQUENTIAL);
+  whandle->map_start = (const guint8*) mem;
+  whandle->map_length = map_length;
+  whandle->map_values = whandle->map_start + file_offset - map_offset;
+}
+
 static Bse::Error
 wave_handle_open (GslDataHandle      *dhandle,
 		  GslDataHandleSetup *setup)
@@ -1501,9 +1604,11 @@ wave_handle_open (GslDataHandle      *dhandle,
       setup->xinfos = whandle->xinfos;
       setup->bit_depth = wave_format_bit_depth (whandle->format);
       setup->mix_freq = whandle->mix_freq;
+      wave_handle_map (whandle, setup->n_values * fwidth);
 #ifndef __linux__
       /* linux does proper caching and WAVs are easily readable */
-      setup->needs_cache = TRUE;
+      if (!whandle->map_values)
+        setup->needs_cache = TRUE;
 #endif
       return Bse::Error::NONE;
     }
@@ -1515,10 +1620,79 @@ wave_handle_close (GslDataHandle *dhandle)
   WaveHandle *whandle = (WaveHandle*) dhandle;
 
   dhandle->setup.xinfos = NULL;
+  if (whandle->map_start)
+    munmap ((void*) whandle->map_start, whandle->map_length);
+  whandle->map_start = NULL;
+  whandle->map_length = 0;
+  whandle->map_values = NULL;
   gsl_hfile_close (whandle->hfile);
   whandle->hfile = NULL;
 }
 
+static void
+wave_handle_prefault (GslDataHandle *dhandle,
+                      int64          voffset,
+                      int64          n_values)
+{
+  WaveHandle *whandle = (WaveHandle*) dhandle;
+  if (!whandle->map_values)
+    return;
+  /* MADV_WILLNEED is only a hint, so touch every page to have it mapped before audio threads read it */
+  const int64 fwidth = wave_format_byte_width (whandle->format);
+  const int64 start = whandle->map_values - whandle->map_start + voffset * fwidth;
+  const int64 end = MIN (start + n_values * fwidth, int64 (whandle->map_length));
+  const int64 resident_start = whandle->resident_start.load (std::memory_order_relaxed);
+  const int64 resident_end = whandle->resident_end.load (std::memory_order_relaxed);
+  if (start >= resident_start && end <= resident_end)
+    return;
+  const int64 page_size = sysconf (_SC_PAGESIZE);
+  int64 page_start = start & ~(page_size - 1), new_resident_start = page_start;
+  if (start >= resident_start && start < resident_end)
+    {
+      page_start = resident_end & ~(page_size - 1);    /* sequential reading, only page in the new part */
+      new_resident_start = resident_start;
+    }
+  madvise ((void*) (whandle->map_start + page_start), end - page_start, MADV_WILLNEED);
+  const volatile guint8 *pages = whandle->map_start;
+  for (int64 offset = page_start; offset < end; offset += page_size)
+    (void) pages[offset];
+  whandle->resident_start.store (new_resident_start, std::memory_order_relaxed);
+  whandle->resident_end.store (end, std::memory_order_relaxed);
+}
+
+static int64
+wave_handle_read_mapped (WaveHandle *whandle,
+                         int64       voffset,
+                         int64       n_values,
+                         gfloat     *values)
+{
+  const int64 fwidth = wave_format_byte_width (whandle->format);
+  n_values = MIN (n_values, whandle->dhandle.setup.n_values - voffset);
+  n_values = MIN (n_values, G_MAXINT);
+  if (n_values < 1)
+    return 0;
+  const int64 byte_offset = voffset * fwidth;
+  const guint8 *bytes = whandle->map_values + byte_offset;
+  if (whandle->format == GSL_WAVE_FORMAT_FLOAT && whandle->byte_order == G_BYTE_ORDER)
+    memcpy (values, bytes, n_values * sizeof (values[0]));      /* gsl_conv_to_float() converts in-place only */
+  else
+    gsl_conv_to_float (whandle->format, whandle->byte_order, bytes, values, n_values);
+  return n_values;
+}
+
+static const gfloat*
+wave_handle_peek (GslDataHandle *dhandle,
+                  int64          voffset,
+                  int64         *n_values)
+{
+  WaveHandle *whandle = (WaveHandle*) dhandle;
+
+  if (!whandle->map_values || whandle->format != GSL_WAVE_FORMAT_FLOAT || whandle->byte_order != G_BYTE_ORDER)
+    return NULL;
+  *n_values = dhandle->setup.n_values - voffset;
+  return ((const gfloat*) whandle->map_values) + voffset;
+}
+
 static int64
 wave_handle_read (GslDataHandle *dhandle,
 		  int64          voffset,
@@ -1529,6 +1703,9 @@ wave_handle_read (GslDataHandle *dhandle,
   gpointer buffer = values;
   int64 l, byte_offset;
 
+  if (whandle->map_values)
+    return wave_handle_read_mapped (whandle, voffset, n_values, values);
+
   byte_offset = voffset * wave_format_byte_width (whandle->format);	/* float offset into bytes */
   byte_offset += whandle->byte_offset;
 
@@ -1620,6 +1797,8 @@ gsl_wave_handle_new (const gchar      *file_name,
     NULL,
     NULL,
     wave_handle_destroy,
+    wave_handle_peek,
+    wave_handle_prefault,
   };
   WaveHandle *whandle;
 
@@ -1642,6 +1821,8 @@ gsl_wave_handle_new (const gchar      *file_name,
       whandle->requested_offset = byte_offset;
       whandle->requested_length = n_values;
       whandle->hfile = NULL;
+      whandle->map_start = NULL;
+      whandle->map_values = NULL;
       whandle->xinfos = bse_xinfos_dup_consolidated (xinfos, FALSE);
       whandle->mix_freq = mix_freq;
       whandle->xinfos = bse_xinfos_add_float (whandle->xinfos, "osc-freq", osc_freq);
@@ -45,6 +45,12 @@ struct _GslDataHandleFuncs
   GslDataHandle* (*get_source)          (GslDataHandle          *data_handle);
   int64          (*get_state_length)	(GslDataHandle	        *data_handle);
   void           (*destroy)		(GslDataHandle		*data_handle);
+  const gfloat*  (*peek)		(GslDataHandle		*data_handle,
+					 int64			 voffset,
+					 int64			*n_values);
+  void           (*prefault)		(GslDataHandle		*data_handle,
+					 int64			 voffset,
+					 int64			 n_values);
 };
 
 
@@ -68,6 +74,12 @@ int64		  gsl_data_handle_read		    (GslDataHandle	  *data_handle,
 						     int64		   value_offset,
 						     int64		   n_values,
 						     gfloat		  *values);
+const gfloat*	  gsl_data_handle_peek_values	    (GslDataHandle	  *data_handle,
+						     int64		   value_offset,
+						     int64		  *n_values);
+void		  gsl_data_handle_prefault	    (GslDataHandle	  *data_handle,
+						     int64		   value_offset,
+						     int64		   n_values);
 int64		  gsl_data_handle_get_state_length  (GslDataHandle        *dhandle);
 GslDataHandle*    gsl_data_handle_get_source	    (GslDataHandle        *dhandle);
 GslDataHandle*	  gsl_data_handle_new_scale         (GslDataHandle	  *src_handle,
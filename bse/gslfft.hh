@@ -180,4 +180,50 @@ void	gsl_power2_fftsr_scale_simple (const unsigned int n_values,
 
 
 
+/* --- single precision plans --- */
+typedef struct _GslFftPlan GslFftPlan;
+
+/**
+ * @param n_values      Transform size, a power of two >= 2
+ * @returns             Newly allocated plan, release with gsl_fft_plan_free()
+ *
+ * Precompute bit reversal and twiddle tables for single precision transforms
+ * of @a n_values complex values, or @a n_values real values respectively.
+ * The plan functions use the same value layout and normalization as their
+ * gsl_power2_fft*() counterparts, but operate on float arrays and use SSE or
+ * AVX2 butterflies where available ($BSE_FFT_IMPL=FPU forces the scalar code).
+ * A plan is immutable after creation and may be used by several threads
+ * concurrently.
+ */
+GslFftPlan* gsl_fft_plan_new         (uint              n_values);
+GslFftPlan* gsl_fft_plan_new_impl    (uint              n_values,
+                                      const char       *impl_name);
+void        gsl_fft_plan_free        (GslFftPlan       *plan);
+uint        gsl_fft_plan_n_values    (const GslFftPlan *plan);
+const char* gsl_fft_plan_impl_name   (const GslFftPlan *plan);
+/// Single precision variant of gsl_power2_fftac().
+void        gsl_fft_plan_fftac       (const GslFftPlan *plan,
+                                      const float      *ri_values_in,
+                                      float            *ri_values_out);
+/// Single precision variant of gsl_power2_fftsc().
+void        gsl_fft_plan_fftsc       (const GslFftPlan *plan,
+                                      const float      *ri_values_in,
+                                      float            *ri_values_out);
+/// Single precision variant of gsl_power2_fftsc_scale().
+void        gsl_fft_plan_fftsc_scale (const GslFftPlan *plan,
+                                      const float      *ri_values_in,
+                                      float            *ri_values_out);
+/// Single precision variant of gsl_power2_fftar().
+void        gsl_fft_plan_fftar       (const GslFftPlan *plan,
+                                      const float      *r_values_in,
+                                      float            *ri_values_out);
+/// Single precision variant of gsl_power2_fftsr().
+void        gsl_fft_plan_fftsr       (const GslFftPlan *plan,
+                                      const float      *ri_values_in,
+                                      float            *r_values_out);
+/// Single precision variant of gsl_power2_fftsr_scale().
+void        gsl_fft_plan_fftsr_scale (const GslFftPlan *plan,
+                                      const float      *ri_values_in,
+                                      float            *r_values_out);
+
 #endif /* __GSL_FFT_H__ */   /* vim:set ts=8 sw=2 sts=2: */
@@ -0,0 +1,462 @@
+// Licensed GNU LGPL v2.1 or later: http://www.gnu.org/licenses/lgpl.html
+#include "gslfft.hh"
+#include "bseblockutils.hh"
+#include "bse/platform.hh"
+#include "bse/internal.hh"
+#if defined __x86_64__ || defined __amd64__
+#include <immintrin.h>
+#define GSL_FFT_X86_KERNELS     1
+#define GSL_TARGET_AVX2         __attribute__ ((__target__ ("avx2,fma")))
+#endif
+
+/* --- plan layout --- */
+/* A plan for n_values contains the bit reversal table for n_values and the twiddle
+ * factors of all radix-2 stages up to the half size n_values/2, each stage with
+ * half size m is stored contiguously at complex offset m, so vector loads can
+ * fetch consecutive twiddles. The same tables serve complex transforms of
+ * n_values/2 values, used to implement the real valued transforms of n_values.
+ */
+namespace {
+
+struct FftKernels {
+  const char *name;
+  // one radix-2 stage with half size m >= 4 over all n complex values
+  void      (*radix2) (uint n, float *x, uint m, const float *w);
+  // two fused radix-2 stages with half sizes m >= 4 and 2 * m
+  void      (*radix4) (uint n, float *x, uint m, const float *w1, const float *w2);
+};
+
+/* --- FPU kernels --- */
+static void
+fpu_radix2 (uint n, float *x, uint m, const float *w)
+{
+  for (uint k = 0; k < n; k += 2 * m)
+    for (uint j = 0; j < m; j++)
+      {
+        float *a = x + 2 * (k + j), *b = a + 2 * m;
+        const float wr = w[2 * j], wi = w[2 * j + 1];
+        const float tr = b[0] * wr - b[1] * wi, ti = b[0] * wi + b[1] * wr;
+        b[0] = a[0] - tr;
+        b[1] = a[1] - ti;
+        a[0] += tr;
+        a[1] += ti;
+      }
+}
+
+static void
+fpu_radix4 (uint n, float *x, uint m, const float *w1, const float *w2)
+{
+  for (uint k = 0; k < n; k += 4 * m)
+    for (uint j = 0; j < m; j++)
+      {
+        float *x0 = x + 2 * (k + j), *x1 = x0 + 2 * m, *x2 = x1 + 2 * m, *x3 = x2 + 2 * m;
+        // stage m
+        float wr = w1[2 * j], wi = w1[2 * j + 1];
+        float tr = x1[0] * wr - x1[1] * wi, ti = x1[0] * wi + x1[1] * wr;
+        const float a0r = x0[0] + tr, a0i = x0[1] + ti, a1r = x0[0] - tr, a1i = x0[1] - ti;
+        tr = x3[0] * wr - x3[1] * wi;
+        ti = x3[0] * wi + x3[1] * wr;
+        const float a2r = x2[0] + tr, a2i = x2[1] + ti, a3r = x2[0] - tr, a3i = x2[1] - ti;
+        // stage 2 * m
+        wr = w2[2 * j];
+        wi = w2[2 * j + 1];
+        tr = a2r * wr - a2i * wi;
+        ti = a2r * wi + a2i * wr;
+        x0[0] = a0r + tr;
+        x0[1] = a0i + ti;
+        x2[0] = a0r - tr;
+        x2[1] = a0i - ti;
+        wr = w2[2 * (j + m)];
+        wi = w2[2 * (j + m) + 1];
+        tr = a3r * wr - a3i * wi;
+        ti = a3r * wi + a3i * wr;
+        x1[0] = a1r + tr;
+        x1[1] = a1i + ti;
+        x3[0] = a1r - tr;
+        x3[1] = a1i - ti;
+      }
+}
+
+static const FftKernels fpu_kernels = { "FPU", fpu_radix2, fpu_radix4 };
+
+#ifdef GSL_FFT_X86_KERNELS
+/* --- SSE kernels --- */
+// two interleaved complex products a * w, SSE2 is part of the x86-64 baseline
+static inline __m128
+sse_cmul (__m128 a, __m128 w)
+{
+  const __m128 wr = _mm_shuffle_ps (w, w, _MM_SHUFFLE (2, 2, 0, 0));
+  const __m128 wi = _mm_shuffle_ps (w, w, _MM_SHUFFLE (3, 3, 1, 1));
+  const __m128 as = _mm_shuffle_ps (a, a, _MM_SHUFFLE (2, 3, 0, 1));
+  const __m128 neg_re = _mm_castsi128_ps (_mm_setr_epi32 (0x80000000, 0, 0x80000000, 0));
+  return _mm_add_ps (_mm_mul_ps (a, wr), _mm_xor_ps (_mm_mul_ps (as, wi), neg_re));
+}
+
+static void
+sse_radix2 (uint n, float *x, uint m, const float *w)
+{
+  for (uint k = 0; k < n; k += 2 * m)
+    for (uint j = 0; j < m; j += 2)
+      {
+        float *a = x + 2 * (k + j), *b = a + 2 * m;
+        const __m128 va = _mm_loadu_ps (a), t = sse_cmul (_mm_loadu_ps (b), _mm_loadu_ps (w + 2 * j));
+        _mm_storeu_ps (a, _mm_add_ps (va, t));
+        _mm_storeu_ps (b, _mm_sub_ps (va, t));
+      }
+}
+
+static void
+sse_radix4 (uint n, float *x, uint m, const float *w1, const float *w2)
+{
+  for (uint k = 0; k < n; k += 4 * m)
+    for (uint j = 0; j < m; j += 2)
+      {
+        float *x0 = x + 2 * (k + j), *x1 = x0 + 2 * m, *x2 = x1 + 2 * m, *x3 = x2 + 2 * m;
+        const __m128 vw1 = _mm_loadu_ps (w1 + 2 * j);
+        const __m128 v0 = _mm_loadu_ps (x0), v2 = _mm_loadu_ps (x2);
+        const __m128 t1 = sse_cmul (_mm_loadu_ps (x1), vw1), t3 = sse_cmul (_mm_loadu_ps (x3), vw1);
+        const __m128 a0 = _mm_add_ps (v0, t1), a1 = _mm_sub_ps (v0, t1);
+        const __m128 a2 = _mm_add_ps (v2, t3), a3 = _mm_sub_ps (v2, t3);
+        const __m128 u2 = sse_cmul (a2, _mm_loadu_ps (w2 + 2 * j)), u3 = sse_cmul (a3, _mm_loadu_ps (w2 + 2 * (j + m)));
+        _mm_storeu_ps (x0, _mm_add_ps (a0, u2));
+        _mm_storeu_ps (x2, _mm_sub_ps (a0, u2));
+        _mm_storeu_ps (x1, _mm_add_ps (a1, u3));
+        _mm_storeu_ps (x3, _mm_sub_ps (a1, u3));
+      }
+}
+
+static const FftKernels sse_kernels = { "SSE", sse_radix2, sse_radix4 };
+
+/* --- AVX2 kernels --- */
+// four interleaved complex products a * w, even lanes subtract, odd lanes add
+GSL_TARGET_AVX2 static inline __m256
+avx2_cmul (__m256 a, __m256 w)
+{
+  const __m256 as = _mm256_permute_ps (a, _MM_SHUFFLE (2, 3, 0, 1));
+  return _mm256_fmaddsub_ps (a, _mm256_moveldup_ps (w), _mm256_mul_ps (as, _mm256_movehdup_ps (w)));
+}
+
+GSL_TARGET_AVX2 static void
+avx2_radix2 (uint n, float *x, uint m, const float *w)
+{
+  for (uint k = 0; k < n; k += 2 * m)
+    for (uint j = 0; j < m; j += 4)
+      {
+        float *a = x + 2 * (k + j), *b = a + 2 * m;
+        const __m256 va = _mm256_loadu_ps (a), t = avx2_cmul (_mm256_loadu_ps (b), _mm256_loadu_ps (w + 2 * j));
+        _mm256_storeu_ps (a, _mm256_add_ps (va, t));
+        _mm256_storeu_ps (b, _mm256_sub_ps (va, t));
+      }
+}
+
+GSL_TARGET_AVX2 static void
+avx2_radix4 (uint n, float *x, uint m, const float *w1, const float *w2)
+{
+  for (uint k = 0; k < n; k += 4 * m)
+    for (uint j = 0; j < m; j += 4)
+      {
+        float *x0 = x + 2 * (k + j), *x1 = x0 + 2 * m, *x2 = x1 + 2 * m, *x3 = x2 + 2 * m;
+        const __m256 vw1 = _mm256_loadu_ps (w1 + 2 * j);
+        const __m256 v0 = _mm256_loadu_ps (x0), v2 = _mm256_loadu_ps (x2);
+        const __m256 t1 = avx2_cmul (_mm256_loadu_ps (x1), vw1), t3 = avx2_cmul (_mm256_loadu_ps (x3), vw1);
+        const __m256 a0 = _mm256_add_ps (v0, t1), a1 = _mm256_sub_ps (v0, t1);
+        const __m256 a2 = _mm256_add_ps (v2, t3), a3 = _mm256_sub_ps (v2, t3);
+        const __m256 u2 = avx2_cmul (a2, _mm256_loadu_ps (w2 + 2 * j));
+        const __m256 u3 = avx2_cmul (a3, _mm256_loadu_ps (w2 + 2 * (j + m)));
+        _mm256_storeu_ps (x0, _mm256_add_ps (a0, u2));
+        _mm256_storeu_ps (x2, _mm256_sub_ps (a0, u2));
+        _mm256_storeu_ps (x1, _mm256_add_ps (a1, u3));
+        _mm256_storeu_ps (x3, _mm256_sub_ps (a1, u3));
+      }
+}
+
+static const FftKernels avx2_kernels = { "AVX2", avx2_radix2, avx2_radix4 };
+#endif // GSL_FFT_X86_KERNELS
+
+// Kernels supported by CPU and OS, widest first
+static std::vector<const FftKernels*>
+supported_fft_kernels ()
+{
+  std::vector<const FftKernels*> kernels;
+#ifdef GSL_FFT_X86_KERNELS
+  if (Bse::cpu_has_features ("AVX2 FMA"))
+    kernels.push_back (&avx2_kernels);
+  kernels.push_back (&sse_kernels);
+#endif
+  kernels.push_back (&fpu_kernels);
+  return kernels;
+}
+
+// Pick the widest kernels supported by CPU and OS, $BSE_FFT_IMPL=FPU forces the default.
+static const FftKernels*
+select_fft_kernels ()
+{
+  const std::vector<const FftKernels*> kernels = supported_fft_kernels();
+  std::vector<const char*> names;
+  for (const FftKernels *k : kernels)
+    names.push_back (k->name);
+  return kernels[Bse::cpu_select_impl ("BSE_FFT_IMPL", names)];
+}
+
+} // Anon
+
+struct _GslFftPlan {
+  uint                  n_values = 0;
+  uint                  log2_n = 0;
+  std::vector<uint32>   bitrev;                 // n_values entries
+  std::vector<float>    twiddles[2];            // analysis and synthesis stage tables, 2 * n_values floats each
+  const FftKernels     *kernels = nullptr;
+};
+
+/* --- complex transforms --- */
+// out[k] = in[bitrev(k)] fused with the first two radix-2 stages which need no multiplications,
+// for in place transforms the bit reversal is carried out beforehand via swaps
+template<bool GATHER> static void
+fft_bitrev_radix4 (const GslFftPlan *plan, uint n, uint shift, const float *in, float *out, bool synthesis)
+{
+  const uint32 *rev = plan->bitrev.data();
+  for (uint k = 0; k < n; k += 4)
+    {
+      const float *x0 = in + 2 * (GATHER ? rev[k + 0] >> shift : k + 0), *x1 = in + 2 * (GATHER ? rev[k + 1] >> shift : k + 1);
+      const float *x2 = in + 2 * (GATHER ? rev[k + 2] >> shift : k + 2), *x3 = in + 2 * (GATHER ? rev[k + 3] >> shift : k + 3);
+      const float s01r = x0[0] + x1[0], s01i = x0[1] + x1[1], d01r = x0[0] - x1[0], d01i = x0[1] - x1[1];
+      const float s23r = x2[0] + x3[0], s23i = x2[1] + x3[1], d23r = x2[0] - x3[0], d23i = x2[1] - x3[1];
+      // d23 * -i for analysis, d23 * +i for synthesis
+      const float tr = synthesis ? -d23i : d23i, ti = synthesis ? d23r : -d23r;
+      float *y = out + 2 * k;
+      y[0] = s01r + s23r;
+      y[1] = s01i + s23i;
+      y[2] = d01r + tr;
+      y[3] = d01i + ti;
+      y[4] = s01r - s23r;
+      y[5] = s01i - s23i;
+      y[6] = d01r - tr;
+      y[7] = d01i - ti;
+    }
+}
+
+// transform n <= plan->n_values complex values out of place, or in place if in == out
+static void
+fft_complex (const GslFftPlan *plan, uint n, const float *in, float *out, bool synthesis)
+{
+  if (n < 4)
+    {
+      if (n == 2)
+        {
+          const float ar = in[0], ai = in[1], br = in[2], bi = in[3];
+          out[0] = ar + br;
+          out[1] = ai + bi;
+          out[2] = ar - br;
+          out[3] = ai - bi;
+        }
+      else if (n == 1 && in != out)
+        {
+          out[0] = in[0];
+          out[1] = in[1];
+        }
+      return;
+    }
+  const uint shift = plan->log2_n - __builtin_ctz (n);
+  if (in == out)        // only used for the real valued synthesis
+    {
+      const uint32 *rev = plan->bitrev.data();
+      for (uint k = 0; k < n; k++)
+        {
+          const uint r = rev[k] >> shift;
+          if (k < r)
+            {
+              std::swap (out[2 * k], out[2 * r]);
+              std::swap (out[2 * k + 1], out[2 * r + 1]);
+            }
+        }
+      fft_bitrev_radix4<false> (plan, n, shift, out, out, synthesis);
+    }
+  else
+    fft_bitrev_radix4<true> (plan, n, shift, in, out, synthesis);
+  const float *tw = plan->twiddles[synthesis].data();
+  uint m = 4;
+  for (; m * 4 <= n; m *= 4)
+    plan->kernels->radix4 (n, out, m, tw + 2 * m, tw + 4 * m);
+  if (m * 2 <= n)
+    plan->kernels->radix2 (n, out, m, tw + 2 * m);
+}
+
+static GslFftPlan* fft_plan_new (uint n_values, const FftKernels *kernels);
+
+GslFftPlan*
+gsl_fft_plan_new (uint n_values)
+{
+  assert_return (n_values >= 2 && (n_values & (n_values - 1)) == 0, NULL);
+  static const FftKernels *const kernels = select_fft_kernels();
+  return fft_plan_new (n_values, kernels);
+}
+
+/// Create a plan like gsl_fft_plan_new() that uses the "FPU", "SSE" or "AVX2" kernels, or NULL if unsupported.
+GslFftPlan*
+gsl_fft_plan_new_impl (uint        n_values,
+                       const char *impl_name)
+{
+  assert_return (n_values >= 2 && (n_values & (n_values - 1)) == 0, NULL);
+  assert_return (impl_name != NULL, NULL);
+  for (const FftKernels *kernels : supported_fft_kernels())
+    if (strcasecmp (kernels->name, impl_name) == 0)
+      return fft_plan_new (n_values, kernels);
+  return NULL;
+}
+
+static GslFftPlan*
+fft_plan_new (uint n_values, const FftKernels *kernels)
+{
+  GslFftPlan *plan = new GslFftPlan();
+  plan->n_values = n_values;
+  plan->log2_n = __builtin_ctz (n_values);
+  plan->kernels = kernels;
+  plan->bitrev.resize (n_values);
+  for (uint i = 0; i < n_values; i++)
+    {
+      uint32 r = 0;
+      for (uint b = 0; b < plan->log2_n; b++)
+        r |= ((i >> b) & 1) << (plan->log2_n - 1 - b);
+      plan->bitrev[i] = r;
+    }
+  for (uint s = 0; s < 2; s++)
+    {
+      std::vector<float> &tw = plan->twiddles[s];
+      tw.resize (2 * n_values);
+      const double esign = s ? +1 : -1;
+      for (uint m = 1; m < n_values; m *= 2)
+        for (uint j = 0; j < m; j++)
+          {
+            // computed in double precision per entry, recurrences would accumulate errors
+            const double theta = esign * PI * j / m;
+            tw[2 * (m + j)] = cos (theta);
+            tw[2 * (m + j) + 1] = sin (theta);
+          }
+    }
+  return plan;
+}
+
+void
+gsl_fft_plan_free (GslFftPlan *plan)
+{
+  delete plan;
+}
+
+uint
+gsl_fft_plan_n_values (const GslFftPlan *plan)
+{
+  assert_return (plan != NULL, 0);
+  return plan->n_values;
+}
+
+const char*
+gsl_fft_plan_impl_name (const GslFftPlan *plan)
+{
+  assert_return (plan != NULL, NULL);
+  return plan->kernels->name;
+}
+
+void
+gsl_fft_plan_fftac (const GslFftPlan *plan,
+                    const float      *ri_values_in,
+                    float            *ri_values_out)
+{
+  assert_return (plan != NULL && ri_values_in != ri_values_out);
+  fft_complex (plan, plan->n_values, ri_values_in, ri_values_out, false);
+}
+
+void
+gsl_fft_plan_fftsc (const GslFftPlan *plan,
+                    const float      *ri_values_in,
+                    float            *ri_values_out)
+{
+  assert_return (plan != NULL && ri_values_in != ri_values_out);
+  fft_complex (plan, plan->n_values, ri_values_in, ri_values_out, true);
+}
+
+void
+gsl_fft_plan_fftsc_scale (const GslFftPlan *plan,
+                          const float      *ri_values_in,
+                          float            *ri_values_out)
+{
+  gsl_fft_plan_fftsc (plan, ri_values_in, ri_values_out);
+  bse_block_scale_floats (2 * plan->n_values, ri_values_out, ri_values_out, 1.0 / plan->n_values);
+}
+
+/* --- real transforms --- */
+/* The real transforms of n values use the complex transform of n/2 values, the
+ * spectra E and O of the even and odd samples are separated and combined via
+ * X[k] = E[k] + W^k O[k], with W = e^(-2*pi*i/n) from the largest stage table.
+ */
+void
+gsl_fft_plan_fftar (const GslFftPlan *plan,
+                    const float      *r_values_in,
+                    float            *ri_values_out)
+{
+  assert_return (plan != NULL && r_values_in != ri_values_out);
+  const uint n = plan->n_values, n2 = n / 2;
+  fft_complex (plan, n2, r_values_in, ri_values_out, false);
+  float *z = ri_values_out;
+  const float *w = plan->twiddles[0].data() + n;        // stage table for half size n/2
+  const float z0r = z[0], z0i = z[1];
+  z[0] = z0r + z0i;     // X[0]
+  z[1] = z0r - z0i;     // X[n/2] is real as well and packed into the imaginary part of X[0]
+  for (uint k = 1; k <= n2 / 2; k++)
+    {
+      float *zk = z + 2 * k, *zn = z + 2 * (n2 - k);
+      const float er = 0.5 * (zk[0] + zn[0]), ei = 0.5 * (zk[1] - zn[1]);
+      const float orr = 0.5 * (zk[1] + zn[1]), oi = -0.5 * (zk[0] - zn[0]);
+      const float wr = w[2 * k], wi = w[2 * k + 1];
+      const float tr = orr * wr - oi * wi, ti = orr * wi + oi * wr;
+      zk[0] = er + tr;
+      zk[1] = ei + ti;
+      zn[0] = er - tr;
+      zn[1] = ti - ei;
+    }
+}
+
+static void
+fft_plan_fftsr (const GslFftPlan *plan,
+                const float      *ri_values_in,
+                float            *r_values_out,
+                float             scale)
+{
+  const uint n = plan->n_values, n2 = n / 2;
+  float *z = r_values_out;
+  const float *w = plan->twiddles[1].data() + n;        // conjugated stage table for half size n/2
+  const float x0 = ri_values_in[0], xn = ri_values_in[1];
+  z[0] = (x0 + xn) * scale;
+  z[1] = (x0 - xn) * scale;
+  for (uint k = 1; k <= n2 / 2; k++)
+    {
+      const float *xk = ri_values_in + 2 * k, *xn = ri_values_in + 2 * (n2 - k);
+      const float er = xk[0] + xn[0], ei = xk[1] - xn[1];
+      const float dr = xk[0] - xn[0], di = xk[1] + xn[1];
+      const float wr = w[2 * k], wi = w[2 * k + 1];
+      const float orr = dr * wr - di * wi, oi = dr * wi + di * wr;
+      // Z[k] = E[k] + i O[k], Z[n/2-k] = conj (E[k]) + i conj (O[k]), both scaled by 2 like gsl_power2_fftsr()
+      z[2 * k] = (er - oi) * scale;
+      z[2 * k + 1] = (ei + orr) * scale;
+      z[2 * (n2 - k)] = (er + oi) * scale;
+      z[2 * (n2 - k) + 1] = (orr - ei) * scale;
+    }
+  fft_complex (plan, n2, z, z, true);
+}
+
+void
+gsl_fft_plan_fftsr (const GslFftPlan *plan,
+                    const float      *ri_values_in,
+                    float            *r_values_out)
+{
+  assert_return (plan != NULL && ri_values_in != r_values_out);
+  fft_plan_fftsr (plan, ri_values_in, r_values_out, 1.0);
+}
+
+void
+gsl_fft_plan_fftsr_scale (const GslFftPlan *plan,
+                          const float      *ri_values_in,
+                          float            *r_values_out)
+{
+  assert_return (plan != NULL && ri_values_in != r_values_out);
+  fft_plan_fftsr (plan, ri_values_in, r_values_out, 1.0 / plan->n_values);
+}
@@ -18,6 +18,7 @@
 /* --- variables --- */
 static std::mutex  fdpool_mutex;
 static GHashTable *hfile_ht = NULL;
+static GHashTable *hwindow_ht = NULL;
 
 /* --- functions --- */
 static guint
@@ -45,6 +46,7 @@ _gsl_init_fd_pool (void)
 {
   assert_return (hfile_ht == NULL);
   hfile_ht = g_hash_table_new (hfile_hash, hfile_equals);
+  hwindow_ht = g_hash_table_new (g_str_hash, g_str_equal);
 }
 static gboolean
 stat_file (const gchar *file_name,
@@ -80,6 +82,18 @@ gsl_hfile_open (const gchar *file_name)
   gint ret_errno;
   errno = EFAULT;
   assert_return (file_name != NULL, NULL);
+  fdpool_mutex.lock();
+  hfile = (GslHFile*) g_hash_table_lookup (hwindow_ht, file_name);
+  if (hfile)
+    {
+      hfile->mutex.lock();
+      hfile->ocount++;
+      hfile->mutex.unlock();
+      fdpool_mutex.unlock();
+      errno = 0;
+      return hfile;
+    }
+  fdpool_mutex.unlock();
   key.file_name = (gchar*) file_name;
   if (!stat_file (file_name, &key.mtime, &key.n_bytes))
     return NULL;	/* errno from stat() */
@@ -118,6 +132,57 @@ gsl_hfile_open (const gchar *file_name)
   errno = ret_errno;
   return hfile;
 }
+/**
+ * @param window_name   unique name under which the window can be opened
+ * @param fd            file descriptor to read from, it is duplicated
+ * @param offset        start of the window within @a fd
+ * @param n_bytes       length of the window
+ * @returns             a new opened GslHFile or NULL if an error occoured (errno set)
+ *
+ * Create a GslHFile that covers a portion of another file, e.g. a
+ * member stored in an archive. While the returned GslHFile is kept open,
+ * gsl_hfile_open() yields the window for @a window_name, so data handles
+ * can read from it by name like from a regular file.
+ * This function is MT-safe and may be called from any thread.
+ */
+GslHFile*
+gsl_hfile_open_window (const gchar *window_name,
+                       gint         fd,
+                       GslLong      offset,
+                       GslLong      n_bytes)
+{
+  struct stat statbuf = { 0, };
+  errno = EFAULT;
+  assert_return (window_name != NULL, NULL);
+  assert_return (offset >= 0 && n_bytes >= 0, NULL);
+  if (fstat (fd, &statbuf) < 0)
+    return NULL;
+  errno = EINVAL;
+  if (offset + n_bytes > statbuf.st_size)
+    return NULL;
+  std::lock_guard<std::mutex> locker (fdpool_mutex);
+  errno = EEXIST;
+  if (g_hash_table_lookup (hwindow_ht, window_name))
+    return NULL;
+  const gint wfd = fcntl (fd, F_DUPFD_CLOEXEC, 0);
+  if (wfd < 0)
+    return NULL;
+  GslHFile *hfile = sfi_new_struct0 (GslHFile, 1);
+  new (&hfile->mutex) std::mutex();
+  hfile->file_name = g_strdup (window_name);
+  hfile->mtime = statbuf.st_mtime;
+  hfile->n_bytes = n_bytes;
+  hfile->cpos = -1;
+  hfile->fd = wfd;
+  hfile->ocount = 1;
+  hfile->zoffset = -2;
+  hfile->base = offset;
+  hfile->is_window = true;
+  g_hash_table_insert (hwindow_ht, hfile->file_name, hfile);
+  errno = 0;
+  return hfile;
+}
+
 /**
  * @param hfile     valid GslHFile
  *
@@ -136,7 +201,7 @@ gsl_hfile_close (GslHFile *hfile)
     hfile->ocount--;
   else
     {
-      if (!g_hash_table_remove (hfile_ht, hfile))
+      if (!g_hash_table_remove (hfile->is_window ? hwindow_ht : hfile_ht, hfile->is_window ? (gpointer) hfile->file_name : hfile))
         Bse::warning ("%s: failed to unlink hashed file (%p)", __func__, hfile);
       else
 	{
@@ -186,7 +251,19 @@ gsl_hfile_pread (GslHFile *hfile,
     }
   assert_return (bytes != NULL, -1);
   hfile->mutex.lock();
-  if (hfile->ocount)
+  if (hfile->ocount && hfile->is_window)
+    {
+      /* a dup()-ed fd shares its file offset with the archive fd and other
+       * windows, so windows use positional reads instead of cpos
+       */
+      if (offset + n_bytes > hfile->n_bytes)
+        n_bytes = hfile->n_bytes - offset;
+      do
+        ret_bytes = pread (hfile->fd, bytes, n_bytes, hfile->base + offset);
+      while (ret_bytes < 0 && errno == EINTR);
+      ret_errno = ret_bytes < 0 ? errno : 0;
+    }
+  else if (hfile->ocount)
     {
       if (hfile->cpos != offset)
 	{
@@ -18,6 +18,8 @@ typedef struct {
   gint     fd;
   guint    ocount;
   GslLong  zoffset;
+  GslLong  base;        /* start of window within fd */
+  guint    is_window : 1;
 } GslHFile;
 typedef struct {
   GslHFile *hfile;
@@ -33,6 +35,10 @@ GslLong	  gsl_hfile_pread	(GslHFile	*hfile,
 				 gpointer	 bytes);
 GslLong	  gsl_hfile_zoffset	(GslHFile	*hfile);
 void	  gsl_hfile_close	(GslHFile	*hfile);
+GslHFile* gsl_hfile_open_window	(const gchar	*window_name,
+				 gint		 fd,
+				 GslLong	 offset,
+				 GslLong	 n_bytes);
 
 
 /* --- GslRFile API --- */
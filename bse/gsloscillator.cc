@@ -2,7 +2,13 @@
 #include "gsloscillator.hh"
 #include "bsemathsignal.hh"
 #include "bse/signalmath.hh"
+#include "bse/platform.hh"
 #include "bse/internal.hh"
+#if defined __x86_64__ || defined __amd64__
+#include <immintrin.h>
+#define GSL_OSC_X86_KERNELS     1
+#define GSL_TARGET_AVX2         __attribute__ ((__target__ ("avx2,fma")))
+#endif
 
 #define	SIGNAL_LEVEL_INVAL	(-2.0)	/* trigger level-changed checks */
 
@@ -63,13 +69,26 @@ osc_update_pwm_offset (GslOscData *osc,
 #define	OSC_FLAG_PWM_MOD	(64)
 #define	OSC_FLAG_PULSE_OSC	(128)
 
-#include "gsloscillator.inc.cc" // oscillator_process_variants<>()
+#include "gsloscillator.inc.cc" // oscillator_process_variants<>(), oscillator_process_avx2<>()
 
 /* --- functions --- */
 using OscillatorProcessFunc = void (*) (GslOscData*, uint, const float*, const float*, const float*, const float*, float*, float*);
 static std::array<OscillatorProcessFunc, 64> osc_process_table;
 static std::array<OscillatorProcessFunc, 128> osc_process_pulse_table;
 
+// Pick the widest kernels supported by CPU and OS, $BSE_OSC_IMPL=FPU forces the scalar variants.
+static const char*
+select_osc_impl ()
+{
+  std::vector<const char*> impls;
+#ifdef GSL_OSC_X86_KERNELS
+  if (Bse::cpu_has_features ("AVX2 FMA"))
+    impls.push_back ("AVX2");
+#endif
+  impls.push_back ("FPU");
+  return impls[Bse::cpu_select_impl ("BSE_OSC_IMPL", impls)];
+}
+
 static bool
 init_osc_process_tables()
 {
@@ -84,6 +103,17 @@ init_osc_process_tables()
       return oscillator_process_variants<CINDEX | OSC_FLAG_PULSE_OSC>;
     });
   osc_process_pulse_table = pulsetable;
+
+#ifdef GSL_OSC_X86_KERNELS
+  /* vectorized variants */
+  if (strcmp (select_osc_impl(), "AVX2") == 0)
+    {
+      osc_process_table[0] = oscillator_process_avx2<0>;
+      osc_process_table[OSC_FLAG_FREQ] = oscillator_process_avx2<OSC_FLAG_FREQ>;
+      osc_process_table[OSC_FLAG_LINEAR_MOD] = oscillator_process_avx2<OSC_FLAG_LINEAR_MOD>;
+      osc_process_table[OSC_FLAG_FREQ | OSC_FLAG_LINEAR_MOD] = oscillator_process_avx2<OSC_FLAG_FREQ | OSC_FLAG_LINEAR_MOD>;
+    }
+#endif
   return true;
 }
 
@@ -202,6 +232,12 @@ gsl_osc_config (GslOscData   *osc,
   osc->last_mode = OSC_FLAG_INVAL;
 }
 
+const char*
+gsl_osc_impl_name (void)
+{
+  return select_osc_impl();
+}
+
 void
 gsl_osc_reset (GslOscData *osc)
 {
@@ -217,3 +253,78 @@ gsl_osc_reset (GslOscData *osc)
   osc->pwm_center = 0;
   osc->last_mode = OSC_FLAG_INVAL;
 }
+
+// == Testing ==
+#include "testing.hh"
+namespace { // Anon
+using namespace Bse;
+
+#ifdef GSL_OSC_X86_KERNELS
+// Render the same input through the scalar and the AVX2 variant of OSC_FLAGS, return the largest deviation.
+template<size_t OSC_FLAGS> static double
+osc_avx2_max_error (GslOscTable *table)
+{
+  constexpr const bool WITH_FREQ = OSC_FLAGS & OSC_FLAG_FREQ;
+  constexpr const bool WITH_LMOD = OSC_FLAGS & OSC_FLAG_LINEAR_MOD;
+  GslOscConfig config = { 0, };
+  config.table = table;
+  config.fm_strength = 0.3;
+  config.cfreq = 330;
+  config.transpose_factor = 1;
+  config.fine_tune = 7;
+  GslOscData fpu, avx2;
+  for (GslOscData *osc : { &fpu, &avx2 })
+    {
+      gsl_osc_reset (osc);
+      gsl_osc_config (osc, &config);
+    }
+  const uint block_sizes[] = { 128, 61, 8, 3, 256 };
+  float freq_in[256], mod_in[256], fpu_out[256], avx2_out[256];
+  double max_error = 0;
+  for (uint b = 0, n = 0; b < 64; b++)
+    {
+      const uint n_values = block_sizes[b % G_N_ELEMENTS (block_sizes)];
+      for (uint i = 0; i < n_values; i++, n++)
+        {
+          // step through all table frequencies, holding each for a few lanes
+          freq_in[i] = BSE_SIGNAL_FROM_FREQ (30 + (n / 37 % 60) * 120);
+          mod_in[i] = sin (n * 0.013);
+        }
+      const float *ifreq = WITH_FREQ ? freq_in : NULL, *imod = WITH_LMOD ? mod_in : NULL;
+      if (b == 0)
+        {
+          // let osc_process() set up the wave and mode of both oscillators alike
+          gsl_osc_process (&fpu, 1, ifreq, imod, NULL, fpu_out, NULL);
+          gsl_osc_process (&avx2, 1, ifreq, imod, NULL, avx2_out, NULL);
+          TASSERT (fpu.last_mode == OSC_FLAGS && avx2.last_mode == OSC_FLAGS);
+        }
+      oscillator_process_variants<OSC_FLAGS> (&fpu, n_values, ifreq, imod, NULL, NULL, fpu_out, NULL);
+      oscillator_process_avx2<OSC_FLAGS> (&avx2, n_values, ifreq, imod, NULL, NULL, avx2_out, NULL);
+      for (uint i = 0; i < n_values; i++)
+        max_error = MAX (max_error, fabs (fpu_out[i] - avx2_out[i]));
+    }
+  return max_error;
+}
+#endif // GSL_OSC_X86_KERNELS
+
+BSE_INTEGRITY_TEST (osc_avx2_variants);
+static void
+osc_avx2_variants()
+{
+#ifdef GSL_OSC_X86_KERNELS
+  if (!cpu_has_features ("AVX2 FMA"))
+    return;
+  // a sine keeps the deviations due to the less precise phase accumulation of linear FM in the scalar variant small
+  const float table_freqs[] = { 27.5, 110, 440, 1760, 7040 };
+  GslOscTable *table = gsl_osc_table_create (48000, GSL_OSC_WAVE_SINE, bse_window_blackman,
+                                             G_N_ELEMENTS (table_freqs), table_freqs);
+  TASSERT (table != NULL);
+  TCMP (osc_avx2_max_error<0> (table), <, 1e-4);
+  TCMP (osc_avx2_max_error<OSC_FLAG_FREQ> (table), <, 1e-4);
+  TCMP (osc_avx2_max_error<OSC_FLAG_LINEAR_MOD> (table), <, 1e-4);
+  TCMP (osc_avx2_max_error<OSC_FLAG_FREQ | OSC_FLAG_LINEAR_MOD> (table), <, 1e-4);
+  gsl_osc_table_free (table);
+#endif
+}
+
+} // Anon
@@ -39,6 +39,7 @@ typedef struct
 void	gsl_osc_config		(GslOscData	*osc,
 				 GslOscConfig	*config);
 void	gsl_osc_reset		(GslOscData	*osc);
+const char* gsl_osc_impl_name	(void);
 void	gsl_osc_process		(GslOscData	*osc,
 				 guint		 n_values,
 				 const gfloat	*ifreq,
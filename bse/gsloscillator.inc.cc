@@ -95,7 +95,6 @@ oscillator_process_variants (GslOscData  *osc,
                       last_pos = flpos / wave->ifrac_to_float;
                       cur_pos = fcpos / wave->ifrac_to_float;
                       sync_pos = osc->config.phase * wave->phase_to_pos;
-                      pos_inc = bse_dtoi (transposed_freq * fine_tune * wave->freq_to_step);
                       if (PULSE_OSC)
                         {
                           osc->last_pwm_level = 0;
@@ -104,8 +103,7 @@ oscillator_process_variants (GslOscData  *osc,
                         }
                     }
                 }
-              else
-                pos_inc = bse_dtoi (transposed_freq * fine_tune * wave->freq_to_step);
+              pos_inc = bse_dtoi (transposed_freq * fine_tune * wave->freq_to_step);
               posm_strength = pos_inc * osc->config.fm_strength;
               self_posm_strength = pos_inc * osc->config.self_fm_strength;
               last_freq_level = freq_level;
@@ -178,6 +176,102 @@ oscillator_process_variants (GslOscData  *osc,
   osc->last_pwm_level = last_pwm_level;
 }
 
+#ifdef GSL_OSC_X86_KERNELS
+/* --- AVX2 variants --- */
+/* Free running and linearly modulated oscillators without syncs, self modulation or pulse
+ * width modulation compute 8 phases per iteration. Linear FM increments are truncated per
+ * sample and accumulated with an integer prefix sum, so phases stay exact modulo 2^32.
+ * Chunks with frequency changes and the block remainder are handed to the scalar variant.
+ */
+static inline GSL_TARGET_AVX2 __m256i
+avx2_prefix_sum_epi32 (__m256i v)
+{
+  v = _mm256_add_epi32 (v, _mm256_slli_si256 (v, 4));
+  v = _mm256_add_epi32 (v, _mm256_slli_si256 (v, 8));
+  // carry the sum of the lower 128 bit lane into the upper lane
+  const __m256i lower = _mm256_permute2x128_si256 (v, v, 0x08);
+  return _mm256_add_epi32 (v, _mm256_shuffle_epi32 (lower, 0xff));
+}
+
+template<size_t OSC_FLAGS> static GSL_TARGET_AVX2 void
+oscillator_process_avx2 (GslOscData  *osc,
+                         uint         n_values,
+                         const float *ifreq,
+                         const float *mod_in,
+                         const float *sync_in,
+                         const float *pwm_in,
+                         float       *mono_out,
+                         float       *sync_out)
+{
+  static_assert ((OSC_FLAGS & ~(OSC_FLAG_FREQ | OSC_FLAG_LINEAR_MOD)) == 0, "unsupported oscillator variant");
+  constexpr const bool WITH_FREQ = OSC_FLAGS & OSC_FLAG_FREQ;
+  constexpr const bool WITH_LMOD = OSC_FLAGS & OSC_FLAG_LINEAR_MOD;
+  constexpr const uint LANES = 8;
+  const double transpose = osc->config.transpose_factor;
+  const double fine_tune = bse_cent_tune_fast (osc->config.fine_tune);
+  const GslOscWave *wave = &osc->wave;
+  uint i = 0;
+
+  while (i < n_values)
+    {
+      /* (re-)load state, the scalar variant may have switched tables */
+      const uint32 pos_inc = bse_dtoi (osc->last_freq_level * transpose * fine_tune * wave->freq_to_step);
+      const __m256 posm_strength = _mm256_set1_ps (pos_inc * osc->config.fm_strength);
+      const __m256 max_fm = _mm256_set1_ps (2147483520.0), min_fm = _mm256_set1_ps (-2147483648.0);
+      const __m256i vpos_inc = _mm256_set1_epi32 (pos_inc);
+      const __m256i lane_incs = _mm256_mullo_epi32 (vpos_inc, _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7));
+      const __m128i frac_shift = _mm_cvtsi32_si128 (wave->n_frac_bits);
+      const __m256i frac_bitmask = _mm256_set1_epi32 (wave->frac_bitmask);
+      const __m256 ifrac_to_float = _mm256_set1_ps (wave->ifrac_to_float);
+      const float *values = wave->values;
+      uint32 cur_pos = osc->cur_pos;
+
+      for (; i + LANES <= n_values; i += LANES)
+        {
+          if (WITH_FREQ)
+            {
+              bool freq_changed = false;
+              for (uint j = 0; j < LANES; j++)
+                freq_changed |= BSE_SIGNAL_FREQ_CHANGED (osc->last_freq_level, BSE_SIGNAL_TO_FREQ (ifreq[i + j]));
+              if (UNLIKELY (freq_changed))
+                break;
+            }
+          __m256i pos;
+          if (WITH_LMOD)
+            {
+              __m256 fm = _mm256_mul_ps (posm_strength, _mm256_loadu_ps (mod_in + i));
+              fm = _mm256_max_ps (_mm256_min_ps (fm, max_fm), min_fm);
+              const __m256i incs = _mm256_add_epi32 (vpos_inc, _mm256_cvttps_epi32 (fm));
+              const __m256i sums = avx2_prefix_sum_epi32 (incs);
+              pos = _mm256_add_epi32 (_mm256_set1_epi32 (cur_pos), _mm256_sub_epi32 (sums, incs));
+              cur_pos += _mm256_extract_epi32 (sums, LANES - 1);
+            }
+          else
+            {
+              pos = _mm256_add_epi32 (_mm256_set1_epi32 (cur_pos), lane_incs);
+              cur_pos += pos_inc * LANES;
+            }
+          /* table read out and linear ipol */
+          const __m256i tpos = _mm256_srl_epi32 (pos, frac_shift);
+          const __m256 ffrac = _mm256_mul_ps (_mm256_cvtepi32_ps (_mm256_and_si256 (pos, frac_bitmask)), ifrac_to_float);
+          const __m256 v = _mm256_i32gather_ps (values, tpos, 4);
+          const __m256 w = _mm256_i32gather_ps (values + 1, tpos, 4);
+          _mm256_storeu_ps (mono_out + i, _mm256_fmadd_ps (_mm256_sub_ps (w, v), ffrac, v));
+        }
+      osc->cur_pos = cur_pos;
+      osc->last_pos = cur_pos;
+
+      if (i < n_values)
+        {
+          const uint n = MIN (LANES, n_values - i);
+          oscillator_process_variants<OSC_FLAGS> (osc, n, WITH_FREQ ? ifreq + i : NULL, WITH_LMOD ? mod_in + i : NULL,
+                                                  NULL, NULL, mono_out + i, NULL);
+          i += n;
+        }
+    }
+}
+#endif // GSL_OSC_X86_KERNELS
+
 #undef ISYNC1_OSYNC0
 #undef ISYNC1_OSYNC1
 #undef ISYNC0_OSYNC1
@@ -3,8 +3,14 @@
 #include "gslcommon.hh"
 #include "bsemath.hh"
 #include "gslfft.hh"
+#include "path.hh"
+#include "randomhash.hh"
 #include "bse/internal.hh"
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 
 #define ODEBUG(...)     Bse::debug ("osc", __VA_ARGS__)
 
@@ -14,6 +20,17 @@
  */
 #define	CACHE_MATCH_FREQ(usr_mfreq, cache_mfreq) \
   (fabs ((cache_mfreq) * 44107 - (usr_mfreq) * 44107) < OSC_FREQ_EPSILON)
+/* flat lookup index, OSC_INDEX_BITS mantissa bits of the float mfreq yield
+ * 2^OSC_INDEX_BITS slots per octave for mfreqs in [2^OSC_INDEX_MIN_EXP..1[
+ */
+#define	OSC_INDEX_BITS		(3)
+#define	OSC_INDEX_MIN_EXP	(-20)
+#define	OSC_INDEX_N_SLOTS	(-OSC_INDEX_MIN_EXP << OSC_INDEX_BITS)
+/* on-disk cache, increment OSC_CACHE_VERSION whenever table generation changes */
+#define	OSC_CACHE_MAGIC		"BseOscT"
+#define	OSC_CACHE_VERSION	(1)
+
+
 /* --- structures --- */
 struct OscTableEntry
 {
@@ -26,15 +43,25 @@ struct OscTableEntry
   guint		 ref_count;
   guint		 min_pos, max_pos;	/* pulse extension */
   guint          n_values;
-  float          values[1];		/* flexible array */
+  const gfloat  *values;		/* n_values + 1 values, mapped from cache file or owned */
+  gpointer       mapping;		/* cache file mapping or NULL */
+  gsize          mapping_size;
+};
+struct OscCacheHeader                   /* cache file layout, followed by n_values + 1 floats */
+{
+  gchar          magic[8];
+  guint32        version;
+  guint32        wave_form;
+  guint64        filter_hash;
+  guint32        mfreq_bits;
+  guint32        n_values;
+  guint32        min_pos, max_pos;
 };
 
 
 /* --- prototypes --- */
 static gint	cache_table_entry_locs_cmp	(gconstpointer	bsearch_node1, /* key */
 						 gconstpointer	bsearch_node2);
-static gint	osc_table_entry_locs_cmp	(gconstpointer	bsearch_node1, /* key */
-						 gconstpointer	bsearch_node2);
 static void	osc_wave_extrema_pos		(guint		n_values,
 						 const gfloat *values,
 						 guint        *minp_p,
@@ -49,11 +76,6 @@ static const GBSearchConfig cache_taconfig = {
   cache_table_entry_locs_cmp,
   0
 };
-static const GBSearchConfig osc_taconfig = {
-  sizeof (OscTableEntry*),
-  osc_table_entry_locs_cmp,
-  0
-};
 
 
 /* --- functions --- */
@@ -77,18 +99,6 @@ cache_table_entry_locs_cmp (gconstpointer bsearch_node1, /* key */
     return e1->wave_form > e2->wave_form ? 1 : -1;
 }
 
-static gint
-osc_table_entry_locs_cmp (gconstpointer bsearch_node1, /* key */
-			  gconstpointer bsearch_node2)
-{
-  const OscTableEntry *const *ep1 = (const OscTableEntry*const*) bsearch_node1;
-  const OscTableEntry *const *ep2 = (const OscTableEntry*const*) bsearch_node2;
-  const OscTableEntry *e1 = *ep1;
-  const OscTableEntry *e2 = *ep2;
-
-  return G_BSEARCH_ARRAY_CMP (e1->mfreq, e2->mfreq);
-}
-
 static OscTableEntry*
 cache_table_entry_lookup_best (GslOscWaveForm wave_form,
 			       guint8*        filter_func,
@@ -156,55 +166,63 @@ cache_table_entry_lookup_best (GslOscWaveForm wave_form,
   return ep2 ? *ep2 : NULL;
 }
 
-static OscTableEntry*
-osc_table_entry_lookup_best (const GslOscTable *table,
-			     gfloat             mfreq,
-			     gfloat	       *min_mfreq)
+static inline guint32
+float_bits (gfloat f)
 {
-  OscTableEntry key, *k = &key, **ep;
-  uint i;
+  guint32 bits;
+  memcpy (&bits, &f, sizeof (bits));
+  return bits;
+}
 
-  /* get exact match or a match which is one off into either direction */
-  key.mfreq = mfreq;
-  ep = (OscTableEntry**) g_bsearch_array_lookup_sibling (table->entry_array, &osc_taconfig, &k);
-  if (UNLIKELY (!ep))
-    return NULL;	/* ugh, bad */
+static inline gfloat
+float_from_bits (guint32 bits)
+{
+  gfloat f;
+  memcpy (&f, &bits, sizeof (f));
+  return f;
+}
 
-  if (mfreq > (*ep)->mfreq)	/* need better filter */
-    {
-      i = g_bsearch_array_get_index (table->entry_array, &osc_taconfig, ep);
-      if (i + 1 < g_bsearch_array_get_n_nodes (table->entry_array))
-	{
-	  ep = (OscTableEntry**) g_bsearch_array_get_nth (table->entry_array, &osc_taconfig, i + 1);
-	  ODEBUG ("osc-lookup: want_freq=%f got_freq=%f (table=%p, i=%u, n=%u)",
-                  mfreq * table->mix_freq, (*ep)->mfreq * table->mix_freq,
-                  table, i + 1, g_bsearch_array_get_n_nodes (table->entry_array));
-	}
-      else	/* bad, might cause aliasing */
-	ODEBUG ("osc-lookup: mismatch, aliasing possible: want_freq=%f got_freq=%f (table=%p, i=%u, n=%u)",
-                mfreq * table->mix_freq, (*ep)->mfreq * table->mix_freq,
-                table, i, g_bsearch_array_get_n_nodes (table->entry_array));
-    }
-  else
-    ODEBUG ("osc-lookup: want_freq=%f got_freq=%f (table=%p, i=%u, n=%u)",
-            mfreq * table->mix_freq, (*ep)->mfreq * table->mix_freq,
-            table, g_bsearch_array_get_index (table->entry_array, &osc_taconfig, ep),
-            g_bsearch_array_get_n_nodes (table->entry_array));
-  if (min_mfreq)
-    {
-      /* fetch mfreq from previous */
-      i = g_bsearch_array_get_index (table->entry_array, &osc_taconfig, ep);
-      if (i > 0)
-	{
-	  OscTableEntry **tp = (OscTableEntry**) g_bsearch_array_get_nth (table->entry_array, &osc_taconfig, i - 1);
+static inline guint
+osc_index_slot (gfloat mfreq)
+{
+  /* the float exponent and upper mantissa bits form a piecewise linear log2() */
+  const gint32 slot = (gint32 (float_bits (mfreq)) - ((127 + OSC_INDEX_MIN_EXP) << 23)) >> (23 - OSC_INDEX_BITS);
+  return CLAMP (slot, 0, OSC_INDEX_N_SLOTS - 1);
+}
 
-	  *min_mfreq = (*tp)->mfreq;
-	}
-      else
-	*min_mfreq = 0;
-    }
+static inline gfloat
+osc_index_slot_mfreq (guint slot)	/* lower bound of slot */
+{
+  return float_from_bits (((127 + OSC_INDEX_MIN_EXP) << 23) + (slot << (23 - OSC_INDEX_BITS)));
+}
 
-  return *ep;
+static inline guint
+osc_table_entry_lookup_best (const GslOscTable *table,
+			     gfloat             mfreq)
+{
+  /* find the first entry with mfreq >= requested mfreq, the index points at
+   * the first entry that satisfies the lower bound of the slot
+   */
+  guint i = table->entry_index[osc_index_slot (mfreq)];
+  while (i + 1 < table->n_entries && table->entries[i]->mfreq < mfreq)
+    i++;
+  return i;
+}
+
+static void
+osc_table_build_index (GslOscTable *table)
+{
+  /* flat frequency index, slot -> first entry which satisfies the lower slot bound */
+  table->entry_index = g_new (guint, OSC_INDEX_N_SLOTS);
+  table->entry_index[0] = 0;	/* also covers all mfreqs below the lower bound */
+  for (guint i = 1; i < OSC_INDEX_N_SLOTS; i++)
+    {
+      const gfloat slot_mfreq = osc_index_slot_mfreq (i);
+      guint e = table->entry_index[i - 1];
+      while (e + 1 < table->n_entries && table->entries[e]->mfreq < slot_mfreq)
+	e++;
+      table->entry_index[i] = e;
+    }
 }
 
 static guint
@@ -229,7 +247,7 @@ wave_table_size (GslOscWaveForm wave_form,
 
 static void
 fft_filter (guint    n_values,
-	    gfloat  *values,	/* [0..n_values], n_values/2 complex values */
+	    gfloat  *values,	/* [0..n_values-1], n_values/2 complex values, packed like gsl_power2_fftar() */
 	    gdouble  scale_window,
 	    double (*window) (double))
 {
@@ -237,7 +255,9 @@ fft_filter (guint    n_values,
 
   n_values >>= 1;
   scale_window /= (gdouble) n_values;
-  for (i = 0; i <= n_values; i++)
+  values[0] *= window (0);
+  values[1] *= window (n_values * scale_window);	/* real valued Nyquist frequency */
+  for (i = 1; i < n_values; i++)
     {
       gdouble w = window (i * scale_window);
       values[i * 2] *= w;
@@ -245,6 +265,112 @@ fft_filter (guint    n_values,
     }
 }
 
+/* --- disk cache --- */
+static guint64
+osc_cache_filter_hash (double (*filter_func) (double))
+{
+  /* function pointers differ between processes, so key cache files by filter response */
+  guint64 hash = 0xcbf29ce484222325;
+  for (guint i = 0; i <= 128; i++)
+    {
+      const gdouble v = filter_func (i / 64.0);
+      hash = Bse::fnv1a_consthash64 ((const guint8*) &v, sizeof (v), hash);
+    }
+  return hash;
+}
+
+static const String&
+osc_cache_dir ()
+{
+  static const String cachedir = [] () {
+    const String dir = Bse::Path::cache_home() + "/beast/osctables";
+    if (Bse::Path::mkdirs (dir, 0700) && Bse::Path::check (dir, "dw"))
+      return dir;
+    ODEBUG ("osc-cache: %s: %s", dir, strerror (errno));
+    return String();
+  } ();
+  return cachedir;
+}
+
+static String
+osc_cache_filename (const OscTableEntry *e,
+		    guint64              filter_hash)
+{
+  const String &dir = osc_cache_dir();
+  if (dir.empty())
+    return "";
+  return Bse::string_format ("%s/%s-%016x-%08x-%u.v%u", dir, gsl_osc_wave_form_name (e->wave_form),
+                             filter_hash, float_bits (e->mfreq), e->n_values, OSC_CACHE_VERSION);
+}
+
+static gboolean
+osc_cache_map_entry (OscTableEntry *e,
+		     guint64        filter_hash,
+		     const String  &filename)
+{
+  const gsize size = sizeof (OscCacheHeader) + sizeof (gfloat) * (e->n_values + 1);
+  const int fd = open (filename.c_str(), O_RDONLY | O_NOCTTY | O_CLOEXEC, 0);
+  if (fd < 0)
+    return FALSE;
+  struct stat sbuf = { 0, };
+  gpointer mem = MAP_FAILED;
+  if (fstat (fd, &sbuf) == 0 && gsize (sbuf.st_size) == size)
+    mem = mmap (NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd); // mmap keeps its own file reference
+  if (mem == MAP_FAILED)
+    return FALSE;
+  const OscCacheHeader *header = (const OscCacheHeader*) mem;
+  if (memcmp (header->magic, OSC_CACHE_MAGIC, sizeof (header->magic)) != 0 ||
+      header->version != OSC_CACHE_VERSION ||
+      header->wave_form != guint32 (e->wave_form) ||
+      header->filter_hash != filter_hash ||
+      header->mfreq_bits != float_bits (e->mfreq) ||
+      header->n_values != e->n_values ||
+      header->min_pos >= e->n_values || header->max_pos >= e->n_values)
+    {
+      ODEBUG ("osc-cache: %s: invalid cache file", filename);
+      munmap (mem, size);
+      return FALSE;
+    }
+  e->min_pos = header->min_pos;
+  e->max_pos = header->max_pos;
+  e->values = (const gfloat*) (header + 1);
+  e->mapping = mem;
+  e->mapping_size = size;
+  return TRUE;
+}
+
+static gboolean
+osc_cache_store_entry (const OscTableEntry *e,
+		       guint64              filter_hash,
+		       const String        &filename)
+{
+  /* write to a temporary first, so concurrent processes only ever map complete files */
+  const String tmpname = Bse::string_format ("%s.%u~", filename, getpid());
+  const int fd = open (tmpname.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return FALSE;
+  OscCacheHeader header = { OSC_CACHE_MAGIC, };
+  header.version = OSC_CACHE_VERSION;
+  header.wave_form = e->wave_form;
+  header.filter_hash = filter_hash;
+  header.mfreq_bits = float_bits (e->mfreq);
+  header.n_values = e->n_values;
+  header.min_pos = e->min_pos;
+  header.max_pos = e->max_pos;
+  const gssize values_size = sizeof (gfloat) * (e->n_values + 1);
+  gboolean ok = write (fd, &header, sizeof (header)) == gssize (sizeof (header));
+  ok = ok && write (fd, e->values, values_size) == values_size;
+  ok = close (fd) == 0 && ok;
+  ok = ok && rename (tmpname.c_str(), filename.c_str()) == 0;
+  if (!ok)
+    {
+      ODEBUG ("osc-cache: %s: %s", filename, strerror (errno));
+      unlink (tmpname.c_str());
+    }
+  return ok;
+}
+
 static OscTableEntry*
 cache_table_ref_entry (GslOscWaveForm wave_form,
 		       double       (*filter_func) (double),
@@ -256,37 +382,50 @@ cache_table_ref_entry (GslOscWaveForm wave_form,
     e = NULL;
   if (!e)
     {
-      guint size = wave_table_size (wave_form, mfreq);
-      gfloat *values, *fft, step, min, max;
-
-      /* size:
-       * - OscTableEntry already contains the first float values
-       * - we need n_values+1 adressable floats to provide values[0] == values[n_values]
-       */
-      e = (OscTableEntry*) g_malloc (sizeof (OscTableEntry) + sizeof (gfloat) * size);
-      values = (gfloat*) &e->values[0];
+      e = g_new0 (OscTableEntry, 1);
       e->wave_form = wave_form;
       e->filter_func = (guint8*) filter_func;
       e->mfreq = mfreq;
       e->ref_count = 1;
-      e->n_values = size;
-      gsl_osc_wave_fill_buffer (e->wave_form, e->n_values, values);
-
-      /* filter wave accordingly */
-      gsl_osc_wave_extrema (e->n_values, values, &min, &max);
-      fft = g_new (gfloat, e->n_values + 2);	/* [0..n_values] for n_values/2 complex freqs */
-      gsl_power2_fftar_simple (e->n_values, values, fft);
-      step = e->mfreq * (gdouble) e->n_values;
-      fft_filter (e->n_values, fft, step, filter_func);
-      gsl_power2_fftsr_scale_simple (e->n_values, fft, values);
-      g_free (fft);
-      gsl_osc_wave_normalize (e->n_values, values, (min + max) / 2, max);
-
-      /* provide values[0]==values[n_values] */
-      values[e->n_values] = values[0];
+      e->n_values = wave_table_size (wave_form, mfreq);
 
-      /* pulse min/max pos extension */
-      osc_wave_extrema_pos (e->n_values, values, &e->min_pos, &e->max_pos);
+      /* map table from disk cache or generate it */
+      const guint64 filter_hash = osc_cache_filter_hash (filter_func);
+      const String filename = osc_cache_filename (e, filter_hash);
+      if (filename.empty() || !osc_cache_map_entry (e, filter_hash, filename))
+	{
+	  gfloat *values, *fft, step, min, max;
+	  GslFftPlan *fft_plan;
+
+	  /* we need n_values+1 adressable floats to provide values[0] == values[n_values] */
+	  values = g_new (gfloat, e->n_values + 1);
+	  gsl_osc_wave_fill_buffer (e->wave_form, e->n_values, values);
+
+	  /* filter wave accordingly */
+	  gsl_osc_wave_extrema (e->n_values, values, &min, &max);
+	  fft_plan = gsl_fft_plan_new (e->n_values);
+	  fft = g_new (gfloat, e->n_values);
+	  gsl_fft_plan_fftar (fft_plan, values, fft);
+	  step = e->mfreq * (gdouble) e->n_values;
+	  fft_filter (e->n_values, fft, step, filter_func);
+	  gsl_fft_plan_fftsr_scale (fft_plan, fft, values);
+	  g_free (fft);
+	  gsl_fft_plan_free (fft_plan);
+	  gsl_osc_wave_normalize (e->n_values, values, (min + max) / 2, max);
+
+	  /* provide values[0]==values[n_values] */
+	  values[e->n_values] = values[0];
+
+	  /* pulse min/max pos extension */
+	  osc_wave_extrema_pos (e->n_values, values, &e->min_pos, &e->max_pos);
+	  e->values = values;
+
+	  /* share pages with other processes via the cache file */
+	  if (!filename.empty() &&
+	      osc_cache_store_entry (e, filter_hash, filename) &&
+	      osc_cache_map_entry (e, filter_hash, filename))
+	    g_free (values);
+	}
 
       /* insert into cache */
       cache_entries = g_bsearch_array_insert (cache_entries, &cache_taconfig, &e);
@@ -307,6 +446,11 @@ cache_table_unref_entry (OscTableEntry *e)
       OscTableEntry **ep = (OscTableEntry**) g_bsearch_array_lookup (cache_entries, &cache_taconfig, &e);
       uint i = g_bsearch_array_get_index (cache_entries, &cache_taconfig, ep);
       cache_entries = g_bsearch_array_remove (cache_entries, &cache_taconfig, i);
+      if (e->mapping)
+	munmap (e->mapping, e->mapping_size);
+      else
+	g_free ((gfloat*) e->values);
+      g_free (e);
     }
 }
 
@@ -331,27 +475,33 @@ gsl_osc_table_create (gfloat         mix_freq,
   table = sfi_new_struct (GslOscTable, 1);
   table->mix_freq = mix_freq;
   table->wave_form = wave_form;
-  table->entry_array = g_bsearch_array_create (&osc_taconfig);
   nyquist = table->mix_freq * 0.5;
   if (wave_form == GSL_OSC_WAVE_PULSE_SAW)
     wave_form = GSL_OSC_WAVE_SAW_FALL;
+  std::vector<OscTableEntry*> entries;	/* sorted by mfreq */
   for (i = 0; i < n_freqs; i++)
     {
-      OscTableEntry *e;
       gdouble mfreq = MIN (nyquist, freqs[i]);
 
       mfreq /= table->mix_freq;
-      e = osc_table_entry_lookup_best (table, mfreq, NULL);
+      auto it = std::lower_bound (entries.begin(), entries.end(), mfreq,
+                                  [] (const OscTableEntry *e, gdouble mf) { return e->mfreq < mf; });
+      OscTableEntry *e = it != entries.end() ? *it : entries.empty() ? NULL : entries.back();
       if (!e || fabs (e->mfreq * table->mix_freq - mfreq * table->mix_freq) > OSC_FREQ_EPSILON)
 	{
 	  e = cache_table_ref_entry (wave_form, filter_func, mfreq);
-	  table->entry_array = g_bsearch_array_insert (table->entry_array, &osc_taconfig, &e);
+	  entries.insert (it, e);
 	}
-      else if (e)
+      else
 	ODEBUG ("not inserting existing entry (freq=%f) for freq %f (nyquist=%f)",
                 e->mfreq * table->mix_freq, mfreq * table->mix_freq, nyquist);
     }
 
+  table->n_entries = entries.size();
+  table->entries = g_new (OscTableEntry*, table->n_entries);
+  std::copy (entries.begin(), entries.end(), table->entries);
+  osc_table_build_index (table);
+
   return table;
 }
 
@@ -360,20 +510,23 @@ gsl_osc_table_lookup (const GslOscTable	*table,
 		      gfloat		 freq,
 		      GslOscWave	*wave)
 {
-  OscTableEntry *e;
-  gfloat mfreq, min_mfreq;
+  gfloat mfreq;
 
   assert_return (table != NULL);
   assert_return (wave != NULL);
 
   mfreq = freq / table->mix_freq;
-  e = osc_table_entry_lookup_best (table, mfreq, &min_mfreq);
-  if (e)
+  if (table->n_entries)
     {
+      const guint i = osc_table_entry_lookup_best (table, mfreq);
+      const OscTableEntry *e = table->entries[i];
       guint32 int_one;
       gfloat float_one;
 
-      wave->min_freq = min_mfreq * table->mix_freq;
+      if (UNLIKELY (mfreq > e->mfreq))	/* bad, might cause aliasing */
+	ODEBUG ("osc-lookup: mismatch, aliasing possible: want_freq=%f got_freq=%f (table=%p, i=%u, n=%u)",
+                mfreq * table->mix_freq, e->mfreq * table->mix_freq, table, i, table->n_entries);
+      wave->min_freq = i > 0 ? table->entries[i - 1]->mfreq * table->mix_freq : 0;
       wave->max_freq = e->mfreq * table->mix_freq;
       wave->n_values = e->n_values;
       wave->values = e->values;
@@ -404,14 +557,11 @@ gsl_osc_table_free (GslOscTable *table)
 
   assert_return (table != NULL);
 
-  n = g_bsearch_array_get_n_nodes (table->entry_array);
+  n = table->n_entries;
   while (n--)
-    {
-      OscTableEntry **ep = (OscTableEntry**) g_bsearch_array_get_nth (table->entry_array, &osc_taconfig, n);
-      cache_table_unref_entry (*ep);
-      table->entry_array = g_bsearch_array_remove (table->entry_array, &osc_taconfig, n);
-    }
-  g_bsearch_array_free (table->entry_array, &osc_taconfig);
+    cache_table_unref_entry (table->entries[n]);
+  g_free (table->entries);
+  g_free (table->entry_index);
   sfi_delete_struct (GslOscTable, table);
 }
 void
@@ -625,3 +775,172 @@ gsl_osc_wave_form_name (GslOscWaveForm wave_form)
     case GSL_OSC_WAVE_NONE:		return "invalid";
     }
 }
+
+// == Testing ==
+#include "testing.hh"
+namespace { // Anon
+using namespace Bse;
+
+static gint
+osc_entry_mfreq_cmp (gconstpointer bsearch_node1, /* key */
+                     gconstpointer bsearch_node2)
+{
+  const OscTableEntry *e1 = *(const OscTableEntry*const*) bsearch_node1;
+  const OscTableEntry *e2 = *(const OscTableEntry*const*) bsearch_node2;
+  return G_BSEARCH_ARRAY_CMP (e1->mfreq, e2->mfreq);
+}
+
+static const GBSearchConfig osc_entry_bconfig = { sizeof (OscTableEntry*), osc_entry_mfreq_cmp, 0 };
+
+// entry lookup by bsearch, as done before the flat index was introduced
+static const OscTableEntry*
+osc_entry_bsearch_best (GBSearchArray *barray,
+                        gfloat         mfreq)
+{
+  OscTableEntry key, *k = &key;
+  key.mfreq = mfreq;
+  OscTableEntry **ep = (OscTableEntry**) g_bsearch_array_lookup_sibling (barray, &osc_entry_bconfig, &k);
+  if (mfreq > (*ep)->mfreq)	/* need better filter */
+    {
+      const uint i = g_bsearch_array_get_index (barray, &osc_entry_bconfig, ep);
+      if (i + 1 < g_bsearch_array_get_n_nodes (barray))
+        ep = (OscTableEntry**) g_bsearch_array_get_nth (barray, &osc_entry_bconfig, i + 1);
+    }
+  return *ep;
+}
+
+BSE_INTEGRITY_TEST (osc_table_flat_index);
+static void
+osc_table_flat_index()
+{
+  for (const uint n_entries : { 1, 2, 9, 40 })
+    {
+      // distinct entry mfreqs across and below the index range
+      std::vector<gfloat> mfreqs;
+      while (mfreqs.size() < n_entries)
+        {
+          const gfloat mfreq = exp2 (random_frange (OSC_INDEX_MIN_EXP - 4, -1));
+          if (std::find (mfreqs.begin(), mfreqs.end(), mfreq) == mfreqs.end())
+            mfreqs.push_back (mfreq);
+        }
+      std::sort (mfreqs.begin(), mfreqs.end());
+      std::vector<OscTableEntry> entries (n_entries);
+      std::vector<OscTableEntry*> entry_ptrs;
+      GBSearchArray *barray = g_bsearch_array_create (&osc_entry_bconfig);
+      for (uint i = 0; i < n_entries; i++)
+        {
+          OscTableEntry *e = &entries[i];
+          e->mfreq = mfreqs[i];
+          entry_ptrs.push_back (e);
+          barray = g_bsearch_array_insert (barray, &osc_entry_bconfig, &e);
+        }
+      GslOscTable table = { 0, };
+      table.n_entries = n_entries;
+      table.entries = entry_ptrs.data();
+      osc_table_build_index (&table);
+      // probe random mfreqs, entry mfreqs, their neighbours and slot boundaries
+      std::vector<gfloat> probes = { 0, 0.5, 1 };
+      for (uint i = 0; i < 2000; i++)
+        probes.push_back (exp2 (random_frange (OSC_INDEX_MIN_EXP - 6, 0)));
+      for (const gfloat mfreq : mfreqs)
+        probes.insert (probes.end(), { mfreq, nextafterf (mfreq, 0), nextafterf (mfreq, 1) });
+      for (uint slot = 0; slot < OSC_INDEX_N_SLOTS; slot++)
+        probes.insert (probes.end(), { osc_index_slot_mfreq (slot), nextafterf (osc_index_slot_mfreq (slot), 0) });
+      for (const gfloat mfreq : probes)
+        {
+          const OscTableEntry *expected = osc_entry_bsearch_best (barray, mfreq);
+          TCMP (osc_table_entry_lookup_best (&table, mfreq), ==, guint (expected - entries.data()));
+        }
+      g_free (table.entry_index);
+      g_bsearch_array_free (barray, &osc_entry_bconfig);
+    }
+}
+
+static double
+osc_test_lowpass (double f)
+{
+  return f < 0.5 ? 1 : 0;
+}
+
+static double
+osc_test_rolloff (double f)
+{
+  return 1 / (1 + f * f);
+}
+
+BSE_INTEGRITY_TEST (osc_table_cache_file);
+static void
+osc_table_cache_file()
+{
+  // filter hashes are stable and tell filters apart
+  TCMP (osc_cache_filter_hash (osc_test_lowpass), ==, osc_cache_filter_hash (osc_test_lowpass));
+  TCMP (osc_cache_filter_hash (osc_test_lowpass), !=, osc_cache_filter_hash (osc_test_rolloff));
+  const guint64 filter_hash = osc_cache_filter_hash (osc_test_lowpass);
+  const String filename = string_format ("%s/bse-osctable-%u.test", g_get_tmp_dir(), getpid());
+  const guint n_values = 64;
+  gfloat values[n_values + 1];
+  for (uint i = 0; i < n_values; i++)
+    values[i] = random_frange (-1, +1);
+  values[n_values] = values[0];
+  OscTableEntry entry = { 0, };
+  entry.mfreq = 0.01;
+  entry.wave_form = GSL_OSC_WAVE_SAW_RISE;
+  entry.n_values = n_values;
+  entry.values = values;
+  osc_wave_extrema_pos (n_values, values, &entry.min_pos, &entry.max_pos);
+  // mapping a stored entry yields the same table
+  TASSERT (osc_cache_store_entry (&entry, filter_hash, filename));
+  OscTableEntry mapped = entry;
+  mapped.values = NULL;
+  mapped.min_pos = mapped.max_pos = 0;
+  TASSERT (osc_cache_map_entry (&mapped, filter_hash, filename));
+  TASSERT (mapped.mapping != NULL);
+  TCMP (mapped.min_pos, ==, entry.min_pos);
+  TCMP (mapped.max_pos, ==, entry.max_pos);
+  TASSERT (memcmp (mapped.values, values, sizeof (values)) == 0);
+  munmap (mapped.mapping, mapped.mapping_size);
+  // files with a different key are rejected
+  auto maps = [&filename] (OscTableEntry e, guint64 hash) {
+    e.values = NULL;
+    e.mapping = NULL;
+    const bool success = osc_cache_map_entry (&e, hash, filename);
+    if (success)
+      munmap (e.mapping, e.mapping_size);
+    return success;
+  };
+  TASSERT (maps (entry, filter_hash));
+  TASSERT (!maps (entry, filter_hash + 1));
+  OscTableEntry foreign = entry;
+  foreign.wave_form = GSL_OSC_WAVE_SQUARE;
+  TASSERT (!maps (foreign, filter_hash));
+  foreign = entry;
+  foreign.mfreq = 0.02;
+  TASSERT (!maps (foreign, filter_hash));
+  foreign = entry;
+  foreign.n_values = 2 * n_values;
+  TASSERT (!maps (foreign, filter_hash));
+  // stale format versions, corrupt headers and truncated files are rejected
+  auto patch = [&filename] (size_t offset, const void *bytes, size_t length) {
+    const int fd = open (filename.c_str(), O_WRONLY | O_CLOEXEC);
+    TASSERT (fd >= 0);
+    TCMP (pwrite (fd, bytes, length, offset), ==, ssize_t (length));
+    TCMP (close (fd), ==, 0);
+  };
+  const guint32 stale_version = OSC_CACHE_VERSION - 1;
+  patch (offsetof (OscCacheHeader, version), &stale_version, sizeof (stale_version));
+  TASSERT (!maps (entry, filter_hash));
+  TASSERT (osc_cache_store_entry (&entry, filter_hash, filename));
+  patch (offsetof (OscCacheHeader, magic), "BseXXXX", 8);
+  TASSERT (!maps (entry, filter_hash));
+  TASSERT (osc_cache_store_entry (&entry, filter_hash, filename));
+  const guint32 bad_pos = n_values;
+  patch (offsetof (OscCacheHeader, max_pos), &bad_pos, sizeof (bad_pos));
+  TASSERT (!maps (entry, filter_hash));
+  TASSERT (osc_cache_store_entry (&entry, filter_hash, filename));
+  TASSERT (maps (entry, filter_hash));
+  TCMP (truncate (filename.c_str(), sizeof (OscCacheHeader) + sizeof (gfloat) * n_values), ==, 0);
+  TASSERT (!maps (entry, filter_hash));
+  unlink (filename.c_str());
+}
+
+} // Anon
@@ -23,9 +23,11 @@ typedef enum    /*< skip >*/
 
 typedef struct
 {
-  gfloat         mix_freq;
-  GslOscWaveForm wave_form;
-  GBSearchArray *entry_array;
+  gfloat                 mix_freq;
+  GslOscWaveForm         wave_form;
+  guint                  n_entries;
+  struct OscTableEntry **entries;	/* sorted by mfreq */
+  guint                 *entry_index;	/* flat log2 (mfreq) slots -> first candidate entry */
 } GslOscTable;
 
 typedef struct
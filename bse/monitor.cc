@@ -4,6 +4,7 @@
 #include "bseserver.hh"
 #include "bseblockutils.hh"
 #include "bse/internal.hh"
+#include <atomic>
 
 namespace Bse {
 
@@ -45,6 +46,13 @@ SignalMonitorImpl::get_shm_offset (MonitorField fld)
   return sb.mem_offset + channel_offset + ptrdiff_t (fld);
 }
 
+int64
+SignalMonitorImpl::get_ring_offset ()
+{
+  SharedBlock sb = source_->cmon_get_ring (ochannel_);
+  return sb.mem_offset;
+}
+
 int64
 SignalMonitorImpl::get_mix_freq ()
 {
@@ -72,6 +80,114 @@ SignalMonitorImpl::get_probe_features ()
   return probe_features_;
 }
 
+// == MonitorRing ==
+static constexpr const uint   monitor_ring_n_slots = 64;
+static constexpr const size_t monitor_ring_slot_stride = BSE_ALIGN (ptrdiff_t (MonitorSlotField::SAMPLES_BYTE) +
+                                                                    BSE_ENGINE_MAX_BLOCK_SIZE * sizeof (float),
+                                                                    FastMemory::cache_line_size);
+static constexpr const size_t monitor_ring_size = ptrdiff_t (MonitorRingField::SLOT0_BYTE) +
+                                                  monitor_ring_n_slots * monitor_ring_slot_stride;
+
+template<class E> static inline std::atomic<double>&
+ring_f64 (const char *mem, E field)
+{
+  static_assert (sizeof (std::atomic<double>) == sizeof (double), "");
+  return *(std::atomic<double>*) (mem + ptrdiff_t (field));
+}
+
+template<class T, class E> static inline T&
+ring_field (char *mem, E field)
+{
+  return *(T*) (mem + ptrdiff_t (field));
+}
+
+template<class T, class E> static inline T
+ring_field (const char *mem, E field)
+{
+  return *(const T*) (mem + ptrdiff_t (field));
+}
+
+static void
+monitor_ring_init (char *ring, uint mix_freq)
+{
+  memset (ring, 0, monitor_ring_size);
+  ring_field<int32> (ring, MonitorRingField::I32_N_SLOTS) = monitor_ring_n_slots;
+  ring_field<int32> (ring, MonitorRingField::I32_SLOT_STRIDE) = monitor_ring_slot_stride;
+  ring_field<int32> (ring, MonitorRingField::I32_MAX_FRAMES) = BSE_ENGINE_MAX_BLOCK_SIZE;
+  ring_field<int32> (ring, MonitorRingField::I32_MIX_FREQ) = mix_freq;
+}
+
+/* Single writer, seqlock style: BEGIN announces the slot about to be clobbered before any
+ * sample is touched, END publishes the block once complete. Readers validate their copies
+ * against BEGIN afterwards, so the writer never waits and keeps no per-reader state.
+ */
+static void
+monitor_ring_write (char *ring, uint64 frame, uint n_frames, const float *samples, float peak, float rms)
+{
+  assert_return (n_frames <= BSE_ENGINE_MAX_BLOCK_SIZE);
+  const uint64 n = ring_f64 (ring, MonitorRingField::F64_BLOCK_END).load (std::memory_order_relaxed);
+  ring_f64 (ring, MonitorRingField::F64_BLOCK_BEGIN).store (n + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence (std::memory_order_release);
+  char *slot = ring + ptrdiff_t (MonitorRingField::SLOT0_BYTE) + (n % monitor_ring_n_slots) * monitor_ring_slot_stride;
+  ring_field<double> (slot, MonitorSlotField::F64_FRAME) = frame;
+  ring_field<int32> (slot, MonitorSlotField::I32_N_FRAMES) = n_frames;
+  ring_field<float> (slot, MonitorSlotField::F32_PEAK) = peak;
+  ring_field<float> (slot, MonitorSlotField::F32_RMS) = rms;
+  memcpy (slot + ptrdiff_t (MonitorSlotField::SAMPLES_BYTE), samples, n_frames * sizeof (float));
+  ring_f64 (ring, MonitorRingField::F64_BLOCK_END).store (n + 1, std::memory_order_release);
+}
+
+MonitorRingReader::MonitorRingReader (const char *ring)
+{
+  attach (ring);
+}
+
+void
+MonitorRingReader::attach (const char *ring)
+{
+  ring_ = ring;
+  lost_ = 0;
+  next_ = ring_ ? ring_f64 (ring_, MonitorRingField::F64_BLOCK_END).load (std::memory_order_acquire) : 0;
+}
+
+uint
+MonitorRingReader::read (Block *blocks, uint max_blocks)
+{
+  return_unless (ring_ != nullptr, 0);
+  const uint64 n_slots = ring_field<int32> (ring_, MonitorRingField::I32_N_SLOTS);
+  const size_t slot_stride = ring_field<int32> (ring_, MonitorRingField::I32_SLOT_STRIDE);
+  const uint64 end = ring_f64 (ring_, MonitorRingField::F64_BLOCK_END).load (std::memory_order_acquire);
+  if (next_ + n_slots < end)                    // reader fell behind by more than the ring size
+    {
+      lost_ += end - n_slots - next_;
+      next_ = end - n_slots;
+    }
+  uint n = 0;
+  for (uint64 b = next_; b < end && n < max_blocks; b++, n++)
+    {
+      const char *slot = ring_ + ptrdiff_t (MonitorRingField::SLOT0_BYTE) + (b % n_slots) * slot_stride;
+      Block &block = blocks[n];
+      block.frame = ring_field<double> (slot, MonitorSlotField::F64_FRAME);
+      block.n_frames = std::min (uint (ring_field<int32> (slot, MonitorSlotField::I32_N_FRAMES)), uint (BSE_ENGINE_MAX_BLOCK_SIZE));
+      block.peak = ring_field<float> (slot, MonitorSlotField::F32_PEAK);
+      block.rms = ring_field<float> (slot, MonitorSlotField::F32_RMS);
+      memcpy (block.samples, slot + ptrdiff_t (MonitorSlotField::SAMPLES_BYTE), block.n_frames * sizeof (float));
+    }
+  // discard copies of slots that the writer started to overwrite in the meantime
+  std::atomic_thread_fence (std::memory_order_acquire);
+  const uint64 begin = ring_f64 (ring_, MonitorRingField::F64_BLOCK_BEGIN).load (std::memory_order_relaxed);
+  const uint64 first_valid = begin > n_slots ? begin - n_slots : 0;
+  const uint clobbered = first_valid > next_ ? std::min (first_valid - next_, uint64 (n)) : 0;
+  if (clobbered)
+    {
+      std::move (blocks + clobbered, blocks + n, blocks);
+      n -= clobbered;
+      lost_ += clobbered;
+    }
+  next_ += clobbered + n;
+  return n;
+}
+
 // == SourceImpl ==
 struct SourceImpl::ChannelMonitor {
   uint           probe_range = 0;
@@ -79,6 +195,7 @@ struct SourceImpl::ChannelMonitor {
   uint           probe_samples = 0;
   uint           probe_fft = 0;
   MonitorModule *module = NULL;
+  SharedBlock    ring;
   bool           needs_module ()  { return probe_range || probe_energy || probe_samples || probe_fft; }
   /*des*/       ~ChannelMonitor()
   {
@@ -118,11 +235,32 @@ SourceImpl::cmon_monitor_field_start (uint ochannel)
   return mfields + aligned_sizeof_MonitorFields * ochannel;
 }
 
+SharedBlock
+SourceImpl::cmon_get_ring (uint ochannel)
+{
+  assert_return (ochannel < size_t (n_ochannels()), SharedBlock());
+  ChannelMonitor &cmon = cmon_get (ochannel);
+  if (!cmon.ring.mem_length)
+    {
+      cmon.ring = BSE_SERVER.allocate_shared_block (monitor_ring_size);
+      monitor_ring_init ((char*) cmon.ring.mem_start, bse_engine_sample_freq());
+    }
+  return cmon.ring;
+}
+
 void
 SourceImpl::cmon_delete ()
 {
   if (cmons_)
     {
+      const uint noc = n_ochannels();
+      for (size_t i = 0; i < noc; i++)
+        if (cmons_[i].ring.mem_length)
+          {
+            const SharedBlock sb = cmons_[i].ring;
+            cmons_[i].ring = SharedBlock();
+            BSE_SERVER.release_shared_block (sb);
+          }
       delete[] cmons_;
       cmons_ = NULL;
     }
@@ -169,6 +307,8 @@ SourceImpl::cmon_sub_probe (uint ochannel, const ProbeFeatures &pf)
     {
       // kill module
     }
+  else if (cmon.module)
+    cmon_activate();    // reconfigure remaining probes
 }
 
 SignalMonitorIfaceP
@@ -208,7 +348,9 @@ static const BseModuleClass monitor_module_class = {
 
 class MonitorModule : public Bse::Module {
   float          *fblock_ = NULL;
+  char           *ring_ = NULL;
   int64 counter_ = 0;
+  uint64 frame_ = 0;
   float db_tip_ = MIN_DB_SPL;
   union {
     char  *char8_;
@@ -234,11 +376,11 @@ public:
   reset () override
   {}
   void
-  configure (bool probe_range, bool probe_energy, bool probe_samples, bool probe_fft) // EngineThread
+  configure (bool probe_range, bool probe_energy, char *ring, bool probe_fft) // EngineThread
   {
     need_minmax_ = probe_range;
     need_dbspl_ = probe_energy;
-    // TODO: probe_samples
+    ring_ = ring;
     // TODO: probe_fft
   }
   inline float
@@ -252,6 +394,24 @@ public:
       return bse_block_calc_float_square_sum (n_values, ivalues);
     return 0;
   }
+  void
+  write_ring (uint n_values, const BseJStream &jstream) // EngineThread
+  {
+    const float *samples = fblock_;
+    if (jstream.n_connections == 1)
+      samples = jstream.values[0];
+    else if (jstream.n_connections > 1)
+      {
+        bse_block_copy_float (n_values, fblock_, jstream.values[0]);
+        for (int j = 1; j < int (jstream.n_connections); j++)
+          bse_block_add_floats (n_values, fblock_, jstream.values[j]);
+      }
+    else
+      bse_block_fill_float (n_values, fblock_, 0);
+    float vmin = 0, vmax = 0;
+    const float sqsum = bse_block_calc_float_range_and_square_sum (n_values, samples, &vmin, &vmax);
+    monitor_ring_write (ring_, frame_, n_values, samples, MAX (-vmin, vmax), sqrt (sqsum / n_values));
+  }
   virtual void
   process (uint n_values) override // EngineThread
   {
@@ -287,6 +447,9 @@ public:
     f32 (MonitorField::F32_DB_TIP) = db_tip_;
     counter_ += 1;
     f64 (MonitorField::F64_GENERATION) = counter_;
+    if (ring_)
+      write_ring (n_values, jstream);
+    frame_ += n_values;
     if (0)
       Bse::printout ("Monitor(%p): counter=%x [%+1.5f, %+1.5f] %+.2f (%+.2f) nj=%d nv=%d\n",
                      char8_, counter_, vmin, vmax, db_spl, db_tip_,
@@ -321,8 +484,9 @@ SourceImpl::cmon_activate ()
         f.probe_samples = cmons_[i].probe_samples > 0;
         f.probe_fft = cmons_[i].probe_fft > 0;
         MonitorModule *monitor_module = cmons_[i].module;
-        auto monitor_module_configure = [monitor_module, f] () {
-          monitor_module->configure (f.probe_range, f.probe_energy, f.probe_samples, f.probe_fft);
+        char *ring = f.probe_samples ? (char*) cmon_get_ring (i).mem_start : NULL;
+        auto monitor_module_configure = [monitor_module, f, ring] () {
+          monitor_module->configure (f.probe_range, f.probe_energy, ring, f.probe_fft);
         };
         bse_trans_add (trans, bse_job_access (cmons_[i].module, monitor_module_configure));
       }
@@ -363,3 +527,47 @@ SourceImpl::cmon_deactivate ()
 }
 
 } // Bse
+
+// == Testing ==
+#include "testing.hh"
+namespace { // Anon
+using namespace Bse;
+
+BSE_INTEGRITY_TEST (bse_monitor_ring_test);
+static void
+bse_monitor_ring_test()
+{
+  std::vector<double> mem (monitor_ring_size / sizeof (double) + 1);
+  char *ring = (char*) mem.data();
+  monitor_ring_init (ring, 48000);
+  MonitorRingReader reader1 (ring), reader2 (ring);
+  std::unique_ptr<MonitorRingReader::Block[]> blocks (new MonitorRingReader::Block[monitor_ring_n_slots]);
+  float samples[BSE_ENGINE_MAX_BLOCK_SIZE];
+  uint64 frame = 0;
+  auto write_blocks = [&] (uint n) {
+    for (uint i = 0; i < n; i++)
+      {
+        for (uint j = 0; j < BSE_ENGINE_MAX_BLOCK_SIZE; j++)
+          samples[j] = (frame + j) & 0xff;
+        monitor_ring_write (ring, frame, BSE_ENGINE_MAX_BLOCK_SIZE, samples, 255, 1);
+        frame += BSE_ENGINE_MAX_BLOCK_SIZE;
+      }
+  };
+  TASSERT (reader1.read (blocks.get(), monitor_ring_n_slots) == 0);
+  write_blocks (5);
+  uint n = reader1.read (blocks.get(), 3);
+  TASSERT (n == 3 && blocks[0].frame == 0 && blocks[2].frame == 2 * BSE_ENGINE_MAX_BLOCK_SIZE);
+  TASSERT (blocks[1].n_frames == BSE_ENGINE_MAX_BLOCK_SIZE && blocks[1].samples[7] == ((BSE_ENGINE_MAX_BLOCK_SIZE + 7) & 0xff));
+  n = reader1.read (blocks.get(), monitor_ring_n_slots);
+  TASSERT (n == 2 && blocks[1].frame == 4 * BSE_ENGINE_MAX_BLOCK_SIZE && blocks[1].peak == 255);
+  // reader2 is overrun and only sees the most recent blocks
+  write_blocks (monitor_ring_n_slots);
+  n = reader1.read (blocks.get(), monitor_ring_n_slots);
+  TASSERT (n == monitor_ring_n_slots && reader1.lost() == 0);
+  n = reader2.read (blocks.get(), monitor_ring_n_slots);
+  TASSERT (n == monitor_ring_n_slots && reader2.lost() == 5);
+  TASSERT (blocks[n - 1].frame + BSE_ENGINE_MAX_BLOCK_SIZE == frame);
+  TASSERT (blocks[0].samples[0] == (blocks[0].frame & 0xff));
+}
+
+} // Anon
@@ -5,6 +5,7 @@
 #include <bse/bseutils.hh>
 #include <bse/object.hh>
 #include <bse/bsesource.hh>
+#include <bse/bseengine.hh>
 
 namespace Bse {
 
@@ -19,6 +20,7 @@ public:
   explicit               SignalMonitorImpl  (SourceImplP source, uint ochannel);
   virtual SourceIfaceP   get_osource        () override;
   virtual int64          get_shm_offset     (MonitorField fld) override;
+  virtual int64          get_ring_offset    () override;
   virtual int32          get_ochannel       () override;
   virtual int64          get_mix_freq       () override;
   virtual int64          get_frame_duration () override;
@@ -27,6 +29,29 @@ public:
 };
 typedef std::shared_ptr<SignalMonitorImpl> SignalMonitorImplP;
 
+/** Lock-free reader for the sample ring of a SignalMonitor.
+ * The ring is written by the engine thread only and carries no reader state, so any number
+ * of readers (threads or processes mapping the SharedMemory area) may poll it concurrently.
+ * Blocks that were overwritten before a reader could copy them are skipped and counted.
+ */
+class MonitorRingReader {
+  const char            *ring_ = nullptr;
+  uint64                 next_ = 0;
+  uint64                 lost_ = 0;
+public:
+  struct Block {
+    uint64               frame = 0;             ///< Stream position of the first frame.
+    uint                 n_frames = 0;          ///< Number of valid frames in `samples`.
+    float                peak = 0;              ///< Maximum absolute sample value.
+    float                rms = 0;               ///< Root mean square of the samples.
+    float                samples[BSE_ENGINE_MAX_BLOCK_SIZE];
+  };
+  explicit               MonitorRingReader  (const char *ring = nullptr);
+  void                   attach             (const char *ring);   ///< Start reading at the most recent block of `ring`.
+  uint                   read               (Block *blocks, uint max_blocks); ///< Copy up to `max_blocks` new blocks.
+  uint64                 lost               () const    { return lost_; } ///< Number of blocks missed so far.
+};
+
 } // Bse
 
 #endif // __BSE_SIGNAL_MONITOR_HH__
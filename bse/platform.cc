@@ -279,6 +279,7 @@ struct CPUInfo {
   uint x86_mmx : 1, x86_mmxext : 1, x86_3dnow : 1, x86_3dnowext : 1;
   uint x86_sse : 1, x86_sse2   : 1, x86_sse3  : 1, x86_ssse3    : 1;
   uint x86_cx16 : 1, x86_sse4_1 : 1, x86_sse4_2 : 1, x86_rdrand : 1;
+  uint x86_fma : 1, x86_avx    : 1, x86_avx2  : 1, x86_avx512f  : 1;
 };
 
 static jmp_buf cpu_info_jmp_buf;
@@ -344,6 +345,13 @@ cpu_info_sigill_handler (int dummy)
 #  define x86_has_cpuid()                       (false)
 #  define x86_cpuid(input, count, eax, ebx, ecx, edx)  do {} while (0)
 #endif
+#if     defined __i386__ || defined __x86_64__ || defined __amd64__
+/* read XCR0 to find the register states saved by the OS, requires OSXSAVE */
+#  define x86_xgetbv0(eax, edx) \
+  __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0))
+#else
+#  define x86_xgetbv0(eax, edx)                 do {} while (0)
+#endif
 
 static bool
 get_x86_cpu_features (CPUInfo *ci)
@@ -356,7 +364,8 @@ get_x86_cpu_features (CPUInfo *ci)
   /* query intel CPUID range */
   unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
   x86_cpuid (0, 0, eax, ebx, ecx, edx);
-  unsigned int v_ebx = ebx, v_ecx = ecx, v_edx = edx;
+  unsigned int v_ebx = ebx, v_ecx = ecx, v_edx = edx, max_leaf = eax;
+  bool avx_os = false, avx512_os = false;
   char *vendor = ci->cpu_vendor;
   *((unsigned int*) &vendor[0]) = ebx;
   *((unsigned int*) &vendor[4]) = edx;
@@ -377,6 +386,18 @@ get_x86_cpu_features (CPUInfo *ci)
         ci->x86_sse4_2 = true;
       if (ecx & (1 << 30))
         ci->x86_rdrand = true;
+      if (ecx & (1 << 27))      /* OSXSAVE, AVX registers are only usable if the OS saves them */
+        {
+          unsigned int xcr0 = 0, xcr0_hi = 0;
+          x86_xgetbv0 (xcr0, xcr0_hi);
+          avx_os = (xcr0 & 0x06) == 0x06;               /* XMM and YMM state */
+          avx512_os = avx_os && (xcr0 & 0xe0) == 0xe0;  /* opmask and ZMM state */
+          (void) xcr0_hi;
+        }
+      if (avx_os && (ecx & (1 << 28)))
+        ci->x86_avx = true;
+      if (ci->x86_avx && (ecx & (1 << 12)))
+        ci->x86_fma = true;
       if (edx & (1 << 0))
         ci->x86_fpu = true;
       if (edx & (1 << 4))
@@ -396,6 +417,14 @@ get_x86_cpu_features (CPUInfo *ci)
        * "Intel Processor Identification and the CPUID Instruction"
        */
     }
+  if (max_leaf >= 7 && ci->x86_avx)    /* may query structured extended feature flags */
+    {
+      x86_cpuid (7, 0, eax, ebx, ecx, edx);
+      if (ebx & (1 << 5))
+        ci->x86_avx2 = true;
+      if (avx512_os && (ebx & (1 << 16)))
+        ci->x86_avx512f = true;
+    }
 
   /* query extended CPUID range */
   x86_cpuid (0x80000000, 0, eax, ebx, ecx, edx);
@@ -454,7 +483,7 @@ cpu_arch ()
  * a number of flag words describing CPU features plus a trailing space.
  * This allows checks for CPU features via a simple string search for
  * " FEATURE ".
- * @return Example: "4 AMD64 GenuineIntel FPU TSC HTT CMPXCHG16B MMX MMXEXT SSESYS SSE SSE2 SSE3 SSSE3 SSE4.1 SSE4.2 "
+ * @return Example: "4 AMD64 GenuineIntel FPU TSC HTT CMPXCHG16B MMX MMXEXT SSESYS SSE SSE2 SSE3 SSSE3 SSE4.1 SSE4.2 AVX FMA AVX2 "
  */
 String
 cpu_info()
@@ -502,6 +531,15 @@ cpu_info()
       info += " SSE4.2";
     if (cpu_info.x86_rdrand)
       info += " rdrand";
+    // AVX flags
+    if (cpu_info.x86_avx)
+      info += " AVX";
+    if (cpu_info.x86_fma)
+      info += " FMA";
+    if (cpu_info.x86_avx2)
+      info += " AVX2";
+    if (cpu_info.x86_avx512f)
+      info += " AVX512F";
     // 3DNOW flags
     if (cpu_info.x86_3dnow)
       info += " 3DNOW";
@@ -513,6 +551,37 @@ cpu_info()
   return cpu_info_string;
 }
 
+/// Check that all space separated feature words, e.g. "AVX2 FMA", are listed by cpu_info().
+bool
+cpu_has_features (const String &features)
+{
+  const String cinfo = cpu_info();
+  for (const String &feature : string_split (features, " "))
+    if (!feature.empty() && cinfo.find (" " + feature + " ") == cinfo.npos)
+      return false;
+  return true;
+}
+
+/** Pick one of several kernel implementations for the runtime CPU.
+ * The @a impl_names are ordered by preference and only list implementations supported
+ * by CPU and OS, the last entry is the portable fallback. Unless the environment variable
+ * @a envvar requests an implementation by name (case insensitive), the first one is used,
+ * unknown names select the fallback.
+ * @return Index into @a impl_names.
+ */
+size_t
+cpu_select_impl (const char *envvar, const std::vector<const char*> &impl_names)
+{
+  assert_return (!impl_names.empty(), 0);
+  const char *const env = getenv (envvar);
+  if (!env)
+    return 0;
+  for (size_t i = 0; i < impl_names.size(); i++)
+    if (strcasecmp (env, impl_names[i]) == 0)
+      return i;
+  return impl_names.size() - 1;
+}
+
 // == Timestamps ==
 static clockid_t monotonic_clockid = CLOCK_REALTIME;
 static uint64    monotonic_start = 0;
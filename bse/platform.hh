@@ -72,6 +72,8 @@ String      program_cwd           ();                   ///< The current working
 std::string executable_name       () BSE_PURE;          ///< Retrieve the name part of executable_path().
 std::string executable_path       () BSE_PURE;          ///< Retrieve the path to the currently running executable.
 std::string cpu_info              ();                   ///< Retrieve string identifying the runtime CPU type.
+bool        cpu_has_features      (const String &features); ///< Check cpu_info() for all listed CPU features.
+size_t      cpu_select_impl       (const char *envvar, const std::vector<const char*> &impl_names); ///< Index of the kernels to use, $envvar may override.
 std::string cpu_arch              ();                   ///< Retrieve string identifying the CPU architecture.
 std::string version               ();                   ///< Provide a string containing the BSE library build.
 
@@ -1,10 +1,19 @@
 // Licensed GNU LGPL v2.1 or later: http://www.gnu.org/licenses/lgpl.html
 #include "processor.hh"
 #include "bse/bseserver.hh"
+#include "bse/profiler.hh"
 #include "bse/internal.hh"
 #include <shared_mutex>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <limits.h>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
 #define PDEBUG(...)     Bse::debug ("processor", __VA_ARGS__)
+#define SCHED_DEBUG(...) Bse::debug ("sched", __VA_ARGS__)
 
 // == Helpers ==
 static std::string
@@ -24,6 +33,19 @@ namespace Bse {
  */
 namespace AudioSignal {
 
+static inline void
+render_futex_wait (std::atomic<int> &word, int value)
+{
+  static_assert (sizeof (word) == sizeof (int), "");
+  syscall (SYS_futex, &word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+static inline void
+render_futex_wake (std::atomic<int> &word)
+{
+  syscall (SYS_futex, &word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
 // == SpeakerArrangement ==
 // Count the number of channels described by the SpeakerArrangement.
 uint8
@@ -370,19 +392,244 @@ Processor::OBus::OBus (const std::string &identifier, const std::string &uilabel
 // == Engine ==
 enum {
   RESCHEDULE = 1,
+  REGRAPH = 2,
+};
+static constexpr size_t COMMAND_RING_SIZE = 1024;
+
+/* The RenderGraph reflects Engine.schedule_ as a dependency DAG, each task is a Processor
+ * with a `pending` counter of unrendered dependencies. Tasks without dependencies are
+ * seeded into the work-stealing deque of the rendering thread, helper threads steal from
+ * there and every thread pushes the tasks it readies into its own deque.
+ * The helper threads and deques are set up with the Engine, so rendering a block neither
+ * allocates nor blocks. The deques are drained by the end of each block and their indices
+ * keep growing across blocks, so a helper that is late to leave a block cannot take a task
+ * of the next one by mistake, the rendering thread never waits for helpers to go idle.
+ * Edges are kept with multiplicity (one per connection), so single connections can be
+ * added or removed without rebuilding the graph.
+ */
+struct Engine::RenderGraph {
+  struct Task {
+    Processor        *proc = nullptr;
+    uint              n_inputs = 0;
+    std::vector<uint> outputs;          // dependant task indices
+    std::atomic<uint> pending { 0 };
+  };
+  struct Edge {
+    Processor *dep = nullptr, *proc = nullptr;
+    bool       connected = false;
+  };
+  std::vector<Edge>         edges;              // edges from enqueue() or pending connection changes
+  bool                      stale = false;      // edges of a destroyed processor were dropped, rebuild
+  std::unique_ptr<Task[]>   tasks;              // kept across schedules, like the child lists
+  uint                      n_tasks = 0, tasks_capacity = 0;
+  uint                      max_width = 0;      // maximum number of tasks per dependency level
+  std::vector<WorkStealingDeque<uint>> deques;
+  uint                      deque_capacity = 0;
+  alignas (64) std::atomic<uint> n_pending { 0 };
+  alignas (64) std::atomic<uint> n_busy { 0 };
+  alignas (64) std::atomic<int> block_stamp { 0 };     // futex, changes with every block
+  std::atomic<bool>         active { false };
+  std::atomic<bool>         quit { false };
+  std::vector<std::thread>  threads;
+  // contiguous FloatBuffer memory for all scheduled outputs
+  static constexpr size_t   ARENA_SIZE = 2 * 1024 * 1024;       // one huge page, 4096 blocks
+  struct BufferPool {
+    FastMemory::Block       block;
+    float                  *mem = nullptr;
+  };
+  std::unique_ptr<FastMemory::Arena> arena;
+  BufferPool                pool;
+  size_t                    pool_blocks = 0;
+  std::vector<bool>         aliased;            // blocks shared by several outputs
+  // layout_buffers() scratch space, kept to avoid allocations when rescheduling
+  struct Reusable { uint block, owner; };
+  std::vector<bool>         readable, is_root;
+  std::vector<uint64>       ancestors;
+  std::vector<Reusable>     reusable;
+  std::vector<uint>         n_owners, assignment;
+  static constexpr uint     MAX_ALIAS_TASKS = 4096; // bounds the quadratic ancestor matrix
+  void
+  release_pool ()
+  {
+    if (pool.block.block_start)
+      arena->release (pool.block);
+    else if (pool.mem)
+      fast_mem_free (pool.mem);
+    pool = BufferPool();
+  }
+  static uint
+  n_helpers ()
+  {
+    static const uint n_cpus = std::max (1, this_thread_online_cpus());
+    return std::min (n_cpus, 16u) - 1;          // the rendering thread is worker 0
+  }
+  void
+  setup (const std::vector<Processor*> &schedule)
+  {
+    n_tasks = schedule.size();
+    if (n_tasks > tasks_capacity)
+      {
+        tasks_capacity = std::max (n_tasks, 2 * tasks_capacity);
+        tasks.reset (new Task[tasks_capacity]);
+      }
+    if (n_tasks > deque_capacity)
+      {
+        // only grown while rescheduling, helpers leave a finished block within a few instructions
+        while (n_busy.load() > 0)
+          std::this_thread::yield();
+        deque_capacity = std::max (n_tasks, 2 * deque_capacity);
+        for (auto &deque : deques)
+          deque.reset (deque_capacity);
+      }
+    // size all child lists up front, so reschedules of similar graphs don't allocate
+    for (uint i = 0; i < n_tasks; i++)
+      tasks[i].n_inputs = 0;
+    for (const Edge &e : edges)
+      tasks[e.dep->schedule_index_].n_inputs += 1;      // counts outputs until assigned below
+    for (uint i = 0; i < n_tasks; i++)
+      {
+        Task &task = tasks[i];
+        task.proc = schedule[i];
+        task.outputs.clear();
+        task.outputs.reserve (task.n_inputs);
+        task.n_inputs = 0;
+      }
+    // schedule_ is in depth-first order, so dependencies always precede their dependants
+    for (const Edge &e : edges)
+      add_edge (e.dep->schedule_index_, e.proc->schedule_index_);
+    edges.clear();
+    levelize();
+  }
+  void
+  add_edge (uint d, uint p)
+  {
+    tasks[d].outputs.push_back (p);
+    tasks[p].n_inputs += 1;
+  }
+  bool
+  remove_edge (uint d, uint p)
+  {
+    auto it = std::find (tasks[d].outputs.begin(), tasks[d].outputs.end(), p);
+    return_unless (it != tasks[d].outputs.end(), false);
+    tasks[d].outputs.erase (it);
+    tasks[p].n_inputs -= 1;
+    return true;
+  }
+  // levelize to determine the amount of available parallelism
+  void
+  levelize ()
+  {
+    std::vector<uint> levels (n_tasks, 0), width (n_tasks + 1, 0);
+    max_width = 0;
+    for (uint i = 0; i < n_tasks; i++)
+      {
+        max_width = std::max (max_width, ++width[levels[i]]);
+        for (uint o : tasks[i].outputs)
+          levels[o] = std::max (levels[o], levels[i] + 1);
+      }
+  }
+  void
+  start_workers (Engine *engine)
+  {
+    const uint n = n_helpers();
+    deques = std::vector<WorkStealingDeque<uint>> (1 + n);
+    deque_capacity = 256;
+    for (auto &deque : deques)
+      deque.reset (deque_capacity);
+    for (uint i = 0; i < n; i++)
+      threads.push_back (std::thread (&Engine::render_worker, engine, 1 + i));
+  }
+  void
+  stop_workers ()
+  {
+    quit = true;
+    block_stamp.fetch_add (1);
+    render_futex_wake (block_stamp);
+    for (auto &thread : threads)
+      thread.join();
+    threads.clear();
+  }
 };
 Engine::Engine (uint32 samplerate, AudioTiming &atiming) :
   nyquist_ (samplerate * 0.5), inyquist_ (1.0 / nyquist_), sample_rate_ (samplerate),
   frame_counter_ (MAX_RENDER_BLOCK_SIZE), flags_ (0), scheduler_depth_ (0),
+  commands_ (COMMAND_RING_SIZE), commands_trash_ (COMMAND_RING_SIZE),
   timing { atiming }
 {
   assert_return (samplerate > 0);
   assert_return (nyquist_ > 0 && nyquist_ == (samplerate >> 1));
   assert_return (0 == (samplerate & 3));
   schedule_.reserve (256);
+  pooled_.reserve (256);
+  graph_ = new RenderGraph();
+  graph_->edges.reserve (256);
+  graph_->start_workers (this);
   reschedule();
 }
 
+Engine::~Engine()
+{
+  graph_->stop_workers();
+  // destroy the processors while their disconnections can still be recorded
+  std::vector<ProcessorP> roots;
+  {
+    std::lock_guard<std::mutex> locker (mutex_);
+    roots.swap (roots_);
+  }
+  roots.clear();
+  {
+    std::lock_guard<std::mutex> locker (mutex_);
+    for (Processor *proc : pooled_)
+      if (proc)
+        proc->unschedule_oblocks();
+    pooled_.clear();
+  }
+  graph_->release_pool();
+  delete graph_;
+  graph_ = nullptr;
+  Command *command = nullptr;
+  while (commands_.pop (&command))      // unexecuted
+    delete command;
+  reap_commands();
+}
+
+/** Queue `command` for execution in the render thread before the next block is scheduled.
+ * Commands are passed through a lock-free single-producer ring, so only one user thread may queue commands.
+ * After execution, the Engine owns `command` and deletes it in the user thread from reap_commands(),
+ * so resources swapped out of processors by Command::execute() can be released there.
+ * Returns `false` if the ring is full, in which case ownership of `command` stays with the caller.
+ */
+bool
+Engine::async_command (Command *command)
+{
+  assert_return (command != nullptr, false);
+  reap_commands();
+  return commands_.push (command);
+}
+
+/// Delete commands that have been executed by the render thread, must be called from the user thread.
+void
+Engine::reap_commands ()
+{
+  Command *command = nullptr;
+  while (commands_trash_.pop (&command))
+    delete command;
+}
+
+// Execute pending commands in the render thread, the trash ring limits the number of commands in flight.
+void
+Engine::run_commands ()
+{
+  size_t space = commands_trash_.space();
+  Command *command = nullptr;
+  while (space && commands_.pop (&command))
+    {
+      command->execute();
+      commands_trash_.push (command);
+      space--;
+    }
+}
+
 void
 Engine::add_root (ProcessorP rootproc)
 {
@@ -412,32 +659,255 @@ Engine::reschedule()
   flags_ |= RESCHEDULE;
 }
 
+// Record a single connection change between `dep` and its dependant `proc` for make_schedule().
+void
+Engine::reschedule (Processor &dep, Processor &proc, bool connected)
+{
+  std::lock_guard<std::mutex> locker (mutex_);
+  return_unless (graph_ && 0 == (flags_ & RESCHEDULE));
+  graph_->edges.push_back ({ &dep, &proc, connected });
+  flags_ |= REGRAPH;
+}
+
 bool
 Engine::in_schedule (Processor &proc)
 {
-  // TODO: this can be optimized via unsorted_set when profiled
-  for (auto procp : schedule_)
-    if (procp == &proc)
-      return true;
-  return false;
+  return proc.schedule_stamp_ == schedule_epoch_;
+}
+
+// Apply pending connection changes to the current schedule, returns false if a full reschedule is needed.
+bool
+Engine::update_schedule ()
+{
+  RenderGraph &g = *graph_;
+  return_unless (!g.stale, false);
+  for (const RenderGraph::Edge &e : g.edges)
+    {
+      if (!in_schedule (*e.proc))
+        continue;               // inputs of unscheduled processors are irrelevant
+      if (e.connected)
+        {
+          // the schedule order remains valid if dep is already rendered before proc
+          if (!in_schedule (*e.dep) || e.dep->schedule_index_ >= e.proc->schedule_index_)
+            return false;
+          g.add_edge (e.dep->schedule_index_, e.proc->schedule_index_);
+        }
+      else
+        {
+          // processors without outputs may leave the schedule or get destroyed, so rewalk
+          if (!in_schedule (*e.dep) || e.dep->outputs_.empty() ||
+              !g.remove_edge (e.dep->schedule_index_, e.proc->schedule_index_))
+            return false;
+        }
+    }
+  g.edges.clear();
+  g.levelize();
+  return true;
 }
 
 void
 Engine::make_schedule ()
 {
   assert_return (scheduler_depth_ == 0);
-  return_unless (flags_ & RESCHEDULE);
+  run_commands();       // commands may affect the schedule
+  return_unless (flags_ & (RESCHEDULE | REGRAPH));
   std::lock_guard<std::mutex> locker (mutex_);
-  if (0 == (flags_ & RESCHEDULE))
-    return;
-  flags_ &= ~uint (RESCHEDULE);
+  const uint flags = flags_.fetch_and (~uint (RESCHEDULE | REGRAPH));
+  if (0 == (flags & RESCHEDULE))
+    {
+      if (0 == (flags & REGRAPH))
+        return;
+      if (update_schedule())
+        return layout_buffers();
+      SCHED_DEBUG ("full reschedule after %u connection changes", graph_->edges.size());
+    }
+  // processors scheduled in the previous epoch keep their state
+  schedule_epoch_ += 1;
   schedule_.clear();
+  graph_->edges.clear();
+  graph_->stale = false;
   scheduler_depth_ += 1;
   for (auto root : roots_)
     enqueue (*root);
   scheduler_depth_ -= 1;
-  for (auto proc : schedule_)
-    proc->reset_state();
+  graph_->setup (schedule_);
+  layout_buffers();
+}
+
+/* Output channel buffers of all scheduled processors are allocated as one contiguous,
+ * huge page backed pool. Outputs that nobody reads share a single scratch block, that
+ * is outputs without connections of processors that are not roots and have no dependants
+ * other than via connections (containers may read children).
+ * The remaining outputs are assigned physical blocks like registers: a block becomes
+ * reusable once its owner's dependants have rendered. Because tasks may render
+ * concurrently, a block is only handed to a processor that all previous readers of the
+ * block are ancestors of, so memory scales with the graph width, not its size.
+ * Redirected outputs that point into aliased blocks are copied after rendering, see
+ * Processor::unalias_oblocks().
+ */
+void
+Engine::layout_buffers ()
+{
+  RenderGraph &g = *graph_;
+  constexpr size_t BLOCK_BYTES = MAX_RENDER_BLOCK_SIZE * sizeof (float);
+  const uint n_tasks = g.n_tasks;
+  std::vector<bool> &readable = g.readable, &is_root = g.is_root;
+  readable.assign (n_tasks, false);
+  is_root.assign (n_tasks, false);
+  for (auto &root : roots_)
+    if (in_schedule (*root))
+      readable[root->schedule_index_] = is_root[root->schedule_index_] = true;
+  // happens-before relation, ancestors[i] has bit j set if task j completes before task i starts
+  const bool alias = n_tasks <= RenderGraph::MAX_ALIAS_TASKS;
+  const size_t words = (n_tasks + 63) / 64;
+  std::vector<uint64> &ancestors = g.ancestors;
+  ancestors.assign (alias ? n_tasks * words : 0, 0);
+  auto precedes = [&] (uint j, uint i) {
+    return (ancestors[i * words + j / 64] >> (j % 64)) & 1;
+  };
+  if (alias)
+    for (uint i = 0; i < n_tasks; i++)  // tasks are in topological order
+      for (uint o : g.tasks[i].outputs)
+        {
+          uint64 *const row = &ancestors[o * words];
+          const uint64 *const irow = &ancestors[i * words];
+          for (size_t w = 0; w < words; w++)
+            row[w] |= irow[w];
+          row[i / 64] |= uint64 (1) << (i % 64);
+        }
+  // assign block indices, block 0 is shared by all unread outputs
+  std::vector<RenderGraph::Reusable> &reusable = g.reusable;   // blocks whose owner's readers may still be rendering
+  std::vector<uint> &n_owners = g.n_owners;     // number of outputs per block
+  std::vector<uint> &assignment = g.assignment; // block per output channel, in schedule order
+  reusable.clear();
+  n_owners.assign (1, 0);
+  assignment.clear();
+  uint n_outputs = 0, n_unread = 0;
+  for (uint i = 0; i < n_tasks; i++)
+    {
+      Processor &proc = *g.tasks[i].proc;
+      readable[i] = readable[i] || proc.outputs_.size() != g.tasks[i].outputs.size();
+      const size_t first = assignment.size();
+      for (size_t b = 0; b < proc.n_obuses(); b++)
+        {
+          const Processor::OBus &obus = proc.iobus (OBusId (1 + b));
+          const bool used = readable[i] || obus.fbuffer_concounter;
+          for (size_t c = 0; c < obus.fbuffer_count; c++)
+            {
+              uint block = 0;
+              if (used)
+                {
+                  block = n_owners.size();
+                  for (auto it = reusable.begin(); it != reusable.end(); ++it)
+                    {
+                      const std::vector<uint> &readers = g.tasks[it->owner].outputs;
+                      if (std::all_of (readers.begin(), readers.end(), [&] (uint r) { return precedes (r, i); }))
+                        {
+                          block = it->block;
+                          reusable.erase (it);
+                          break;
+                        }
+                    }
+                  if (block == n_owners.size())
+                    n_owners.push_back (0);
+                }
+              else
+                n_unread++;
+              n_owners[block] += 1;
+              n_outputs += 1;
+              assignment.push_back (block);
+            }
+        }
+      // roots are read after rendering, outputs without dependants may be read by unscheduled processors
+      if (alias && !is_root[i] && !g.tasks[i].outputs.empty())
+        for (size_t k = first; k < assignment.size(); k++)
+          if (assignment[k])
+            reusable.push_back ({ assignment[k], i });
+    }
+  const size_t n_blocks = n_owners.size();
+  // allocate and clear new pool, so no stale denormals or NaNs can be picked up
+  RenderGraph::BufferPool pool;
+  const size_t pool_bytes = n_blocks * BLOCK_BYTES;
+  if (!g.arena)
+    g.arena = std::make_unique<FastMemory::Arena> (RenderGraph::ARENA_SIZE);
+  if (pool_bytes <= RenderGraph::ARENA_SIZE)
+    pool.block = g.arena->allocate (pool_bytes, std::nothrow);
+  pool.mem = (float*) pool.block.block_start;
+  if (!pool.mem)
+    {
+      SCHED_DEBUG ("FloatBuffer pool exceeds arena: %u blocks", n_blocks);
+      pool.mem = (float*) fast_mem_alloc (pool_bytes);
+    }
+  floatfill (pool.mem, 0.0, n_blocks * MAX_RENDER_BLOCK_SIZE);
+  // outputs of processors that left the schedule must not point into the released pool
+  for (Processor *proc : pooled_)
+    if (proc && !in_schedule (*proc))
+      proc->unschedule_oblocks();
+  pooled_.clear();
+  // assign physical blocks
+  const uint *block = assignment.data();
+  for (uint i = 0; i < n_tasks; i++)
+    {
+      Processor &proc = *g.tasks[i].proc;
+      proc.pool_index_ = pooled_.size();
+      pooled_.push_back (&proc);
+      for (size_t b = 0; b < proc.n_obuses(); b++)
+        {
+          const Processor::OBus &obus = proc.iobus (OBusId (1 + b));
+          for (size_t c = 0; c < obus.fbuffer_count; c++)
+            {
+              Processor::FloatBuffer &fbuffer = proc.fbuffers_[obus.fbuffer_index + c];
+              fbuffer.fblock = pool.mem + *block++ * MAX_RENDER_BLOCK_SIZE;
+              fbuffer.buffer = fbuffer.fblock;
+            }
+        }
+    }
+  g.release_pool();
+  g.pool = pool;
+  g.pool_blocks = n_blocks;
+  g.aliased.resize (n_blocks);
+  for (size_t k = 0; k < n_blocks; k++)
+    g.aliased[k] = n_owners[k] > 1;
+  SCHED_DEBUG ("FloatBuffer pool: %u processors, %u outputs (%u unread), %u blocks, %u bytes%s",
+               n_tasks, n_outputs, n_unread, n_blocks, pool_bytes, alias ? "" : " (aliasing disabled)");
+}
+
+// Forget about `proc` before it is destroyed, so layout_buffers() won't touch it.
+void
+Engine::unpool (Processor &proc)
+{
+  std::lock_guard<std::mutex> locker (mutex_);
+  if (proc.pool_index_ < pooled_.size() && pooled_[proc.pool_index_] == &proc)
+    pooled_[proc.pool_index_] = nullptr;
+  proc.pool_index_ = ~0;
+}
+
+// Discard connection changes of `proc` once it is disconnected for destruction, so update_schedule() won't touch it.
+void
+Engine::drop_edges (Processor &proc)
+{
+  std::lock_guard<std::mutex> locker (mutex_);
+  return_unless (graph_);
+  std::vector<RenderGraph::Edge> &edges = graph_->edges;
+  const size_t n_edges = edges.size();
+  edges.erase (std::remove_if (edges.begin(), edges.end(), [&proc] (const RenderGraph::Edge &e) {
+        return e.dep == &proc || e.proc == &proc;
+      }), edges.end());
+  if (edges.size() != n_edges)
+    {
+      graph_->stale = true;     // the remaining edges no longer describe all changes
+      flags_ |= REGRAPH;
+    }
+}
+
+/// Check if `block` points into a pool block that is shared by several outputs.
+bool
+Engine::aliased_block (const float *block) const
+{
+  const RenderGraph &g = *graph_;
+  const float *const mem = g.pool.mem;
+  return_unless (block >= mem && block < mem + g.pool_blocks * MAX_RENDER_BLOCK_SIZE, false);
+  return g.aliased[(block - mem) / MAX_RENDER_BLOCK_SIZE];
 }
 
 void
@@ -445,11 +915,21 @@ Engine::enqueue (Processor &proc)
 {
   assert_return (this == &proc.engine_);
   assert_return (scheduler_depth_ > 0 && scheduler_depth_ <= 999);
+  Processor *const parent = scheduler_parent_;
+  if (parent)
+    graph_->edges.push_back ({ &proc, parent, true });
+  return_unless (!in_schedule (proc));  // dependencies are already enqueued
   scheduler_depth_ += 1;
+  scheduler_parent_ = &proc;
   proc.enqueue_deps();
+  scheduler_parent_ = parent;
   scheduler_depth_ -= 1;
-  if (!in_schedule (proc))
-    schedule_.push_back (&proc);
+  const bool was_scheduled = proc.schedule_stamp_ + 1 == schedule_epoch_;
+  proc.schedule_stamp_ = schedule_epoch_;
+  proc.schedule_index_ = schedule_.size();
+  schedule_.push_back (&proc);
+  if (!was_scheduled)
+    proc.reset_state();
 }
 
 /// Render a block of MAX_RENDER_BLOCK_SIZE in all Processors connected to this Engine.
@@ -458,16 +938,91 @@ Engine::render_block()
 {
   assert_return (!(flags_ & RESCHEDULE));
   frame_counter_ += MAX_RENDER_BLOCK_SIZE;
-  for (auto procp : schedule_)
-    procp->render_block();
-  /* TODO: concurrent rendering:
-     - rework schedule_ into a dependency tree, each node reflects a processor and its dependencies
-     - a worker starts on a node, processes dependencies in depth first fashion
-     - per level, 1: process all dependencies that are not yet done and not processing (needs atomic flag)
-     - per level, 2: wait for all nodes (in turn) that are not yet done
-     - per level, 3: process node itself, return
-     - experiment: *also* maintain linear schedule_, have unused workers race over schedule_ concurrently
-   */
+  RenderGraph &g = *graph_;
+  const uint n_helpers = RenderGraph::n_helpers();
+  if (n_helpers == 0 || g.max_width < 2)
+    {
+      // serial rendering, no CPUs to spare or no independent subtrees
+      for (auto procp : schedule_)
+        procp->render_block();
+      return;
+    }
+  // count the block's tasks before seeding, so a helper that is late to leave the previous
+  // block and picks up a seed already accounts for it
+  g.n_pending.store (g.n_tasks);
+  // seed dependency free tasks, dependants (higher indices) are reset before their inputs are pushed
+  for (uint i = g.n_tasks; i-- > 0; )
+    {
+      RenderGraph::Task &task = g.tasks[i];
+      task.pending.store (task.n_inputs, std::memory_order_relaxed);
+      if (task.n_inputs == 0)
+        g.deques[0].push (i);
+    }
+  g.active.store (true);
+  g.block_stamp.fetch_add (1);
+  render_futex_wake (g.block_stamp);
+  render_tasks (0);
+  // all deques are drained once no task is pending, helpers leave without being waited for
+  g.active.store (false);
+}
+
+// Render tasks of the current block until all are done, `worker` selects the deque to push to.
+void
+Engine::render_tasks (uint worker)
+{
+  RenderGraph &g = *graph_;
+  const uint n_deques = g.deques.size();
+  uint spins = 0;
+  while (g.n_pending.load (std::memory_order_acquire) > 0)
+    {
+      uint t = ~0;
+      bool found = g.deques[worker].pop (&t);
+      for (uint i = 1; !found && i < n_deques; i++)
+        found = g.deques[(worker + i) % n_deques].steal (&t);
+      if (!found)
+        {
+          if (++spins >= 64)
+            {
+              spins = 0;
+              std::this_thread::yield();
+            }
+          continue;
+        }
+      spins = 0;
+      RenderGraph::Task &task = g.tasks[t];
+      task.proc->render_block();
+      for (uint o : task.outputs)
+        if (1 == g.tasks[o].pending.fetch_sub (1, std::memory_order_acq_rel))
+          g.deques[worker].push (o);
+      g.n_pending.fetch_sub (1, std::memory_order_acq_rel);
+    }
+}
+
+// Helper thread main loop, joins the rendering thread for each block.
+void
+Engine::render_worker (uint worker)
+{
+  RenderGraph &g = *graph_;
+  this_thread_set_name (string_format ("AudioWorker-%u", worker));
+  Profiler::register_thread();
+#ifdef __SSE__
+  _mm_setcsr (_mm_getcsr() | 0x8040); // flush denormals to zero (FTZ | DAZ)
+#endif
+  int seen_stamp = g.block_stamp.load();
+  for (;;)
+    {
+      render_futex_wait (g.block_stamp, seen_stamp);     // returns early if a block started meanwhile
+      if (g.quit)
+        return;
+      const int stamp = g.block_stamp.load();
+      if (stamp == seen_stamp)
+        continue;               // spurious wakeup
+      seen_stamp = stamp;
+      g.n_busy.fetch_add (1);
+      if (g.active.load())      // the rendering thread may have finished this block already
+        render_tasks (worker);
+      g.n_busy.fetch_sub (1);
+    }
 }
 
 // == Processor ==
@@ -489,13 +1044,17 @@ Processor::Processor() :
 /// The destructor is called when the last std::shared_ptr<> reference drops.
 Processor::~Processor ()
 {
+  engine_.unpool (*this);
   remove_all_buses();
+  engine_.drop_edges (*this);
+  delete pevents_.exchange (nullptr);
 }
 
 const Processor::FloatBuffer&
 Processor::zero_buffer()
 {
-  static const FloatBuffer const_zero_float_buffer {};
+  alignas (64) static const float const_zero_block[MAX_RENDER_BLOCK_SIZE] = { 0, };
+  static const FloatBuffer const_zero_float_buffer { const_cast<float*> (const_zero_block) };
   return const_zero_float_buffer;
 }
 
@@ -558,10 +1117,11 @@ Processor::assign_iobufs ()
     {
       fbuffers_ = (FloatBuffer*) fast_mem_alloc (ochannel_count * sizeof (FloatBuffer));
       for (ssize_t i = 0; i < ochannel_count; i++)
-        new (fbuffers_ + i) FloatBuffer();
+        new (fbuffers_ + i) FloatBuffer (FloatBuffer::unscheduled_block());
     }
   else
     fbuffers_ = nullptr;
+  engine_.reschedule(); // the Engine assigns sample blocks to scheduled outputs
 }
 
 static __thread CString tls_param_group;
@@ -762,13 +1322,10 @@ Processor::find_pparam_ (ParamId paramid) const
   return nullptr;
 }
 
-/// Set parameter `id` to `value`.
-void
-Processor::set_param (Id32 paramid, const double value)
+// Clamp `value` to the range and stepping of `info`.
+static double
+param_constrain (const ParamInfo *info, double value)
 {
-  const PParam *pparam = find_pparam (ParamId (paramid.id));
-  return_unless (pparam);
-  const ParamInfo *info = pparam->info.get();
   double v = value;
   if (info)
     {
@@ -785,9 +1342,182 @@ Processor::set_param (Id32 paramid, const double value)
           v = CLAMP (mm.first + v, mm.first, mm.second);
         }
     }
+  return v;
+}
+
+/// Set parameter `id` to `value`.
+void
+Processor::set_param (Id32 paramid, const double value)
+{
+  const PParam *pparam = find_pparam (ParamId (paramid.id));
+  return_unless (pparam);
+  const double v = param_constrain (pparam->info.get(), value);
   const_cast<PParam*> (pparam)->assign (v);
 }
 
+// == ParamEvents ==
+/// Timestamped parameter change, `frame` is in units of Engine::frame_counter().
+struct ParamEvent {
+  uint64  frame = 0;
+  ParamId id = {};
+  uint32  ramp = 0;     // number of frames to linearly ramp towards `value`, 0 for a step
+  double  value = 0;
+};
+
+// Per Processor queue of parameter changes, pushed from any thread, consumed by render_block().
+struct Processor::ParamEvents {
+  static constexpr size_t QUEUE_SIZE = 1024;
+  AtomicBoundedQueue<ParamEvent> queue { QUEUE_SIZE };
+  ParamEvent                     pending[QUEUE_SIZE];   // sorted by frame, only accessed from render_block()
+  uint                           n_pending = 0;
+  uint                           n_block = 0;   // number of `pending` events within the current block
+  uint64                         block_start = 0;
+};
+
+/** Schedule parameter `id` to change to `value` at sample frame `frame` (see Engine::frame_counter()).
+ * With `ramp_frames > 0`, the parameter linearly ramps towards `value` starting at `frame`.
+ * Processors pick up sub-block changes via param_ramp(), otherwise the value at the end of
+ * each block is applied like set_param() does.
+ * Returns `false` if the event queue is full, in which case `value` is assigned immediately.
+ * This function is MT-Safe after proper Processor initialization.
+ */
+bool
+Processor::schedule_param (Id32 paramid, double value, uint64 frame, uint ramp_frames)
+{
+  const PParam *pparam = find_pparam (ParamId (paramid.id));
+  return_unless (pparam, false);
+  ParamEvents *pevents = pevents_.load (std::memory_order_acquire);
+  if (!pevents)
+    {
+      ParamEvents *fresh = new ParamEvents();
+      if (pevents_.compare_exchange_strong (pevents, fresh, std::memory_order_acq_rel))
+        pevents = fresh;
+      else
+        delete fresh;   // pevents holds the concurrently installed queue
+    }
+  const ParamEvent event { frame, pparam->id, ramp_frames, param_constrain (pparam->info.get(), value) };
+  if (BSE_ISLIKELY (pevents->queue.push (event)))
+    return true;
+  const_cast<PParam*> (pparam)->assign (event.value);
+  return false;
+}
+
+// Move newly queued parameter events into the pending list and mark events of the current block.
+void
+Processor::fetch_param_events ()
+{
+  ParamEvents *pevents = pevents_.load (std::memory_order_acquire);
+  ParamEvents &pe = *pevents;
+  ParamEvent event;
+  // allocation free insertion merge, events are usually queued in order, so this rarely moves any
+  // and events that don't fit are left in the queue until a later block
+  while (pe.n_pending < ParamEvents::QUEUE_SIZE && pe.queue.pop (&event))
+    {
+      uint i = pe.n_pending++;
+      for (; i > 0 && pe.pending[i - 1].frame > event.frame; i--)
+        pe.pending[i] = pe.pending[i - 1];
+      pe.pending[i] = event;    // after events of the same frame, i.e. stable
+    }
+  pe.block_start = engine_.frame_counter() - MAX_RENDER_BLOCK_SIZE;
+  const uint64 block_end = pe.block_start + MAX_RENDER_BLOCK_SIZE;
+  uint n = 0;
+  while (n < pe.n_pending && pe.pending[n].frame < block_end)
+    n++;
+  pe.n_block = n;
+}
+
+// Apply all parameter changes of the current block and drop its events.
+void
+Processor::commit_param_events ()
+{
+  ParamEvents &pe = *pevents_.load (std::memory_order_relaxed);
+  auto has_block_event = [&pe] (ParamId id) {
+    for (uint i = 0; i < pe.n_block; i++)
+      if (pe.pending[i].id == id)
+        return true;
+    return false;
+  };
+  for (PParam &pparam : params_)
+    if (pparam.is_ramping() || has_block_event (pparam.id))
+      param_ramp_ (pparam, nullptr, MAX_RENDER_BLOCK_SIZE, true);
+  std::copy (pe.pending + pe.n_block, pe.pending + pe.n_pending, pe.pending);
+  pe.n_pending -= pe.n_block;
+  pe.n_block = 0;
+}
+
+// Compute per frame values of `pparam` for the current block and optionally commit the final state.
+bool
+Processor::param_ramp_ (PParam &pparam, float *values, uint n_frames, bool commit)
+{
+  ParamEvents *pevents = pevents_.load (std::memory_order_relaxed);
+  double v = pparam.peek(), target = pparam.ramp_target_, step = pparam.ramp_step_;
+  uint32 left = pparam.ramp_left_;
+  bool varies = left > 0;
+  uint i = 0;
+  auto advance = [&] (uint end) {
+    if (!left)
+      {
+        if (values)
+          std::fill (values + i, values + end, v);
+        i = end;
+        return;
+      }
+    for (; i < end; i++)
+      {
+        if (values)
+          values[i] = v;
+        if (left)
+          v = --left ? v + step : target;
+      }
+  };
+  const uint n_events = pevents ? pevents->n_block : 0;
+  for (uint j = 0; j < n_events; j++)
+    {
+      const ParamEvent &event = pevents->pending[j];
+      if (event.id != pparam.id)
+        continue;
+      const uint pos = event.frame > pevents->block_start ? event.frame - pevents->block_start : 0;
+      if (pos >= n_frames)
+        break;          // events are sorted by frame
+      advance (pos);
+      varies |= pos > 0 || event.ramp > 0;
+      if (event.ramp)
+        {
+          target = event.value;
+          step = (target - v) / event.ramp;
+          left = event.ramp;
+        }
+      else
+        {
+          v = event.value;
+          left = 0;
+        }
+    }
+  advance (n_frames);
+  if (commit)
+    {
+      pparam.ramp_target_ = target;
+      pparam.ramp_step_ = step;
+      pparam.ramp_left_ = left;
+      pparam.assign (v);
+    }
+  return varies;
+}
+
+/** Fill `values` with the per frame values of parameter `id` for the current render() block.
+ * This applies sub-block changes and linear ramps from schedule_param() with sample accuracy,
+ * while get_param() yields the value at the start of the block.
+ * Returns `false` if all `n_frames` values are equal, so callers can use constant fast paths.
+ */
+bool
+Processor::param_ramp (Id32 paramid, float *values, uint n_frames)
+{
+  assert_return (n_frames <= MAX_RENDER_BLOCK_SIZE, false);
+  PParam *pparam = const_cast<PParam*> (find_pparam (ParamId (paramid.id)));
+  return_unless (pparam, false);
+  return param_ramp_ (*pparam, values, n_frames, false);
+}
+
 /// Retrieve supplemental information for parameters, usually to enhance the user interface.
 ParamInfoP
 Processor::param_info (Id32 paramid) const
@@ -1015,7 +1745,7 @@ Processor::disconnect_event_input()
       assert_return (oproc.estreams_);
       const bool backlink = vector_erase_element (oproc.outputs_, { this, EventStreams::EVENT_ISTREAM });
       estreams_->oproc = nullptr;
-      engine_.reschedule();
+      engine_.reschedule (oproc, *this, false);
       assert_return (backlink == true);
     }
 }
@@ -1031,7 +1761,7 @@ Processor::connect_event_input (Processor &oproc)
   estreams_->oproc = &oproc;
   // register backlink
   oproc.outputs_.push_back ({ this, EventStreams::EVENT_ISTREAM });
-  engine_.reschedule();
+  engine_.reschedule (oproc, *this, true);
 }
 
 /// Add an input bus with `uilabel` and channels configured via `speakerarrangement`.
@@ -1131,7 +1861,7 @@ Processor::float_buffer (OBusId busid, uint channelindex, bool resetptr)
   assert_return (channelindex < obus.fbuffer_count, *fallback);
   FloatBuffer &fbuffer = fbuffers_[obus.fbuffer_index + channelindex];
   if (resetptr)
-    fbuffer.buffer = &fbuffer.fblock[0];
+    fbuffer.buffer = fbuffer.fblock;
   return fbuffer;
 }
 
@@ -1228,7 +1958,9 @@ Processor::disconnect (IBusId ibusid)
   const bool backlink = vector_erase_element (oproc.outputs_, { this, ibusid });
   ibus.proc = nullptr;
   ibus.obusid = {};
-  engine_.reschedule();
+  engine_.reschedule (oproc, *this, false);
+  if (Processor *const forwarder = input_forwarder())
+    engine_.reschedule (oproc, *forwarder, false);
   assert_return (backlink == true);
 }
 
@@ -1255,7 +1987,9 @@ Processor::connect (IBusId ibusid, Processor &oproc, OBusId obusid)
   // register backlink
   obus.fbuffer_concounter += 1; // conection counter
   oproc.outputs_.push_back ({ this, ibusid });
-  engine_.reschedule();
+  engine_.reschedule (oproc, *this, true);
+  if (Processor *const forwarder = input_forwarder())
+    engine_.reschedule (oproc, *forwarder, true);
 }
 
 /// Ensure `Processor::initialize()` has been called, so the parameters are fixed.
@@ -1332,8 +2066,52 @@ Processor::render_block ()
   return_unless (done_frames_ < engine_frame_counter);
   if (BSE_UNLIKELY (estreams_) && !BSE_ISLIKELY (estreams_->estream.empty()))
     estreams_->estream.clear();
+  const Profiler::Ticks stamp = Profiler::ticks();
+  const bool param_events = BSE_UNLIKELY (pevents_.load (std::memory_order_relaxed) != nullptr);
+  if (param_events)
+    fetch_param_events();
   render (MAX_RENDER_BLOCK_SIZE);
+  if (param_events)
+    commit_param_events();
+  unalias_oblocks();
   done_frames_ = engine_frame_counter;
+  Profiler::record (this, typeid (*this), nullptr, stamp, Profiler::ticks());
+}
+
+// Copy outputs that are redirected into aliased blocks, these may be reused before our dependants render.
+void
+Processor::unalias_oblocks ()
+{
+  for (size_t b = 0; b < n_obuses(); b++)
+    {
+      const OBus &obus = iobus (OBusId (1 + b));
+      for (size_t c = 0; c < obus.fbuffer_count; c++)
+        {
+          FloatBuffer &fbuffer = fbuffers_[obus.fbuffer_index + c];
+          if (BSE_UNLIKELY (fbuffer.buffer != fbuffer.fblock) && engine_.aliased_block (fbuffer.buffer))
+            {
+              floatcopy (fbuffer.fblock, fbuffer.buffer, MAX_RENDER_BLOCK_SIZE);
+              fbuffer.buffer = fbuffer.fblock;
+            }
+        }
+    }
+}
+
+// Point all outputs at the unscheduled placeholder, used when the Engine releases their pool blocks.
+void
+Processor::unschedule_oblocks ()
+{
+  for (size_t b = 0; b < n_obuses(); b++)
+    {
+      const OBus &obus = iobus (OBusId (1 + b));
+      for (size_t c = 0; c < obus.fbuffer_count; c++)
+        {
+          FloatBuffer &fbuffer = fbuffers_[obus.fbuffer_index + c];
+          fbuffer.fblock = FloatBuffer::unscheduled_block();
+          fbuffer.buffer = fbuffer.fblock;
+        }
+    }
+  pool_index_ = ~0;
 }
 
 /// Invoke Processor::configure() with `ipatch`/`opatch` applied to the current configuration.
@@ -1462,6 +2240,14 @@ public:
   void initialize () override                           {}
   void reset      () override                           {}
   void
+  enqueue_children () override
+  {
+    // the Chain inputs are forwarded, so their producers must render first
+    for (size_t i = 0; i < chain_.n_ibuses(); i++)
+      if (Processor *const oproc = chain_.iobus (IBusId (1 + i)).proc)
+        engine_.enqueue (*oproc);
+  }
+  void
   configure (uint n_ibusses, const SpeakerArrangement *ibusses, uint n_obusses, const SpeakerArrangement *obusses) override
   {
     remove_all_buses();
@@ -1535,6 +2321,12 @@ void
 Chain::reset()
 {}
 
+Processor*
+Chain::input_forwarder ()
+{
+  return inlet_.get();
+}
+
 void
 Chain::enqueue_children ()
 {
@@ -1845,28 +2637,156 @@ Processor::PParam::operator= (const PParam &src)
   id = src.id;
   flags_ = src.flags_.load();
   value_ = src.value_.load();
+  ramp_target_ = src.ramp_target_;
+  ramp_step_ = src.ramp_step_;
+  ramp_left_ = src.ramp_left_;
   info = src.info;
   return *this;
 }
 
 // == FloatBuffer ==
-/// Check for end-of-buffer overwrites
+/// Block for outputs of unscheduled Processors, these are never rendered.
+/// The block is read-only, so stray writes fault instead of leaking into other processors.
+float*
+Processor::FloatBuffer::unscheduled_block ()
+{
+  alignas (64) static const float unscheduled[MAX_RENDER_BLOCK_SIZE] = { 0, };
+  return const_cast<float*> (unscheduled);
+}
+
+/// Check sample block alignment.
 void
 Processor::FloatBuffer::check ()
 {
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Winvalid-offsetof"
-  // verify cache-line aligned struct layout
-  static_assert (0 == (offsetof (FloatBuffer, fblock[0]) & 63));
-  static_assert (0 == (offsetof (FloatBuffer, canary0_) & 63));
-  static_assert (0 == ((sizeof (buffer) + offsetof (FloatBuffer, buffer)) & 63));
-#pragma GCC diagnostic pop
   // verify cache-line aligned runtime layout
+  assert_return (0 == (uintptr_t (fblock) & 63));
   assert_return (0 == (uintptr_t (&buffer[0]) & 63));
-  // failing canaries indicate end-of-buffer overwrites
-  assert_return (canary0_ == const_canary);
-  assert_return (canary1_ == const_canary);
 }
 
 } // AudioSignal
 } // Bse
+
+// == Testing ==
+#include "testing.hh"
+
+namespace { // Anon
+using namespace Bse;
+using namespace Bse::AudioSignal;
+
+// Mono source that outputs the per frame values of its only parameter
+class ParamRampTestProcessor : public Processor {
+  OBusId out_ = {};
+public:
+  explicit ParamRampTestProcessor (const std::any &any) {}
+  void query_info (ProcessorInfo &info) override        { info.label = "ParamRampTestProcessor"; }
+  void initialize () override                           { add_param (1, "Level", "Lvl", 0, 1, 0); }
+  void reset      () override                           {}
+  void
+  configure (uint n_ibusses, const SpeakerArrangement *ibusses, uint n_obusses, const SpeakerArrangement *obusses) override
+  {
+    remove_all_buses();
+    out_ = add_output_bus ("Output", SpeakerArrangement::MONO);
+  }
+  void
+  render (uint n_frames) override
+  {
+    param_ramp (1, oblock (out_, 0), n_frames);
+  }
+};
+
+// Event output without audio buses
+class EventSourceTestProcessor : public Processor {
+public:
+  explicit EventSourceTestProcessor (const std::any &any) {}
+  void query_info (ProcessorInfo &info) override        { info.label = "EventSourceTestProcessor"; }
+  void reset      () override                           {}
+  void render     (uint n_frames) override              {}
+  void
+  configure (uint n_ibusses, const SpeakerArrangement *ibusses, uint n_obusses, const SpeakerArrangement *obusses) override
+  {
+    remove_all_buses();
+    prepare_event_output();
+  }
+};
+
+// Event input that owns its source, like a container owns its children
+class EventSinkTestProcessor : public Processor, ProcessorManager {
+  ProcessorP source_;
+public:
+  explicit EventSinkTestProcessor (const std::any &any) {}
+  void query_info (ProcessorInfo &info) override        { info.label = "EventSinkTestProcessor"; }
+  void reset      () override                           {}
+  void render     (uint n_frames) override              {}
+  void
+  configure (uint n_ibusses, const SpeakerArrangement *ibusses, uint n_obusses, const SpeakerArrangement *obusses) override
+  {
+    remove_all_buses();
+    prepare_event_input();
+  }
+  void
+  connect_source (ProcessorP source)
+  {
+    source_ = source;
+    pm_connect_events (*source_, *this);
+  }
+};
+
+BSE_INTEGRITY_TEST (bse_test_engine_teardown);
+static void
+bse_test_engine_teardown()
+{
+  static const auto source_id = enroll_asp<EventSourceTestProcessor>();
+  static const auto sink_id = enroll_asp<EventSinkTestProcessor>();
+  AudioTiming timing;
+  auto engine = std::make_unique<Engine> (48000, timing);
+  ProcessorP source = Processor::registry_create (*engine, source_id, nullptr);
+  auto sink = std::dynamic_pointer_cast<EventSinkTestProcessor> (Processor::registry_create (*engine, sink_id, nullptr));
+  TASSERT (source != nullptr && sink != nullptr);
+  sink->connect_source (source);
+  engine->add_root (sink);
+  engine->make_schedule();
+  engine->render_block();
+  TASSERT (engine->in_schedule (*source));
+  source = nullptr;
+  sink = nullptr;
+  // the Engine drops the last reference to its root, so the event connection is removed during teardown
+  engine = nullptr;
+}
+
+BSE_INTEGRITY_TEST (bse_test_schedule_param);
+static void
+bse_test_schedule_param()
+{
+  static const auto reg_id = enroll_asp<ParamRampTestProcessor>();
+  AudioTiming timing;
+  Engine engine (48000, timing);
+  ProcessorP proc = Processor::registry_create (engine, reg_id, nullptr);
+  TASSERT (proc != nullptr);
+  engine.add_root (proc);
+  const uint64 f0 = engine.frame_counter();     // start of the first block
+  const uint B = MAX_RENDER_BLOCK_SIZE;
+  // queued out of order: a ramp across the second block boundary, preceeded by a step
+  TASSERT (proc->schedule_param (1, 0.0, f0 + B + 96, 64));
+  TASSERT (proc->schedule_param (1, 1.0, f0 + 10));
+  engine.make_schedule();
+  const float *values = proc->ofloats (OBusId (1), 0);
+  engine.render_block();
+  for (uint i = 0; i < B; i++)
+    TCMP (values[i], ==, i < 10 ? 0.0 : 1.0);
+  TCMP (proc->get_param (1), ==, 1.0);
+  engine.render_block();
+  for (uint i = 0; i < 96; i++)
+    TCMP (values[i], ==, 1.0);
+  for (uint i = 96; i < B; i++)
+    TCMP (fabs (values[i] - (1.0 - (i - 96) / 64.0)), <, 1e-6);
+  engine.render_block();
+  for (uint i = 0; i < 32; i++)
+    TCMP (fabs (values[i] - (1.0 - (i + 32) / 64.0)), <, 1e-6);
+  for (uint i = 32; i < B; i++)
+    TCMP (values[i], ==, 0.0);
+  TCMP (proc->get_param (1), ==, 0.0);
+  engine.del_root (proc);
+  proc = nullptr;
+}
+
+} // Anon
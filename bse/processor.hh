@@ -178,6 +178,7 @@ class Processor : public std::enable_shared_from_this<Processor>, public FastMem
   struct EventStreams;
   union  PBus;
   struct PParam;
+  struct ParamEvents;
   class FloatBuffer;
   friend class ProcessorManager;
   friend class Engine;
@@ -209,7 +210,11 @@ private:
   std::vector<PParam>      params_;
   std::vector<OConnection> outputs_;
   EventStreams            *estreams_ = nullptr;
+  std::atomic<ParamEvents*> pevents_ = nullptr;
   uint64_t                 done_frames_ = 0;
+  uint64_t                 schedule_stamp_ = 0;    // Engine.schedule_epoch_ while scheduled
+  uint                     schedule_index_ = ~0;   // index into Engine.schedule_ while scheduled
+  uint                     pool_index_ = ~0;       // index into Engine.pooled_ while outputs are pool blocks
   static __thread uint64   tls_timestamp;
   static void        registry_init      ();
   const PParam*      find_pparam        (Id32 paramid) const;
@@ -225,6 +230,11 @@ private:
   void               render_block       ();
   void               reset_state        ();
   void               enqueue_deps       ();
+  void               fetch_param_events ();
+  void               commit_param_events();
+  void               unalias_oblocks    ();
+  void               unschedule_oblocks ();
+  bool               param_ramp_        (PParam &pparam, float *values, uint n_frames, bool commit);
   /*copy*/           Processor          (const Processor&) = delete;
   virtual void       render             (uint n_frames) = 0;
   virtual void       reset              () = 0;
@@ -238,6 +248,7 @@ protected:
   // Parameters
   virtual void  adjust_param      (Id32 tag) {}
   virtual void  enqueue_children  () {}
+  virtual Processor* input_forwarder () { return nullptr; } // processor that also reads the input buses
   ParamId       nextid            () const;
   ParamId       add_param         (Id32 id, const ParamInfo &infotmpl, double value);
   ParamId       add_param         (Id32 id, const std::string &clabel, const std::string &nickname,
@@ -262,6 +273,7 @@ protected:
                                    bool boolvalue, std::string hints = "",
                                    const std::string &blurb = "", const std::string &description = "");
   double        peek_param_mt     (Id32 paramid) const;
+  bool          param_ramp        (Id32 paramid, float *values, uint n_frames = MAX_RENDER_BLOCK_SIZE);
   // Buses
   IBusId        add_input_bus     (CString uilabel, SpeakerArrangement speakerarrangement,
                                    const std::string &hints = "", const std::string &blurb = "");
@@ -299,6 +311,7 @@ public:
   // Parameters
   double              get_param             (Id32 paramid);
   void                set_param             (Id32 paramid, double value);
+  bool                schedule_param        (Id32 paramid, double value, uint64 frame, uint ramp_frames = 0);
   ParamInfoP          param_info            (Id32 paramid) const;
   MaybeParamId        find_param            (const std::string &identifier) const;
   ParamInfoPVec       list_params           () const;
@@ -355,12 +368,42 @@ class Engine {
   uint64_t           frame_counter_;
   std::atomic<uint>  flags_;
   uint               scheduler_depth_;
+  uint64_t           schedule_epoch_ = 1;
+  Processor         *scheduler_parent_ = nullptr;
+  std::mutex              mutex_;
   std::vector<Processor*> schedule_;
+  std::vector<Processor*> pooled_;      // processors with outputs in the FloatBuffer pool, guarded by mutex_
   std::vector<ProcessorP> roots_;
-  std::mutex              mutex_;
+  struct RenderGraph;
+  RenderGraph            *graph_ = nullptr;
+  void          render_worker    (uint worker);
+  void          render_tasks     (uint worker);
+  bool          update_schedule  ();
+  void          reschedule       (Processor &dep, Processor &proc, bool connected);
+  void          run_commands     ();
+  void          layout_buffers   ();
+  void          unpool           (Processor &proc);
+  void          drop_edges       (Processor &proc);
+  bool          aliased_block    (const float *block) const;
+  friend class Processor;
+public:
+  /// Command to be executed in the render thread, see async_command().
+  class Command {
+  public:
+    virtual      ~Command        () {}
+    virtual void  execute        () = 0;        ///< Called in the render thread, must not allocate, free or lock.
+  };
+private:
+  SpscRing<Command*>      commands_;            // user thread -> render thread
+  SpscRing<Command*>      commands_trash_;      // render thread -> user thread
 public:
   const AudioTiming &timing;
   explicit      Engine           (uint32 samplerate, AudioTiming &atiming);
+  /*dtor*/     ~Engine           ();
+  bool          async_command    (Command *command);
+  template<class Lambda>
+  bool          async_job        (Lambda &&lambda);
+  void          reap_commands    ();
   uint          sample_rate      () const BSE_CONST      { return sample_rate_; }
   double        nyquist          () const BSE_CONST      { return nyquist_; }
   double        inyquist         () const BSE_CONST      { return inyquist_; }
@@ -374,22 +417,39 @@ public:
   void          render_block     ();
 };
 
+/// Queue `lambda` for execution in the render thread, see async_command().
+/// Resources captured by `lambda` are released in the user thread after execution.
+template<class Lambda> bool
+Engine::async_job (Lambda &&lambda)
+{
+  struct LambdaCommand : Command {
+    typename std::decay<Lambda>::type lambda_;
+    explicit LambdaCommand (Lambda &&l) : lambda_ (std::forward<Lambda> (l)) {}
+    void     execute       () override { lambda_(); }
+  };
+  Command *command = new LambdaCommand (std::forward<Lambda> (lambda));
+  if (BSE_ISLIKELY (async_command (command)))
+    return true;
+  delete command;
+  return false;
+}
+
 /// Aggregate structure for input/output buffer state and values in Processor::render().
 /// The floating point #buffer array is cache-line aligned (to 64 byte) to optimize
-/// SIMD access and avoid false sharing.
+/// SIMD access and avoid false sharing. The sample blocks of all scheduled outputs are
+/// assigned by the Engine from a contiguous pool in schedule order.
 class Processor::FloatBuffer {
   void          check      ();
+  static float* unscheduled_block ();
+  explicit      FloatBuffer (float *block) : fblock (block), buffer (block) {}
   /// Floating point memory when #buffer is not redirected, 64-byte aligned.
-  alignas (64) float fblock[MAX_RENDER_BLOCK_SIZE] = { 0, };
-  const uint64       canary0_ = const_canary;
-  const uint64       canary1_ = const_canary;
-  struct { uint64 d1, d2, d3, d4; }; // dummy mem
+  float             *fblock = nullptr;
   SpeakerArrangement speaker_arrangement_ = SpeakerArrangement::NONE;
   SpeakerArrangement speaker_arrangement () const;
-  static constexpr uint64 const_canary = 0xE14D8A302B97C56F;
   friend class Processor;
+  friend class Engine;
   /// Pointer to the IO samples, this can be redirected or point to #fblock.
-  float             *buffer = &fblock[0];
+  float             *buffer = nullptr;
 };
 
 // == ProcessorManager ==
@@ -426,6 +486,7 @@ protected:
   uint       chain_up         (Processor &pfirst, Processor &psecond);
   void       reconnect        (size_t start);
   void       enqueue_children () override;
+  Processor* input_forwarder  () override;
 public:
   explicit   Chain            (SpeakerArrangement iobuses = SpeakerArrangement::STEREO);
   virtual    ~Chain           ();
@@ -483,6 +544,7 @@ struct Processor::PParam {
   void     clear_updated   ()       { flags_ &= ~uint32 (2); }
   void     must_notify_mt  (bool n) { if (n) flags_ |= 4; else flags_ &= ~uint32 (4); }
   bool     must_notify     () const { return flags_ & 4; }
+  bool     is_ramping      () const { return ramp_left_ > 0; }
   void
   assign (double f)
   {
@@ -501,6 +563,11 @@ public:
 private:
   std::atomic<uint32> flags_ = 1;
   std::atomic<double> value_ = FP_NAN;
+  // linear ramp state, only accessed from render()
+  double              ramp_target_ = 0;
+  double              ramp_step_ = 0;
+  uint32              ramp_left_ = 0;
+  friend class Processor;
 public:
   ParamInfoP          info;
 };
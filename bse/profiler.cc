@@ -0,0 +1,358 @@
+// Licensed GNU LGPL v2.1 or later: http://www.gnu.org/licenses/lgpl.html
+#include "profiler.hh"
+#include "bseenums.hh"
+#include "bse/internal.hh"
+#include <unordered_map>
+#include <dlfcn.h>
+
+#define PDEBUG(...)     Bse::debug ("profiler", __VA_ARGS__)
+
+namespace Bse {
+
+// == ProfileBuffer ==
+struct ProfileSample {
+  const void           *object;
+  const std::type_info *type;
+  const void           *code;
+  Profiler::Ticks       ticks;
+};
+
+// Lock-free ring, filled by a single render thread and drained by collect()
+struct ProfileBuffer {
+  static constexpr uint32 SIZE = 4096;  // power of 2, enough for several blocks of a large project
+  std::atomic<uint32>   head { 0 };     // written by render thread
+  std::atomic<uint32>   tail { 0 };     // written by collect()
+  std::atomic<uint64>   dropped { 0 };
+  std::atomic<bool>     retired { false };
+  ProfileSample         samples[SIZE];
+  void
+  push (const ProfileSample &sample)
+  {
+    const uint32 h = head.load (std::memory_order_relaxed);
+    if (BSE_UNLIKELY (h - tail.load (std::memory_order_acquire) >= SIZE))
+      {
+        dropped.store (dropped.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+      }
+    samples[h & (SIZE - 1)] = sample;
+    head.store (h + 1, std::memory_order_release);
+  }
+  template<class F> void
+  drain (const F &f)
+  {
+    const uint32 t = tail.load (std::memory_order_relaxed);
+    const uint32 h = head.load (std::memory_order_acquire);
+    for (uint32 i = t; i != h; i++)
+      f (samples[i & (SIZE - 1)]);
+    tail.store (h, std::memory_order_release);
+  }
+};
+
+static std::mutex                  profile_buffers_mutex;
+static std::vector<ProfileBuffer*> profile_buffers;
+static std::atomic<uint64>         profile_unregistered_dropped { 0 };  // samples of threads without buffer
+
+struct ProfileBufferHolder {
+  ProfileBuffer *buffer = nullptr;
+  ~ProfileBufferHolder()
+  {
+    if (buffer)
+      buffer->retired.store (true);     // freed by collect()
+  }
+};
+static thread_local ProfileBufferHolder profile_buffer_holder;
+
+
+// == ProfileHistogram ==
+// Logarithmic buckets with 2^SUB_BITS linear steps per octave, i.e. < 12.5% error
+struct ProfileHistogram {
+  static constexpr uint SUB_BITS = 3, SUB_MASK = (1 << SUB_BITS) - 1, N_BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+  uint32 buckets[N_BUCKETS] = { 0, };
+  uint64 count = 0, max_ns = 0;
+  double total_ns = 0;
+  static uint
+  bucket (uint64 ns)
+  {
+    if (ns <= SUB_MASK)
+      return ns;
+    const uint msb = 63 - __builtin_clzll (ns);
+    return ((msb - SUB_BITS + 1) << SUB_BITS) + ((ns >> (msb - SUB_BITS)) & SUB_MASK);
+  }
+  static double
+  bucket_center (uint b)
+  {
+    if (b <= SUB_MASK)
+      return b;
+    const uint shift = (b >> SUB_BITS) - 1;
+    const double lower = uint64 ((b & SUB_MASK) | (SUB_MASK + 1)) << shift;
+    return lower + 0.5 * (uint64 (1) << shift);
+  }
+  void
+  add (uint64 ns)
+  {
+    buckets[bucket (ns)] += 1;
+    count += 1;
+    total_ns += ns;
+    max_ns = std::max (max_ns, ns);
+  }
+  double
+  percentile_ns (double q) const
+  {
+    const uint64 rank = std::max (uint64 (1), uint64 (std::ceil (q * count)));
+    uint64 n = 0;
+    for (uint b = 0; b < N_BUCKETS; b++)
+      {
+        n += buckets[b];
+        if (n >= rank)
+          return std::min (bucket_center (b), double (max_ns));
+      }
+    return max_ns;
+  }
+};
+
+// == Profiler state ==
+struct ProfilerSlot {
+  const std::type_info *type = nullptr;
+  const void           *code = nullptr;
+  uint                  idle = 0;       // number of collect() calls without samples
+  ProfileHistogram      histogram;
+};
+
+struct ProfilerState {
+  std::mutex                                     mutex;          // guards all but the atomics
+  std::unordered_map<const void*, ProfilerSlot*> entries;
+  uint64                                         dropped = 0;
+  // block statistics, written by the engine thread
+  std::atomic<uint64>                            blocks { 0 }, xruns { 0 }, device_xruns { 0 };
+  std::atomic<double>                            load { 0 }, load_sum { 0 }, load_max { 0 };
+  std::atomic<bool>                              reset_blocks { false };
+  std::atomic<char*>                             telemetry { nullptr };
+};
+
+static ProfilerState&
+profiler_state ()
+{
+  static ProfilerState &state = *new ProfilerState();
+  return state;
+}
+
+// Nanoseconds per Profiler::ticks() increment, measured by the first collect()
+static double
+profiler_calibrate_ns_per_tick ()
+{
+#if defined (__x86_64__) || defined (__i386__)
+  const uint64 ns0 = timestamp_benchmark();
+  const Profiler::Ticks tsc0 = Profiler::ticks();
+  uint64 ns;
+  do                    // spin for 2ms, the TSC runs at a constant rate on all supported CPUs
+    ns = timestamp_benchmark() - ns0;
+  while (ns < 2 * 1000000);
+  return ns / double (Profiler::ticks() - tsc0);
+#else
+  return 1;
+#endif
+}
+
+static double
+profiler_ns_per_tick ()
+{
+  static const double ns_per_tick = profiler_calibrate_ns_per_tick();
+  return ns_per_tick;
+}
+
+// Number of collect() calls without samples, after which an object is assumed to be gone
+static constexpr uint PROFILER_MAX_IDLE = 40;
+
+// == Profiler ==
+/// Allocate the sample buffer of the calling thread, so record() neither allocates nor locks.
+/// Samples recorded by threads that did not register are counted as dropped.
+void
+Profiler::register_thread ()
+{
+  return_unless (profile_buffer_holder.buffer == nullptr);
+  ProfileBuffer *buffer = new ProfileBuffer();
+  std::lock_guard<std::mutex> locker (profile_buffers_mutex);
+  profile_buffers.push_back (buffer);
+  profile_buffer_holder.buffer = buffer;
+}
+
+/// Record that `object` was processing from `start` until `end`, both taken from ticks().
+/// The `type` and optional `code` address are used to describe `object`, they must
+/// remain valid after `object` is destroyed. Lock-free, samples are only kept for threads
+/// that called register_thread().
+void
+Profiler::record (const void *object, const std::type_info &type, const void *code, Ticks start, Ticks end)
+{
+  ProfileBuffer *buffer = profile_buffer_holder.buffer;
+  if (BSE_ISLIKELY (buffer))
+    buffer->push ({ object, &type, code, end - start });
+  else
+    profile_unregistered_dropped.fetch_add (1, std::memory_order_relaxed);
+}
+
+/// Account for an engine block that took `busy_ns` to render in a block period of `period_ns`.
+void
+Profiler::record_block (uint64 busy_ns, uint64 period_ns)
+{
+  ProfilerState &ps = profiler_state();
+  if (BSE_UNLIKELY (ps.reset_blocks.load (std::memory_order_relaxed)))
+    {
+      ps.reset_blocks = false;
+      ps.blocks = 0;
+      ps.xruns = 0;
+      ps.device_xruns = 0;
+      ps.load_sum = 0;
+      ps.load_max = 0;
+    }
+  const double load = busy_ns / double (std::max (period_ns, uint64 (1)));
+  const uint64 blocks = ps.blocks.load (std::memory_order_relaxed) + 1;
+  ps.blocks.store (blocks, std::memory_order_relaxed);
+  ps.load.store (load, std::memory_order_relaxed);
+  ps.load_sum.store (ps.load_sum.load (std::memory_order_relaxed) + load, std::memory_order_relaxed);
+  if (load > ps.load_max.load (std::memory_order_relaxed))
+    ps.load_max.store (load, std::memory_order_relaxed);
+  if (busy_ns > period_ns)
+    ps.xruns.store (ps.xruns.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  char *telemetry = ps.telemetry.load (std::memory_order_acquire);
+  if (telemetry)
+    {
+      *(float*) (telemetry + ptrdiff_t (ProfilerField::F32_DSP_LOAD)) = load;
+      *(float*) (telemetry + ptrdiff_t (ProfilerField::F32_DSP_LOAD_MAX)) = ps.load_max.load (std::memory_order_relaxed);
+      *(uint32*) (telemetry + ptrdiff_t (ProfilerField::I32_XRUNS)) = ps.xruns.load (std::memory_order_relaxed) + ps.device_xruns.load();
+      *(uint32*) (telemetry + ptrdiff_t (ProfilerField::I32_BLOCKS)) = blocks;
+    }
+}
+
+void
+Profiler::count_xrun ()
+{
+  profiler_state().device_xruns += 1;
+}
+
+void
+Profiler::set_telemetry (char *mem)
+{
+  ProfilerState &ps = profiler_state();
+  if (mem)
+    memset (mem, 0, ptrdiff_t (ProfilerField::END_BYTE));
+  ps.telemetry.store (mem, std::memory_order_release);
+}
+
+void
+Profiler::collect ()
+{
+  ProfilerState &ps = profiler_state();
+  std::lock_guard<std::mutex> locker (ps.mutex);
+  const double ns_per_tick = profiler_ns_per_tick();
+  for (auto &pair : ps.entries)
+    pair.second->idle += 1;
+  std::vector<ProfileBuffer*> retired;
+  {
+    std::lock_guard<std::mutex> blocker (profile_buffers_mutex);
+    for (size_t i = 0; i < profile_buffers.size(); i++)
+      {
+        ProfileBuffer *buffer = profile_buffers[i];
+        const bool was_retired = buffer->retired.load();        // check before the final drain
+        buffer->drain ([&ps, ns_per_tick] (const ProfileSample &sample) {
+            ProfilerSlot *&entry = ps.entries[sample.object];
+            if (!entry || entry->type != sample.type || entry->code != sample.code)
+              {
+                delete entry;                                   // object address was reused
+                entry = new ProfilerSlot();
+                entry->type = sample.type;
+                entry->code = sample.code;
+              }
+            entry->idle = 0;
+            entry->histogram.add (sample.ticks * ns_per_tick);
+          });
+        ps.dropped += buffer->dropped.exchange (0);
+        if (was_retired)
+          {
+            retired.push_back (buffer);
+            profile_buffers.erase (profile_buffers.begin() + i--);
+          }
+      }
+  }
+  ps.dropped += profile_unregistered_dropped.exchange (0);
+  for (ProfileBuffer *buffer : retired)
+    delete buffer;
+  for (auto it = ps.entries.begin(); it != ps.entries.end(); )
+    if (it->second->idle > PROFILER_MAX_IDLE)
+      {
+        delete it->second;
+        it = ps.entries.erase (it);
+      }
+    else
+      ++it;
+}
+
+static String
+profiler_slot_name (const void *object, const ProfilerSlot &entry)
+{
+  String name = Aida::string_demangle_cxx (entry.type->name());
+  Dl_info info = { 0, };
+  if (entry.code && dladdr (entry.code, &info) && info.dli_sname)
+    name += "::" + Aida::string_demangle_cxx (info.dli_sname);
+  return string_format ("%s@%p", name, object);
+}
+
+std::vector<Profiler::Entry>
+Profiler::entries ()
+{
+  collect();
+  ProfilerState &ps = profiler_state();
+  std::lock_guard<std::mutex> locker (ps.mutex);
+  std::vector<Entry> result;
+  result.reserve (ps.entries.size());
+  for (const auto &pair : ps.entries)
+    {
+      const ProfileHistogram &histogram = pair.second->histogram;
+      if (!histogram.count)
+        continue;
+      Entry e;
+      e.name = profiler_slot_name (pair.first, *pair.second);
+      e.count = histogram.count;
+      e.p50_usecs = histogram.percentile_ns (0.50) * 0.001;
+      e.p99_usecs = histogram.percentile_ns (0.99) * 0.001;
+      e.max_usecs = histogram.max_ns * 0.001;
+      e.total_usecs = histogram.total_ns * 0.001;
+      result.push_back (e);
+    }
+  std::sort (result.begin(), result.end(), [] (const Entry &a, const Entry &b) {
+      return a.total_usecs > b.total_usecs;
+    });
+  return result;
+}
+
+Profiler::Stats
+Profiler::stats ()
+{
+  ProfilerState &ps = profiler_state();
+  Stats s;
+  std::lock_guard<std::mutex> locker (ps.mutex);
+  s.dropped = ps.dropped;
+  if (ps.reset_blocks)  // not yet picked up by the engine thread
+    return s;
+  s.blocks = ps.blocks;
+  s.xruns = ps.xruns + ps.device_xruns;
+  s.dsp_load = ps.load;
+  s.dsp_load_max = ps.load_max;
+  s.dsp_load_avg = s.blocks ? ps.load_sum / s.blocks : 0;
+  return s;
+}
+
+void
+Profiler::reset ()
+{
+  ProfilerState &ps = profiler_state();
+  collect();            // discard pending samples
+  std::lock_guard<std::mutex> locker (ps.mutex);
+  for (auto &pair : ps.entries)
+    delete pair.second;
+  ps.entries.clear();
+  ps.dropped = 0;
+  ps.reset_blocks = true; // engine thread owns the block counters
+  PDEBUG ("reset");
+}
+
+} // Bse
@@ -0,0 +1,64 @@
+// Licensed GNU LGPL v2.1 or later: http://www.gnu.org/licenses/lgpl.html
+#ifndef __BSE_PROFILER_HH__
+#define __BSE_PROFILER_HH__
+
+#include <bse/bcore.hh>
+#include <typeinfo>
+#if defined (__x86_64__) || defined (__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace Bse {
+
+/** Engine-wide real-time profiler.
+ * Render threads stamp the processing time of engine modules and AudioSignal::Processor
+ * objects into per-thread lock-free buffers, which are allocated by register_thread() when
+ * the threads start. The main thread periodically collects these
+ * into per-object histograms. DSP load and xrun counters are kept per rendered block and
+ * are published to shared memory if a telemetry block is assigned, see ProfilerField.
+ */
+class Profiler {
+public:
+  typedef uint64 Ticks;
+  struct Entry {
+    String name;                ///< Implementation type and instance address.
+    uint64 count = 0;           ///< Number of samples, usually rendered blocks.
+    double p50_usecs = 0;       ///< Median duration.
+    double p99_usecs = 0;       ///< 99th percentile of the duration.
+    double max_usecs = 0;       ///< Maximum duration.
+    double total_usecs = 0;     ///< Accumulated duration.
+  };
+  struct Stats {
+    uint64 blocks = 0;          ///< Number of blocks rendered by the engine.
+    uint64 xruns = 0;           ///< Blocks that missed their deadline plus device xruns.
+    uint64 dropped = 0;         ///< Samples lost due to full per-thread buffers.
+    double dsp_load = 0;        ///< Fraction of the block period used for the last block.
+    double dsp_load_avg = 0;    ///< Average DSP load since the last reset.
+    double dsp_load_max = 0;    ///< Maximum DSP load since the last reset.
+  };
+  static Ticks  ticks         ();       ///< Cheap, monotonic time stamp for record().
+  static void   register_thread ();     ///< Allocate the sample buffer of a render thread, call at thread start.
+  static void   record        (const void *object, const std::type_info &type, const void *code, Ticks start, Ticks end);
+  static void   record_block  (uint64 busy_ns, uint64 period_ns);
+  static void   count_xrun    ();       ///< Count device under- or overruns.
+  static void   set_telemetry (char *mem);      ///< Publish ProfilerField values at `mem`, UserThread only.
+  static void   collect       ();       ///< Fold per-thread samples into histograms, UserThread only.
+  static std::vector<Entry> entries (); ///< Collect and list histogram summaries, most expensive first.
+  static Stats  stats         ();       ///< Retrieve DSP load and xrun counters.
+  static void   reset         ();       ///< Clear histograms and counters.
+};
+
+/// Return a CPU time stamp counter (TSC) if available, or timestamp_benchmark().
+inline Profiler::Ticks
+Profiler::ticks ()
+{
+#if defined (__x86_64__) || defined (__i386__)
+  return __rdtsc();
+#else
+  return timestamp_benchmark();
+#endif
+}
+
+} // Bse
+
+#endif // __BSE_PROFILER_HH__
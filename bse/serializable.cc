@@ -2,6 +2,7 @@
 #include "serializable.hh"
 #include "pugixml.hh"
 #include "internal.hh"
+#include <charconv>
 
 namespace Bse {
 namespace Xms {
@@ -486,6 +487,144 @@ Reflink::load_xml (SerializationNode &xs, const String &attrib)
   return true;
 }
 
+// XmlWriter
+XmlWriter::XmlWriter (String &output) :
+  out_ (output)
+{
+  tags_.reserve (16);
+}
+
+XmlWriter::~XmlWriter ()
+{
+  while (!tags_.empty())
+    end();
+}
+
+void
+XmlWriter::indent ()
+{
+  out_ += '\n';
+  out_.append (2 * tags_.size(), ' ');
+}
+
+void
+XmlWriter::escape (const char *text, size_t length)
+{
+  const char *const end = text + length;
+  const char *last = text;
+  for (const char *c = text; c < end; c++)
+    {
+      const char *entity;
+      switch (*c)
+        {
+        case '&':  entity = "&amp;";  break;
+        case '<':  entity = "&lt;";   break;
+        case '>':  entity = "&gt;";   break;
+        case '"':  entity = "&quot;"; break;
+        case '\n': entity = "&#10;";  break;   // preserve whitespace in attributes
+        case '\r': entity = "&#13;";  break;
+        case '\t': entity = "&#9;";   break;
+        default:   continue;
+        }
+      out_.append (last, c - last);
+      out_ += entity;
+      last = c + 1;
+    }
+  out_.append (last, end - last);
+}
+
+void
+XmlWriter::begin (const char *tag)
+{
+  children();
+  if (!out_.empty())
+    indent();
+  out_ += '<';
+  out_ += tag;
+  tags_.push_back (tag);
+  open_ = true;
+}
+
+void
+XmlWriter::end ()
+{
+  assert_return (!tags_.empty());
+  const char *tag = tags_.back();
+  tags_.pop_back();
+  if (open_)
+    out_ += "/>";
+  else
+    {
+      indent();
+      out_ += "</";
+      out_ += tag;
+      out_ += '>';
+    }
+  open_ = false;
+}
+
+void
+XmlWriter::children ()
+{
+  if (open_)
+    out_ += '>';
+  open_ = false;
+}
+
+void
+XmlWriter::value (const char *name, const char *text, size_t length)
+{
+  assert_return (!tags_.empty());
+  if (open_)
+    {
+      out_ += ' ';
+      out_ += name;
+      out_ += "=\"";
+      escape (text, length);
+      out_ += '"';
+    }
+  else  // attributes are closed after the first child, load_string() also accepts <name>text</name>
+    {
+      indent();
+      out_ += '<';
+      out_ += name;
+      out_ += '>';
+      escape (text, length);
+      out_ += "</";
+      out_ += name;
+      out_ += '>';
+    }
+}
+
+void
+XmlWriter::save_int (const char *name, int64 v)
+{
+  char buffer[32];
+  const std::to_chars_result r = std::to_chars (buffer, buffer + sizeof (buffer), v);
+  value (name, buffer, r.ptr - buffer);
+}
+
+void
+XmlWriter::save_uint (const char *name, uint64 v)
+{
+  char buffer[32];
+  const std::to_chars_result r = std::to_chars (buffer, buffer + sizeof (buffer), v);
+  value (name, buffer, r.ptr - buffer);
+}
+
+void
+XmlWriter::save_float (const char *name, double v, int digits)
+{
+  // matches string_from_double() and string_from_float()
+  if (std::isnan (v))
+    return value (name, std::signbit (v) ? "-NaN" : "+NaN");
+  if (std::isinf (v))
+    return value (name, std::signbit (v) ? "-Infinity" : "+Infinity");
+  char buffer[64];
+  const int l = snprintf (buffer, sizeof (buffer), "%.*g", digits, v); // POSIX locale is in effect
+  value (name, buffer, l);
+}
+
 // == Helpers ==
 bool
 typedata_is_loadable (const StringVector &typedata, const std::string &field)
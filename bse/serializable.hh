@@ -119,12 +119,40 @@ public:
   bool     load_xml (SerializationNode &xs, const String &attrib);
 };
 
+/// Streaming XML output for compile-time reflected types, bypasses the SerializationNode tree.
+class XmlWriter {
+  String                  &out_;
+  std::vector<const char*> tags_;
+  bool                     open_ = false;       // start tag still accepts attributes
+  Lib::ScopedPosixLocale   posix_locale_scope_; // locale independent number formatting
+  void        indent      ();
+  void        escape      (const char *text, size_t length);
+public:
+  explicit    XmlWriter   (String &output);     ///< Append XML to `output`.
+  /*dtor*/   ~XmlWriter   ();                   ///< End all open elements.
+  void        begin       (const char *tag);    ///< Start element `tag`, the string must outlive end().
+  void        end         ();                   ///< End the current element.
+  void        children    ();                   ///< Close the start tag, values become child nodes from here on.
+  void        value       (const char *name, const char *text, size_t length); ///< Write attribute or child text node.
+  void        value       (const char *name, const char *text) { value (name, text, strlen (text)); }
+  void        save_int    (const char *name, int64 v);
+  void        save_uint   (const char *name, uint64 v);
+  void        save_float  (const char *name, double v, int digits);
+  bool        save        (const char *name, String &v, const StringVector &typedata = StringVector(), const std::string &fieldname = "");
+  template<typename T>
+  bool        save        (const char *name, std::vector<T> &vec, const StringVector &typedata = StringVector(), const std::string &fieldname = "");
+  template<typename T>
+  bool        save        (const char *name, T &v, const StringVector &typedata = StringVector(), const std::string &fieldname = ""); ///< Serialize `v` via DataConverter<T>::save_stream().
+  BSE_CLASS_NON_COPYABLE (XmlWriter);
+};
+
 /// Template to specialize XML attribute conversion for various data types.
 template<typename T, typename = void>
 struct DataConverter {
   static_assert (!sizeof (T), "type serialization unimplemented");
   // bool save_xml (SerializationField field, const T&, const StringVector&, const std::string&);
   // bool load_xml (SerializationField field, T&, const StringVector&, const std::string&);
+  // void save_stream (XmlWriter &xw, const char *name, T&);
 };
 
 /// Helper for deferred xml_reflink() calls
@@ -281,6 +309,40 @@ SerializationNode::save_under (const String &tag, T &object)
   xc.save (object);
 }
 
+// XmlWriter
+inline bool
+XmlWriter::save (const char *name, String &v, const StringVector &typedata, const std::string &fieldname)
+{
+  if (!typedata_is_storable (typedata, fieldname))
+    return false;
+  value (name, v.data(), v.size());
+  return true;
+}
+
+template<typename T> bool
+XmlWriter::save (const char *name, std::vector<T> &vec, const StringVector &typedata, const std::string &fieldname)
+{
+  if (!typedata_is_storable (typedata, fieldname))
+    return false;
+  static const bool item_storable = typedata_is_storable (Aida::typedata_from_type (vec), "0");
+  begin (name);
+  children();                                   // force nodes, XML has no repeating attributes
+  if (item_storable)
+    for (auto &el : vec)
+      save ("item", el);
+  end();
+  return true;
+}
+
+template<typename T> bool
+XmlWriter::save (const char *name, T &v, const StringVector &typedata, const std::string &fieldname)
+{
+  if (!typedata_is_storable (typedata, fieldname))
+    return false;
+  DataConverter<T>::save_stream (*this, name, v);
+  return true;
+}
+
 // DataConverter
 template<typename T>
 struct DataConverter<T, typename ::std::enable_if<
@@ -324,6 +386,18 @@ struct DataConverter<T, typename ::std::enable_if<
       str = string_from_type<T> (i);
     return field.serialize (str, typedata, fieldname);
   }
+  static void
+  save_stream (XmlWriter &xw, const char *name, T i)
+  {
+    if (std::is_same<bool, T>::value)
+      xw.value (name, i ? "true" : "false");
+    else if (std::is_floating_point<T>::value)
+      xw.save_float (name, i, sizeof (T) == sizeof (float) ? 7 : 17);
+    else if (std::is_unsigned<T>::value)
+      xw.save_uint (name, i);
+    else
+      xw.save_int (name, i);
+  }
 };
 
 // Aida::enum_* convertibles
@@ -346,6 +420,12 @@ struct DataConverterAidaEnum {
     String valuename = Aida::enum_value_to_string (val);
     return field.serialize (valuename, typedata, fieldname);
   }
+  static void
+  save_stream (XmlWriter &xw, const char *name, Enum val)
+  {
+    const String valuename = Aida::enum_value_to_string (val);
+    xw.value (name, valuename.data(), valuename.size());
+  }
 };
 template<> struct DataConverter<Bse::Error> : DataConverterAidaEnum<Bse::Error> {};
 
@@ -383,6 +463,35 @@ struct DataConverterAidaVisitRecord {
     });
     return true;
   }
+  static void
+  save_stream (XmlWriter &xw, const char *name, Record &rec)
+  {
+    const std::vector<bool> &storable = storable_fields();
+    size_t i = 0;
+    xw.begin (name);
+    rec.__visit__ ([&xw,&storable,&i] (auto &v, const char *n)
+    {
+      if (storable[i++])
+        xw.save (n, v);
+    });
+    xw.end();
+  }
+  // typedata hints are constant per Record, so look them up once instead of per field and save
+  static const std::vector<bool>&
+  storable_fields ()
+  {
+    static const std::vector<bool> storable = [] () {
+      Record rec;
+      const auto &rec_typedata = Aida::typedata_from_type (rec);
+      std::vector<bool> fields;
+      rec.__visit__ ([&rec_typedata,&fields] (auto &v, const char *n)
+      {
+        fields.push_back (typedata_is_storable (rec_typedata, n));
+      });
+      return fields;
+    } ();
+    return storable;
+  }
 };
 template<typename T>
 struct DataConverter<T, typename ::std::enable_if<
@@ -4,6 +4,7 @@
 #include "sfiserial.hh"
 #include "sfiparams.hh"
 #include "path.hh"
+#include "gslfilehash.hh"
 #include "internal.hh"
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -50,6 +51,8 @@ sfi_wstore_destroy (SfiWStore *wstore)
         bblock->destroy (bblock->data);
       g_free (bblock);
     }
+  if (wstore->values)
+    sfi_seq_unref (wstore->values);
   g_free (wstore);
 }
 
@@ -176,7 +179,13 @@ sfi_wstore_put_param (SfiWStore	   *wstore,
 	    Bse::info ("fixing up value for \"%s\" of type `%s'",
                        pspec->name, g_type_name (G_VALUE_TYPE (&svalue)));
 	}
-      sfi_value_store_param (&svalue, gstring, spspec, wstore->indent);
+      if (wstore->values)       /* binary mode: keep value, reference by index */
+        {
+          sfi_value_copy_deep (&svalue, sfi_seq_append_empty (wstore->values, G_VALUE_TYPE (&svalue)));
+          g_string_printf (gstring, "(%s @%u)", pspec->name, sfi_seq_length (wstore->values) - 1);
+        }
+      else
+        sfi_value_store_param (&svalue, gstring, spspec, wstore->indent);
       sfi_wstore_break (wstore);
       sfi_wstore_puts (wstore, gstring->str);
       g_string_free (gstring, TRUE);
@@ -224,6 +233,43 @@ sfi_wstore_peek_text (SfiWStore      *wstore,
   return wstore->text->str;
 }
 
+/**
+ * @param wstore	a writable store
+ *
+ * Switch @a wstore to binary value mode. Parameters subsequently added
+ * with sfi_wstore_put_param() are kept as native values in a value table
+ * and only referenced by index from the text, which avoids formatting
+ * and re-parsing of values and preserves them exactly. Such a store
+ * cannot be flushed to a file, its text needs to be read back by an
+ * #SfiRStore that was handed the value table via sfi_rstore_input_values().
+ */
+void
+sfi_wstore_use_values (SfiWStore *wstore)
+{
+  assert_return (wstore != NULL);
+  assert_return (wstore->flushed == FALSE);
+
+  if (!wstore->values)
+    wstore->values = sfi_seq_new ();
+}
+
+/**
+ * @param wstore	a writable store
+ * @return		the value table or NULL
+ *
+ * Hand over ownership of the value table collected in binary value mode,
+ * see sfi_wstore_use_values(). The store continues in text mode.
+ */
+SfiSeq*
+sfi_wstore_steal_values (SfiWStore *wstore)
+{
+  assert_return (wstore != NULL, NULL);
+
+  SfiSeq *values = wstore->values;
+  wstore->values = NULL;
+  return values;
+}
+
 gint /* -errno */
 sfi_wstore_flush_fd (SfiWStore *wstore,
 		     gint      fd)
@@ -236,6 +282,7 @@ sfi_wstore_flush_fd (SfiWStore *wstore,
 
   assert_return (wstore != NULL, -EINVAL);
   assert_return (wstore->flushed == FALSE, -EINVAL);
+  assert_return (wstore->values == NULL, -EINVAL);
   assert_return (fd >= 0, -EINVAL);
 
   wstore->flushed = TRUE;
@@ -352,16 +399,42 @@ sfi_rstore_new (void)
 SfiRStore*
 sfi_rstore_new_open (const gchar *fname)
 {
-  size_t length = 0;
-  char *text = Bse::Path::memread (fname, &length);
-  if (!text || length < 1)
+  /* only the text up to and including the '\0' that starts a binary appendix is
+   * read, appendix data is accessed through data handles, fname may also name a
+   * window opened with gsl_hfile_open_window()
+   */
+  GslHFile *hfile = gsl_hfile_open (fname);
+  if (!hfile)
     return NULL; // pass errno
+  const GslLong zoffset = gsl_hfile_zoffset (hfile);
+  const size_t length = zoffset >= 0 ? zoffset + 1 : hfile->n_bytes;
+  char *text = (char*) malloc (length + 1);
+  size_t n = 0;
+  while (text && n < length)
+    {
+      const GslLong l = gsl_hfile_pread (hfile, n, length - n, text + n);
+      if (l < 0 && errno == EINTR)
+        continue;
+      if (l <= 0)
+        break;
+      n += l;
+    }
+  const int saved_errno = errno;
+  gsl_hfile_close (hfile);
+  errno = saved_errno;
+  if (!text || n < 1)
+    {
+      free (text);              // Bse::Path::memfree() compatible
+      errno = text ? EIO : ENOMEM;
+      return NULL;
+    }
+  text[n] = 0;
   SfiRStore *rstore = sfi_rstore_new ();
   rstore->fname = g_strdup (fname);
   rstore->scanner->input_name = rstore->fname;
   rstore->scanner->parse_errors = 0;
   rstore->textstart_ = text;
-  g_scanner_input_text (rstore->scanner, text, length);
+  g_scanner_input_text (rstore->scanner, text, n);
   return rstore;
 }
 
@@ -375,6 +448,8 @@ sfi_rstore_destroy (SfiRStore *rstore)
   g_scanner_destroy (rstore->scanner);
   if (rstore->textstart_)
     Bse::Path::memfree (rstore->textstart_);
+  if (rstore->values)
+    sfi_seq_unref (rstore->values);
   g_free (rstore->fname);
   g_free (rstore);
 }
@@ -394,6 +469,26 @@ sfi_rstore_input_text (SfiRStore   *rstore,
   g_scanner_input_text (rstore->scanner, text, strlen (text));
 }
 
+/**
+ * @param rstore	a readable store
+ * @param values	value table or NULL
+ *
+ * Provide the value table for parameters that were written in binary value
+ * mode, see sfi_wstore_use_values(). The table is referenced by @a rstore.
+ */
+void
+sfi_rstore_input_values (SfiRStore *rstore,
+                         SfiSeq    *values)
+{
+  assert_return (rstore != NULL);
+
+  if (values)
+    sfi_seq_ref (values);
+  if (rstore->values)
+    sfi_seq_unref (rstore->values);
+  rstore->values = values;
+}
+
 gboolean
 sfi_rstore_eof (SfiRStore *rstore)
 {
@@ -486,6 +581,29 @@ sfi_rstore_warn_skip (SfiRStore *rstore, const std::string &msg)
   return scanner_skip_statement (rstore->scanner, 1);
 }
 
+static GTokenType
+rstore_parse_value_ref (SfiRStore  *rstore,
+                        GValue     *pvalue,
+                        GParamSpec *spspec)
+{
+  GScanner *scanner = rstore->scanner;
+  g_scanner_get_next_token (scanner);   /* eat '@' */
+  if (g_scanner_get_next_token (scanner) != G_TOKEN_INT)
+    return G_TOKEN_INT;
+  const guint64 index = scanner->value.v_int64;
+  if (index >= sfi_seq_length (rstore->values))
+    {
+      sfi_rstore_error (rstore, Bse::string_format ("invalid value reference: @%u", uint (index)));
+      return G_TOKEN_ERROR;
+    }
+  if (g_scanner_get_next_token (scanner) != ')')
+    return GTokenType (')');
+  const GValue *svalue = sfi_seq_get (rstore->values, index);
+  g_value_init (pvalue, G_VALUE_TYPE (svalue));
+  sfi_value_copy_deep (svalue, pvalue);
+  return G_TOKEN_NONE;
+}
+
 GTokenType
 sfi_rstore_parse_param (SfiRStore  *rstore,
 			GValue     *value,
@@ -507,7 +625,10 @@ sfi_rstore_parse_param (SfiRStore  *rstore,
       return G_TOKEN_ERROR;
     }
 
-  token = sfi_value_parse_param_rest (&pvalue, rstore->scanner, spspec);
+  if (rstore->values && g_scanner_peek_next_token (rstore->scanner) == '@')
+    token = rstore_parse_value_ref (rstore, &pvalue, spspec);
+  else
+    token = sfi_value_parse_param_rest (&pvalue, rstore->scanner, spspec);
   if (token == G_TOKEN_NONE)
     {
       if (sfi_value_transform (&pvalue, value))
@@ -748,4 +869,34 @@ bse_test_scanner64 (void)
   g_scanner_destroy (scanner);
 }
 
+BSE_INTEGRITY_TEST (bse_test_store_values);
+static void
+bse_test_store_values (void)
+{
+  GParamSpec *pspec = g_param_spec_ref_sink (sfi_pspec_real ("vreal", NULL, NULL, 0, -1e300, +1e300, 1, SFI_PARAM_STANDARD));
+  GValue value = { 0, }, rvalue = { 0, };
+  g_value_init (&value, SFI_TYPE_REAL);
+  sfi_value_set_real (&value, 1.0 / 3.0);
+  SfiWStore *wstore = sfi_wstore_new();
+  sfi_wstore_use_values (wstore);
+  sfi_wstore_put_param (wstore, &value, pspec);
+  SfiSeq *values = sfi_wstore_steal_values (wstore);
+  TASSERT (values && sfi_seq_length (values) == 1);
+  SfiRStore *rstore = sfi_rstore_new();
+  sfi_rstore_input_text (rstore, sfi_wstore_peek_text (wstore, NULL), "<values>");
+  sfi_rstore_input_values (rstore, values);
+  sfi_seq_unref (values);
+  TASSERT (g_scanner_get_next_token (rstore->scanner) == '(');
+  TASSERT (g_scanner_get_next_token (rstore->scanner) == G_TOKEN_IDENTIFIER);
+  g_value_init (&rvalue, SFI_TYPE_REAL);
+  TASSERT (sfi_rstore_parse_param (rstore, &rvalue, pspec) == G_TOKEN_NONE);
+  TASSERT (sfi_value_get_real (&rvalue) == 1.0 / 3.0);
+  TASSERT (g_scanner_get_next_token (rstore->scanner) == G_TOKEN_EOF);
+  sfi_rstore_destroy (rstore);
+  sfi_wstore_destroy (wstore);
+  g_value_unset (&rvalue);
+  g_value_unset (&value);
+  g_param_spec_unref (pspec);
+}
+
 } // Anon
@@ -14,6 +14,7 @@ typedef struct
   GString *text;
   guint    indent;
   SfiRing *bblocks;
+  SfiSeq  *values;      /* binary value table, NULL for plain text */
   guint    needs_break : 1;
   guint    flushed : 1;
   gchar    comment_start;
@@ -33,6 +34,7 @@ struct _SfiRStore
   gpointer       parser_this;
   SfiNum         bin_offset;
   char          *textstart_;
+  SfiSeq        *values;
 };
 
 
@@ -62,6 +64,8 @@ gint /*-errno*/ sfi_wstore_flush_fd           (SfiWStore      *wstore,
                                                gint            fd);
 const gchar*    sfi_wstore_peek_text          (SfiWStore      *wstore,
                                                guint          *length);
+void            sfi_wstore_use_values         (SfiWStore      *wstore);
+SfiSeq*         sfi_wstore_steal_values       (SfiWStore      *wstore);
 
 
 /* --- readable store --- */
@@ -71,6 +75,8 @@ void            sfi_rstore_destroy            (SfiRStore      *rstore);
 void            sfi_rstore_input_text         (SfiRStore      *rstore,
                                                const gchar    *text,
                                                const gchar    *text_name);
+void            sfi_rstore_input_values       (SfiRStore      *rstore,
+                                               SfiSeq         *values);
 gboolean        sfi_rstore_eof                (SfiRStore      *rstore);
 GTokenType      sfi_rstore_parse_param        (SfiRStore      *rstore,
                                                GValue         *value,
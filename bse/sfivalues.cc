@@ -4,6 +4,7 @@
 #include "sfiparams.hh"
 #include "sfimemory.hh"
 #include "bse/internal.hh"
+#include <string.h>
 
 
 /* --- variables --- */
@@ -366,6 +367,137 @@ sfi_value_copy_deep (const GValue *src_value,
     }
 }
 
+/**
+ * @param value1	first value
+ * @param value2	second value
+ * @return		TRUE if both values hold the same type and contents
+ *
+ * Compare two values, recursing into sequences and records. Values of
+ * categories without a defined comparison are considered different.
+ */
+gboolean
+sfi_value_equal_deep (const GValue *value1,
+                      const GValue *value2)
+{
+  assert_return (G_IS_VALUE (value1), FALSE);
+  assert_return (G_IS_VALUE (value2), FALSE);
+
+  if (G_VALUE_TYPE (value1) != G_VALUE_TYPE (value2))
+    return FALSE;
+  SfiSCategory scat = SfiSCategory (sfi_categorize_type (G_VALUE_TYPE (value1)) & SFI_SCAT_TYPE_MASK);
+  switch (scat)
+    {
+    case SFI_SCAT_BOOL:
+      return sfi_value_get_bool (value1) == sfi_value_get_bool (value2);
+    case SFI_SCAT_INT:
+      return sfi_value_get_int (value1) == sfi_value_get_int (value2);
+    case SFI_SCAT_NUM:
+      return sfi_value_get_num (value1) == sfi_value_get_num (value2);
+    case SFI_SCAT_REAL:
+      return sfi_value_get_real (value1) == sfi_value_get_real (value2);
+    case SFI_SCAT_STRING:
+      return g_strcmp0 (sfi_value_get_string (value1), sfi_value_get_string (value2)) == 0;
+    case SFI_SCAT_CHOICE:
+      return g_strcmp0 (sfi_value_get_choice (value1), sfi_value_get_choice (value2)) == 0;
+    case SFI_SCAT_PSPEC:
+      return sfi_value_get_pspec (value1) == sfi_value_get_pspec (value2);
+    case SFI_SCAT_BBLOCK:
+      {
+        const SfiBBlock *b1 = sfi_value_get_bblock (value1), *b2 = sfi_value_get_bblock (value2);
+        if (!b1 || !b2)
+          return b1 == b2;
+        return b1->n_bytes == b2->n_bytes && memcmp (b1->bytes, b2->bytes, b1->n_bytes) == 0;
+      }
+    case SFI_SCAT_FBLOCK:
+      {
+        const SfiFBlock *f1 = sfi_value_get_fblock (value1), *f2 = sfi_value_get_fblock (value2);
+        if (!f1 || !f2)
+          return f1 == f2;
+        return f1->n_values == f2->n_values && memcmp (f1->values, f2->values, f1->n_values * sizeof (f1->values[0])) == 0;
+      }
+    case SFI_SCAT_SEQ:
+      {
+        const SfiSeq *q1 = sfi_value_get_seq (value1), *q2 = sfi_value_get_seq (value2);
+        if (!q1 || !q2)
+          return q1 == q2;
+        if (q1->n_elements != q2->n_elements)
+          return FALSE;
+        for (guint i = 0; i < q1->n_elements; i++)
+          if (!sfi_value_equal_deep (q1->elements + i, q2->elements + i))
+            return FALSE;
+        return TRUE;
+      }
+    case SFI_SCAT_REC:
+      {
+        const SfiRec *r1 = sfi_value_get_rec (value1), *r2 = sfi_value_get_rec (value2);
+        if (!r1 || !r2)
+          return r1 == r2;
+        if (r1->n_fields != r2->n_fields)
+          return FALSE;
+        for (guint i = 0; i < r1->n_fields; i++)
+          if (strcmp (r1->field_names[i], r2->field_names[i]) != 0 ||
+              !sfi_value_equal_deep (r1->fields + i, r2->fields + i))
+            return FALSE;
+        return TRUE;
+      }
+    default:
+      return FALSE;
+    }
+}
+
+/**
+ * @param value		a value
+ * @return		approximate number of bytes occupied by @a value
+ *
+ * Estimate the memory held by a value, including strings, blocks and
+ * the elements of sequences and records.
+ */
+gsize
+sfi_value_bytes_deep (const GValue *value)
+{
+  assert_return (G_IS_VALUE (value), 0);
+
+  gsize n_bytes = sizeof (*value);
+  SfiSCategory scat = SfiSCategory (sfi_categorize_type (G_VALUE_TYPE (value)) & SFI_SCAT_TYPE_MASK);
+  switch (scat)
+    {
+    case SFI_SCAT_STRING:
+    case SFI_SCAT_CHOICE:
+      {
+        const gchar *string = g_value_get_string (value);
+        if (string)
+          n_bytes += strlen (string) + 1;
+      }
+      break;
+    case SFI_SCAT_BBLOCK:
+      if (const SfiBBlock *bblock = sfi_value_get_bblock (value))
+        n_bytes += sizeof (*bblock) + bblock->n_bytes;
+      break;
+    case SFI_SCAT_FBLOCK:
+      if (const SfiFBlock *fblock = sfi_value_get_fblock (value))
+        n_bytes += sizeof (*fblock) + fblock->n_values * sizeof (fblock->values[0]);
+      break;
+    case SFI_SCAT_SEQ:
+      if (const SfiSeq *seq = sfi_value_get_seq (value))
+        {
+          n_bytes += sizeof (*seq);
+          for (guint i = 0; i < seq->n_elements; i++)
+            n_bytes += sfi_value_bytes_deep (seq->elements + i);
+        }
+      break;
+    case SFI_SCAT_REC:
+      if (const SfiRec *rec = sfi_value_get_rec (value))
+        {
+          n_bytes += sizeof (*rec);
+          for (guint i = 0; i < rec->n_fields; i++)
+            n_bytes += sizeof (rec->field_names[i]) + strlen (rec->field_names[i]) + 1 + sfi_value_bytes_deep (rec->fields + i);
+        }
+      break;
+    default: ;
+    }
+  return n_bytes;
+}
+
 
 /* --- Sfi value constructors --- */
 static GValue*
@@ -1072,4 +1204,33 @@ bse_test_pspec_serialization ()
   test_typed_serialization (SERIAL_TEST_PSPEC);
 }
 
+BSE_INTEGRITY_TEST (bse_test_value_equal_deep);
+static void
+bse_test_value_equal_deep ()
+{
+  SfiRec *rec1 = sfi_rec_new(), *rec2;
+  sfi_rec_set_int (rec1, "n", 7);
+  sfi_rec_set_string (rec1, "s", "abc");
+  SfiSeq *seq = sfi_seq_new();
+  sfi_seq_append_real (seq, 0.25);
+  sfi_rec_set_seq (rec1, "q", seq);
+  sfi_seq_unref (seq);
+  rec2 = sfi_rec_copy_deep (rec1);
+  GValue *v1 = sfi_value_rec (rec1), *v2 = sfi_value_rec (rec2);
+  TASSERT (sfi_value_equal_deep (v1, v2));
+  TCMP (sfi_value_bytes_deep (v1), ==, sfi_value_bytes_deep (v2));
+  TCMP (sfi_value_bytes_deep (v1), >, 3 * sizeof (GValue) + strlen ("abc") + 1);
+  sfi_value_set_real (sfi_seq_get (sfi_rec_get_seq (sfi_value_get_rec (v2), "q"), 0), 0.5);
+  TASSERT (!sfi_value_equal_deep (v1, v2));
+  GValue *i1 = sfi_value_int (7), *r1 = sfi_value_real (7);
+  TASSERT (sfi_value_equal_deep (i1, sfi_rec_get (rec1, "n")));
+  TASSERT (!sfi_value_equal_deep (i1, r1));
+  sfi_value_free (i1);
+  sfi_value_free (r1);
+  sfi_value_free (v1);
+  sfi_value_free (v2);
+  sfi_rec_unref (rec1);
+  sfi_rec_unref (rec2);
+}
+
 } // Anon
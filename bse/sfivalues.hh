@@ -89,6 +89,9 @@ void	    sfi_value_take_rec		(GValue         *value,
 void	    sfi_value_copy_deep		(const GValue	*src_value,
 					 GValue		*dest_value);
 #define	    sfi_value_copy_shallow	g_value_copy
+gboolean    sfi_value_equal_deep	(const GValue	*value1,
+					 const GValue	*value2);
+gsize	    sfi_value_bytes_deep	(const GValue	*value);
 
 
 /* --- Sfi value constructors --- */
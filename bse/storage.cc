@@ -4,11 +4,15 @@
 #include "magic.hh"
 #include "minizip.h"
 #include "path.hh"
+#include "gslfilehash.hh"
 #include <stdlib.h>     // mkdtemp
 #include <sys/stat.h>   // mkdir
 #include <unistd.h>     // rmdir
 #include <fcntl.h>      // O_EXCL
+#include <sys/mman.h>   // memfd_create
+#include <zlib.h>
 #include <filesystem>
+#include <condition_variable>
 
 #define SDEBUG(...)     Bse::debug ("storage", __VA_ARGS__)
 
@@ -184,6 +188,288 @@ beastbse_cachedir_cleanup()
         }
 }
 
+// == ZipWriter ==
+/** Streaming ZIP archive writer.
+ * Members are deflated in independent blocks on several threads, each block is primed
+ * with the preceding 32KiB as dictionary so the compression ratio stays close to a serial
+ * deflate. Compressed blocks are appended to the target file in order as they complete,
+ * local headers are patched once a member's size and CRC are known. Blocks that do not
+ * compress, like embedded FLAC or Ogg/Vorbis payloads, are stored verbatim.
+ */
+class ZipWriter {
+  static constexpr size_t BLOCK_SIZE = 1024 * 1024;
+  static constexpr size_t DICT_SIZE = 32 * 1024;
+  static constexpr size_t PROBE_SIZE = 16 * 1024;
+  static constexpr int    LEVEL = Z_DEFAULT_COMPRESSION;
+  struct Entry {
+    String   name;
+    uint16_t method = 0, dostime = 0, dosdate = 0;
+    uint32_t crc = 0;
+    uint64_t csize = 0, usize = 0, offset = 0;
+  };
+  int                fd_ = -1;
+  uint64_t           pos_ = 0;
+  std::vector<Entry> entries_;
+  bool
+  write_all (const void *data, size_t size)
+  {
+    const char *d = (const char*) data;
+    while (size)
+      {
+        const ssize_t l = write (fd_, d, size);
+        if (l < 0 && errno == EINTR)
+          continue;
+        if (l <= 0)
+          return false;
+        d += l;
+        size -= l;
+        pos_ += l;
+      }
+    return true;
+  }
+  static void put16 (String &s, uint16_t v) { s += char (v); s += char (v >> 8); }
+  static void put32 (String &s, uint32_t v) { put16 (s, v); put16 (s, v >> 16); }
+  String
+  local_header (const Entry &e)
+  {
+    String h;
+    put32 (h, 0x04034b50);
+    put16 (h, 20);                      // version needed to extract
+    put16 (h, 0);                       // flags
+    put16 (h, e.method);
+    put16 (h, e.dostime);
+    put16 (h, e.dosdate);
+    put32 (h, e.crc);
+    put32 (h, e.csize);
+    put32 (h, e.usize);
+    put16 (h, e.name.size());
+    put16 (h, 0);                       // extra field length
+    return h + e.name;
+  }
+  static bool
+  deflate_block (const char *data, size_t size, size_t dict, bool last, String &out)
+  {
+    // probe with a fast deflate whether the block is worth compressing
+    int level = LEVEL;
+    z_stream zs = { 0, };
+    if (deflateInit2 (&zs, Z_BEST_SPEED, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      return false;
+    const size_t probe = std::min (size, PROBE_SIZE);
+    out.resize (deflateBound (&zs, probe) + 16);
+    zs.next_in = (Bytef*) data;
+    zs.avail_in = probe;
+    zs.next_out = (Bytef*) &out[0];
+    zs.avail_out = out.size();
+    deflate (&zs, Z_FINISH);
+    if (zs.total_out >= probe - probe / 32)
+      level = Z_NO_COMPRESSION;
+    deflateEnd (&zs);
+    // deflate the whole block, ending in a byte aligned sync flush unless last
+    zs = z_stream { 0, };
+    if (deflateInit2 (&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      return false;
+    int ret = dict ? deflateSetDictionary (&zs, (const Bytef*) data - dict, dict) : Z_OK;
+    out.resize (deflateBound (&zs, size) + 16);
+    zs.next_in = (Bytef*) data;
+    zs.avail_in = size;
+    while (ret == Z_OK)
+      {
+        if (zs.total_out >= out.size())
+          out.resize (out.size() * 2);
+        zs.next_out = (Bytef*) &out[zs.total_out];
+        zs.avail_out = out.size() - zs.total_out;
+        ret = deflate (&zs, last ? Z_FINISH : Z_SYNC_FLUSH);
+        if (ret == Z_OK && zs.avail_in == 0 && zs.avail_out > 0 && !last)
+          break;                        // sync flush completed
+      }
+    out.resize (zs.total_out);
+    deflateEnd (&zs);
+    return last ? ret == Z_STREAM_END : ret == Z_OK;
+  }
+  bool
+  deflate_member (const char *data, size_t size, Entry &entry)
+  {
+    const size_t n_blocks = std::max<size_t> (1, (size + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    const size_t n_threads = std::min<size_t> (n_blocks, std::max (1, this_thread_online_cpus()));
+    const size_t window = 4 * n_threads;        // limits blocks buffered ahead of the writer
+    std::vector<String> outputs (n_blocks);
+    std::vector<uint32_t> crcs (n_blocks);
+    std::vector<char> done (n_blocks, 0);
+    std::mutex mutex;
+    std::condition_variable cond;
+    size_t next = 0, written = 0;
+    bool failed = false;
+    auto compress = [&] (size_t i) {
+      const size_t start = i * BLOCK_SIZE, length = std::min (BLOCK_SIZE, size - start);
+      crcs[i] = crc32 (0, (const Bytef*) data + start, length);
+      return deflate_block (data + start, length, std::min (start, DICT_SIZE), i + 1 == n_blocks, outputs[i]);
+    };
+    auto worker = [&] () {
+      std::unique_lock<std::mutex> lock (mutex);
+      while (next < n_blocks && !failed)
+        {
+          if (next >= written + window)
+            {
+              cond.wait (lock);
+              continue;
+            }
+          const size_t i = next++;
+          lock.unlock();
+          const bool ok = compress (i);
+          lock.lock();
+          done[i] = 1;
+          failed |= !ok;
+          cond.notify_all();
+        }
+    };
+    std::vector<std::thread> threads;
+    if (n_threads > 1)
+      for (size_t t = 0; t < n_threads; t++)
+        threads.emplace_back (worker);
+    uint32_t crc = crc32 (0, NULL, 0);
+    for (size_t i = 0; i < n_blocks; i++)
+      {
+        String out;
+        if (threads.empty())
+          {
+            failed = !compress (i);
+            if (failed)
+              break;
+            out.swap (outputs[i]);
+          }
+        else
+          {
+            std::unique_lock<std::mutex> lock (mutex);
+            while (!done[i] && !failed)
+              cond.wait (lock);
+            if (failed)
+              break;
+            out.swap (outputs[i]);
+            written = i + 1;
+            cond.notify_all();
+          }
+        const size_t length = std::min (BLOCK_SIZE, size - i * BLOCK_SIZE);
+        crc = crc32_combine (crc, crcs[i], length);
+        entry.csize += out.size();
+        if (!write_all (out.data(), out.size()))
+          {
+            std::lock_guard<std::mutex> locker (mutex);
+            failed = true;
+            cond.notify_all();
+            break;
+          }
+      }
+    for (auto &thread : threads)
+      thread.join();
+    entry.crc = crc;
+    return !failed;
+  }
+public:
+  /*dtor*/ ~ZipWriter() { if (fd_ >= 0) ::close (fd_); }
+  bool
+  open (const String &filename)
+  {
+    fd_ = ::open (filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    return fd_ >= 0;
+  }
+  /// Append member @a name, @a store members are not compressed.
+  bool
+  add (const String &name, const char *data, size_t size, bool store, time_t mtime)
+  {
+    errno = EFBIG;
+    if (size >= 0xffffffff || pos_ >= 0xffffffff)       // ZIP64 is not supported
+      return false;
+    Entry entry;
+    entry.name = name;
+    entry.method = store ? 0 : 8;
+    entry.usize = size;
+    entry.offset = pos_;
+    struct tm tm = { 0, };
+    localtime_r (&mtime, &tm);
+    entry.dostime = (tm.tm_hour << 11) | (tm.tm_min << 5) | (tm.tm_sec >> 1);
+    entry.dosdate = (std::max (0, tm.tm_year - 80) << 9) | ((tm.tm_mon + 1) << 5) | tm.tm_mday;
+    if (store)
+      {
+        entry.crc = crc32 (crc32 (0, NULL, 0), (const Bytef*) data, size);
+        entry.csize = size;
+        const String header = local_header (entry);
+        if (!write_all (header.data(), header.size()) || !write_all (data, size))
+          return false;
+      }
+    else
+      {
+        const String placeholder = local_header (entry);
+        if (!write_all (placeholder.data(), placeholder.size()) ||
+            !deflate_member (data, size, entry))
+          return false;
+        errno = EFBIG;
+        if (entry.csize >= 0xffffffff)
+          return false;
+        const String header = local_header (entry);
+        if (pwrite (fd_, header.data(), header.size(), entry.offset) != ssize_t (header.size()))
+          return false;
+      }
+    entries_.push_back (entry);
+    return true;
+  }
+  /// Write the central directory and close the archive.
+  bool
+  close ()
+  {
+    const uint64_t cd_offset = pos_;
+    String cd;
+    for (const Entry &e : entries_)
+      {
+        put32 (cd, 0x02014b50);
+        put16 (cd, (3 << 8) | 20);      // made by UNIX, ZIP 2.0
+        put16 (cd, 20);                 // version needed to extract
+        put16 (cd, 0);                  // flags
+        put16 (cd, e.method);
+        put16 (cd, e.dostime);
+        put16 (cd, e.dosdate);
+        put32 (cd, e.crc);
+        put32 (cd, e.csize);
+        put32 (cd, e.usize);
+        put16 (cd, e.name.size());
+        put16 (cd, 0);                  // extra field length
+        put16 (cd, 0);                  // comment length
+        put16 (cd, 0);                  // disk number
+        put16 (cd, 0);                  // internal attributes
+        put32 (cd, 0100644 << 16);      // external attributes
+        put32 (cd, e.offset);
+        cd += e.name;
+      }
+    String eocd;
+    put32 (eocd, 0x06054b50);
+    put16 (eocd, 0);
+    put16 (eocd, 0);
+    put16 (eocd, entries_.size());
+    put16 (eocd, entries_.size());
+    put32 (eocd, cd.size());
+    put32 (eocd, cd_offset);
+    put16 (eocd, 0);                    // comment length
+    errno = EFBIG;
+    if (pos_ + cd.size() >= 0xffffffff)
+      return false;
+    const bool ok = write_all (cd.data(), cd.size()) && write_all (eocd.data(), eocd.size());
+    const int fd = fd_;
+    fd_ = -1;
+    return ::close (fd) == 0 && ok;
+  }
+};
+
+/// Check if @a filename refers to data that is compressed already, e.g. FLAC or Ogg/Vorbis.
+static bool
+member_is_compressed (const String &filename)
+{
+  static const char *const extensions[] = { ".flac", ".ogg", ".opus", ".mp3", ".png", ".jpg", ".zip", ".gz", ".bz2", ".xz", ".zst" };
+  const String lname = string_tolower (filename);
+  for (const char *ext : extensions)
+    if (string_endswith (lname, ext))
+      return true;
+  return false;
+}
+
 Storage::Storage () :
   impl_ (std::make_shared<Storage::Impl>())
 {}
@@ -192,8 +478,69 @@ Storage::~Storage ()
 {}
 
 class Storage::Impl {
+  // members to export are kept in memory, either as buffer or as memfd written by the caller
+  struct Member {
+    String  name;
+    String  data;
+    int     fd = -1;
+    int64_t mtime = 0;
+  };
+  // members of the archive read by import_from(), extracted or read in place on demand
+  struct ArchiveEntry {
+    String    name;
+    bool      stored = false;   // uncompressed, readable in place
+    bool      extracted = false;
+    int64_t   offset = -1;      // data offset of stored members
+    int64_t   size = 0;
+    GslHFile *window = NULL;
+  };
   String tmpdir_;
-  std::vector<String> members_;
+  std::vector<Member> members_;
+  String archive_;
+  int    archive_fd_ = -1;
+  void  *reader_ = NULL;
+  std::vector<ArchiveEntry> entries_;
+  std::vector<GslHFile*> windows_;
+  ArchiveEntry*
+  find_entry (const String &filename)
+  {
+    for (auto &e : entries_)
+      if (e.name == filename)
+        return &e;
+    return NULL;
+  }
+  void
+  close_archive ()
+  {
+    // windows stay open as long as data handles may refer to them by name
+    for (auto &e : entries_)
+      if (e.window)
+        windows_.push_back (e.window);
+    entries_.clear();
+    if (reader_)
+      {
+        mz_zip_reader_close (reader_);
+        mz_zip_reader_delete (&reader_);
+      }
+    reader_ = NULL;
+    if (archive_fd_ >= 0)
+      close (archive_fd_);
+    archive_fd_ = -1;
+    archive_.clear();
+  }
+  std::vector<Member>::iterator
+  find_member (const String &filename)
+  {
+    return std::find_if (members_.begin(), members_.end(), [&] (const Member &m) { return m.name == filename; });
+  }
+  Member&
+  add_member (const String &filename)
+  {
+    // keep mimetype as first member for 'file(1)'
+    auto it = "mimetype" == filename ? members_.insert (members_.begin(), Member()) : members_.insert (members_.end(), Member());
+    it->name = filename;
+    return *it;
+  }
   String
   tmpdir ()
   {
@@ -204,6 +551,12 @@ class Storage::Impl {
 public:
   ~Impl()
   {
+    for (auto &m : members_)
+      if (m.fd >= 0)
+        close (m.fd);
+    close_archive();
+    for (GslHFile *hfile : windows_)
+      gsl_hfile_close (hfile);
     if (!tmpdir_.empty())
       {
         rmrf_dir (tmpdir_);
@@ -218,17 +571,22 @@ public:
   {
     errno = ENOENT;
     assert_return (!Path::isabs (filename), -1);
-    SDEBUG ("%s: rm=%s first=%s\n", __func__, filename, members_.size() ? members_[0] : "");
+    SDEBUG ("%s: rm=%s first=%s\n", __func__, filename, members_.size() ? members_[0].name : "");
+    bool found = false;
+    auto it = find_member (filename);
+    if (it != members_.end())
+      {
+        if (it->fd >= 0)
+          close (it->fd);
+        members_.erase (it);
+        found = true;
+      }
     if (!tmpdir_.empty())
       {
         std::error_code ec;
-        std::filesystem::remove (tmpdir_ + "/" + filename, ec);
-        auto it = std::find (members_.begin(), members_.end(), filename);
-        if (it != members_.end())
-          members_.erase (it);
-        return !ec;
+        found |= std::filesystem::remove (tmpdir_ + "/" + filename, ec);
       }
-    return false;
+    return found;
   }
   int
   store_file_fd (const String &filename)
@@ -236,43 +594,37 @@ public:
     errno = EINVAL;
     assert_return (!Path::isabs (filename), -1);
     rm_file (filename);
-    const int fd = open ((tmpdir() + "/" + filename).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
-    if (fd >= 0)
+    int fd = memfd_create (filename.c_str(), MFD_CLOEXEC);
+    if (fd < 0)         // fallback for kernels without memfd
       {
-        // keep mimetype as first member for 'file(1)'
-        if ("mimetype" == filename)
-          members_.insert (members_.begin(), filename);
-        else
-          members_.push_back (filename);
+        const String tmpname = tmpdir() + "/" + filename;
+        fd = open (tmpname.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd >= 0)
+          unlink (tmpname.c_str());
       }
-    return fd;
+    if (fd < 0)
+      return -1;
+    const int callerfd = dup (fd);
+    if (callerfd < 0)
+      {
+        const int saved = errno;
+        close (fd);
+        errno = saved;
+        return -1;
+      }
+    add_member (filename).fd = fd;
+    return callerfd;
   }
   bool
   store_file_buffer (const String &filename, const String &data, int64_t epoch_seconds)
   {
-    const int fd = store_file_fd (filename);
-    if (fd >= 0)
-      {
-        long l;
-        do
-          l = write (fd, data.data(), data.size());
-        while (l < 0 && errno == EINTR);
-        if (l >= 0)
-          {
-            struct timespec times[2] = { { 0, 0, }, { 0, 0, }, };
-            times[0].tv_sec = epoch_seconds ? epoch_seconds : time (NULL);
-            times[1].tv_sec = times[0].tv_sec;
-            if (futimens (fd, times) < 0)
-              SDEBUG ("Bse::Storage::%s: %s: futimens: %s\n", __func__, filename, strerror (errno));
-            if (close (fd) >= 0)
-              return true;
-          }
-      }
-    const int saved = errno;
-    close (fd);
+    errno = EINVAL;
+    assert_return (!Path::isabs (filename), false);
     rm_file (filename);
-    errno = saved;
-    return false;
+    Member &m = add_member (filename);
+    m.data = data;
+    m.mtime = epoch_seconds ? epoch_seconds : time (NULL);
+    return true;
   }
   bool
   set_mimetype_bse ()
@@ -281,54 +633,114 @@ public:
     return store_file_buffer ("mimetype", "application/x-bse", bse_project_start);
   }
   bool
+  export_member (ZipWriter &zip, const Member &m)
+  {
+    bool store = (&m == &members_[0] && m.name == "mimetype") || member_is_compressed (m.name);
+    if (m.fd < 0)
+      return zip.add (m.name, m.data.data(), m.data.size(), store, m.mtime);
+    struct stat st;
+    if (fstat (m.fd, &st) < 0)
+      return false;
+    if (st.st_size == 0)
+      return zip.add (m.name, "", 0, store, st.st_mtime);
+    void *mem = mmap (NULL, st.st_size, PROT_READ, MAP_SHARED, m.fd, 0);
+    if (mem == MAP_FAILED)
+      return false;
+    madvise (mem, st.st_size, MADV_SEQUENTIAL);
+    // text with a binary appendix is stored, so sample data can be read in place after import
+    store |= memchr (mem, 0, st.st_size) != NULL;
+    const bool ok = zip.add (m.name, (const char*) mem, st.st_size, store, st.st_mtime);
+    const int saved = errno;
+    munmap (mem, st.st_size);
+    errno = saved;
+    return ok;
+  }
+  bool
   export_as (const String &filename)
   {
-    void *writer = NULL;
-    mz_zip_writer_create (&writer);
-    mz_zip_writer_set_zip_cd (writer, false);
-    mz_zip_writer_set_password (writer, NULL);
-    mz_zip_writer_set_store_links (writer, false);
-    mz_zip_writer_set_follow_links (writer, true);
-    mz_zip_writer_set_compress_level (writer, MZ_COMPRESS_LEVEL_BEST);
-    mz_zip_writer_set_compress_method (writer, MZ_COMPRESS_METHOD_DEFLATE);
-    //mz_zip_file file_info = { 0, };
-    //file_info.version_madeby = BSE_MZ_VERSION_MADEBY; // MZ_VERSION_MADEBY_ZIP_VERSION;
-    //file_info.zip64 = MZ_ZIP64_DISABLE;  // match limagic's ZIP-with-mimetype
-    //file_info.flag = 0; // MZ_ZIP_FLAG_UTF8;
-    //file_info.compression_method = MZ_COMPRESS_METHOD_DEFLATE;
-    int err = mz_zip_writer_open_file (writer, filename.c_str(), 0, false);
-    for (auto it = members_.begin(); err == MZ_OK && it != members_.end(); ++it)
-      {
-        const std::string fname = *it;
-        const bool plain = it == members_.begin() && fname == "mimetype";
-        if (plain)
-          mz_zip_writer_set_compress_method (writer, MZ_COMPRESS_METHOD_STORE);
-        err = mz_zip_writer_add_file (writer, (tmpdir() + "/" + fname).c_str(), fname.c_str());
-        if (plain)
-          mz_zip_writer_set_compress_method (writer, MZ_COMPRESS_METHOD_DEFLATE);
-      }
-    if (err == MZ_OK)
-      err = mz_zip_writer_close (writer);
+    // replace filename only once complete, a previous import may still read from the old file
+    const String tmpname = string_format ("%s.%u~", filename, getpid());
+    ZipWriter zip;
+    bool ok = zip.open (tmpname);
+    if (!ok)
+      return false;
+    for (size_t i = 0; ok && i < members_.size(); i++)
+      ok = export_member (zip, members_[i]);
+    ok = zip.close() && ok;
+    ok = ok && rename (tmpname.c_str(), filename.c_str()) == 0;
     const int saved_errno = errno;
-    if (err != MZ_OK)
-      unlink (filename.c_str());
-    mz_zip_writer_delete (&writer);
+    if (!ok)
+      unlink (tmpname.c_str());
     errno = saved_errno;
-    return err == MZ_OK;
+    return ok;
   }
   String
   fetch_file (const String &filename)
   {
     errno = ENOENT;
+    ArchiveEntry *entry = find_entry (filename);
+    if (entry && !entry->extracted)
+      {
+        // extract archive members on first use
+        const String dest = tmpdir() + "/" + filename;
+        int err = mz_zip_reader_locate_entry (reader_, filename.c_str(), false);
+        if (err == MZ_OK)
+          err = mz_zip_reader_entry_save_file (reader_, dest.c_str());
+        SDEBUG ("%s: extract '%s': %s", archive_, dest, MZ_OK == err ? "ok" : "I/O Error");
+        if (err != MZ_OK)
+          {
+            errno = EIO;
+            return "";
+          }
+        entry->extracted = true;
+      }
     if (tmpdir_.empty())
       return "";
     return tmpdir_ + "/" + filename;
   }
   String
+  fetch_window (const String &filename)
+  {
+    errno = ENOENT;
+    ArchiveEntry *entry = find_entry (filename);
+    if (!entry || !entry->stored)
+      return "";
+    if (!entry->window)
+      {
+        static std::atomic<uint> window_counter { 0 };
+        const String wname = string_format ("%s#%s:%u", archive_, filename, ++window_counter);
+        entry->window = gsl_hfile_open_window (wname.c_str(), archive_fd_, entry->offset, entry->size);
+        if (!entry->window)
+          return "";
+      }
+    return entry->window->file_name;
+  }
+  String
   fetch_file_buffer (const String &filename, ssize_t maxlength)
   {
     errno = ENOENT;
     assert_return (!Path::isabs (filename), "");
+    ArchiveEntry *entry = find_entry (filename);
+    if (entry && entry->stored && !entry->extracted)
+      {
+        String buffer (maxlength < 0 ? entry->size : std::min<int64_t> (maxlength, entry->size), 0);
+        const ssize_t l = pread (archive_fd_, &buffer[0], buffer.size(), entry->offset);
+        buffer.resize (std::max<ssize_t> (0, l));
+        return buffer;
+      }
+    auto it = find_member (filename);
+    if (it != members_.end() && it->fd < 0)
+      return maxlength < 0 ? it->data : it->data.substr (0, maxlength);
+    if (it != members_.end())
+      {
+        struct stat st;
+        if (fstat (it->fd, &st) < 0)
+          return "";
+        String buffer (maxlength < 0 ? st.st_size : std::min<off_t> (maxlength, st.st_size), 0);
+        const ssize_t l = pread (it->fd, &buffer[0], buffer.size(), 0);
+        buffer.resize (std::max<ssize_t> (0, l));
+        return buffer;
+      }
     if (tmpdir_.empty())
       return "";
     return Path::stringread (fetch_file (filename), maxlength);
@@ -349,13 +761,20 @@ public:
           }
         assert_return (next.empty() == false, "");
         if (rename (fullname.c_str(), next.c_str()) == 0)
-          return next.substr (fullname.size() - filename.size());
+          {
+            ArchiveEntry *entry = find_entry (filename);
+            if (entry)
+              entry->extracted = false;
+            return next.substr (fullname.size() - filename.size());
+          }
       }
     return ""; // error or missing file
   }
   bool
   has_file (const String &filename)
   {
+    if (find_member (filename) != members_.end() || find_entry (filename))
+      return true;
     const String fullname = fetch_file (filename);
     return Path::check (fullname, "e");
   }
@@ -401,45 +820,55 @@ public:
   bool
   import_from (const String &filename)
   {
+    close_archive();
     const StorageMagic magic = match_file (filename);
     if (magic == StorageMagic::SCM)
       return import_from_scm (filename);
     if (magic != StorageMagic::ZIP)
       return false;
-    // setup reader and open file
-    void *reader = NULL;
-    mz_zip_reader_create (&reader);
-    // mz_zip_reader_set_pattern (reader, pattern, 1);
-    mz_zip_reader_set_password (reader, NULL);
-    mz_zip_reader_set_encoding (reader, MZ_ENCODING_UTF8);
-    int err = mz_zip_reader_open_file (reader, filename.c_str());
+    // open the archive index, members are extracted or read in place on demand
+    mz_zip_reader_create (&reader_);
+    mz_zip_reader_set_password (reader_, NULL);
+    mz_zip_reader_set_encoding (reader_, MZ_ENCODING_UTF8);
+    int err = mz_zip_reader_open_file (reader_, filename.c_str());
+    archive_fd_ = err == MZ_OK ? open (filename.c_str(), O_RDONLY | O_CLOEXEC) : -1;
     errno = ELIBBAD;
-    if (err != MZ_OK)
-      return false;
-    // check and extract file entries
-    err = mz_zip_reader_goto_first_entry (reader);
+    if (err != MZ_OK || archive_fd_ < 0)
+      {
+        close_archive();
+        return false;
+      }
+    archive_ = filename;
+    err = mz_zip_reader_goto_first_entry (reader_);
     while (err == MZ_OK)
       {
         mz_zip_file *file_info = NULL;
-        if (MZ_OK == mz_zip_reader_entry_get_info (reader, &file_info) && file_info->filename && file_info->filename[0])
+        if (MZ_OK == mz_zip_reader_entry_get_info (reader_, &file_info) && file_info->filename && file_info->filename[0])
           {
             if (!strchr (file_info->filename, '/') && // see: https://github.com/nmoinvaz/minizip/issues/433
                 !strchr (file_info->filename, '\\'))
               {
-                std::string dest = tmpdir() + "/" + file_info->filename;
-                err = mz_zip_reader_entry_save_file (reader, dest.c_str());
-                SDEBUG ("%s: extract '%s': %s", filename, dest, MZ_OK == err ? "ok" : "I/O Error");
+                ArchiveEntry entry;
+                entry.name = file_info->filename;
+                entry.size = file_info->uncompressed_size;
+                entry.stored = file_info->compression_method == MZ_COMPRESS_METHOD_STORE &&
+                               !(file_info->flag & MZ_ZIP_FLAG_ENCRYPTED) &&
+                               file_info->compressed_size == file_info->uncompressed_size;
+                uint8_t lh[30];         // local header, its extra field may differ from the central directory
+                if (entry.stored && pread (archive_fd_, lh, sizeof (lh), file_info->disk_offset) == sizeof (lh) &&
+                    lh[0] == 'P' && lh[1] == 'K' && lh[2] == 3 && lh[3] == 4)
+                  entry.offset = file_info->disk_offset + sizeof (lh) + (lh[26] | lh[27] << 8) + (lh[28] | lh[29] << 8);
+                else
+                  entry.stored = false;
+                SDEBUG ("%s: member '%s': %s", filename, entry.name, entry.stored ? "stored" : "compressed");
+                entries_.push_back (entry);
               }
             else
               SDEBUG ("%s: ignore: %s", filename, file_info->filename);
           }
-        err = mz_zip_reader_goto_next_entry (reader); // yields MZ_END_OF_LIST
+        err = mz_zip_reader_goto_next_entry (reader_); // yields MZ_END_OF_LIST
       }
-    errno = EIO;
-    err = mz_zip_reader_close (reader);
-    if (err != MZ_OK)
-      return false;
-    mz_zip_reader_delete(&reader);
+    errno = 0;
     return true;
   }
 };
@@ -457,5 +886,6 @@ String   Storage::move_to_temporary (const String &filename)    { return impl_->
 String   Storage::fetch_file_buffer (const String &filename, ssize_t maxlength)
 { return impl_->fetch_file_buffer (filename, maxlength); }
 String   Storage::fetch_file        (const String &filename)    { return impl_->fetch_file (filename); }
+String   Storage::fetch_window      (const String &filename)    { return impl_->fetch_window (filename); }
 
 } // Bse
@@ -26,6 +26,7 @@ public:
   String   move_to_temporary (const String &filename);
   String   fetch_file_buffer (const String &filename, ssize_t maxlength = -1);
   String   fetch_file        (const String &filename); // yields abspath
+  String   fetch_window      (const String &filename); // yields GslHFile name for uncompressed members
 };
 
 std::string beastbse_cachedir_create  ();
@@ -58,50 +58,65 @@ public:
     double left_factor     = 1;
     double right_factor    = 0;
 
-    double master_phase    = 0;
-    double slave_phase     = 0;
-
-    double last_value      = 0; /* leaky integrator state */
-    double current_level   = 0; /* current position of the wave form (saw + jumps) */
-
-    double last_dc         = 0; /* dc of previous parameters */
-    double dc_delta        = 0;
-    int    dc_steps        = 0;
-
-    int    future_pos      = 0;
-
-
-    State  state           = State::A;
-
-    // could be shared under certain conditions
-    std::array<float, WIDTH * 2> future;
-
-    void
-    init_future()
-    {
-      future.fill (0);
-      future_pos = 0;
-    }
-    float
-    pop_future()
-    {
-      const float f = future[future_pos++];
-      if (future_pos == WIDTH)
-        {
-          // this loop was slightly faster than std::copy_n + std::fill_n
-          for (int i = 0; i < WIDTH; i++)
-            {
-              future[i] = future[WIDTH + i];
-              future[WIDTH + i] = 0;
-            }
-          future_pos = 0;
-        }
-      return f;
-    }
+    double master_phase    = 0; /* start phase, applied by reset_voice_state() */
   };
-
   std::vector<UnisonVoice> unison_voices;
 
+private:
+  /* unison voices are rendered in groups of LANES, using one SIMD lane per voice */
+  static const int LANES = 4;
+
+  template<int N>
+  struct LaneGroup
+  {
+    static const int SIZE = N;
+    typedef double VDouble __attribute__ ((vector_size (N * sizeof (double))));
+    typedef int64  VInt    __attribute__ ((vector_size (N * sizeof (int64))));
+
+    VDouble master_phase   = {};
+    VDouble slave_phase    = {};
+    VDouble last_value     = {}; /* leaky integrator state */
+    VDouble current_level  = {}; /* current position of the wave form (saw + jumps) */
+    VInt    state          = {}; /* State per voice */
+
+    VDouble future[WIDTH * 2];
+  };
+  std::vector<LaneGroup<LANES>> lane_groups_;
+  /* without unison, unused lanes would only cost time, so a single voice uses scalar code */
+  LaneGroup<1>                  single_voice_;
+
+  template<class VInt> static bool
+  any_lane (VInt mask)
+  {
+    int64 any = 0;
+    for (size_t l = 0; l < sizeof (VInt) / sizeof (int64); l++)
+      any |= mask[l];
+    return any;
+  }
+  template<class VDouble> static double
+  sum_lanes (VDouble v)
+  {
+    double sum = 0;
+    for (size_t l = 0; l < sizeof (VDouble) / sizeof (double); l++)
+      sum += v[l];
+    return sum;
+  }
+  template<class Fn> void
+  with_voice_lane (size_t voice, const Fn& fn)
+  {
+    if (unison_voices.size() > 1)
+      fn (lane_groups_[voice / LANES], voice % LANES);
+    else
+      fn (single_voice_, 0);
+  }
+
+  /* all unison voices are reset together, so dc and future position are shared */
+  double last_dc_          = 0; /* dc of previous parameters */
+  double dc_delta_         = 0;
+  int    dc_steps_         = 0;
+  int    future_pos_       = 0;
+
+public:
   OscImpl()
   {
     set_unison (1, 0, 0); // default
@@ -111,12 +126,15 @@ public:
   {
     const bool randomize_phase = unison_voices.size() > 1;
 
+    for (auto& lanes : lane_groups_)
+      std::fill (std::begin (lanes.future), std::end (lanes.future), LaneGroup<LANES>::VDouble {});
+    std::fill (std::begin (single_voice_.future), std::end (single_voice_.future), LaneGroup<1>::VDouble {});
+    future_pos_ = 0;
+    dc_steps_ = 0;
+    dc_delta_ = 0;
+
     for (auto& voice : unison_voices)
       {
-        voice.init_future();
-        voice.dc_steps = 0;
-        voice.dc_delta = 0;
-
         if (randomize_phase) // randomize start phase for true unison
           {
             reset_master (voice, g_random_double_range (0, 1));
@@ -127,6 +145,14 @@ public:
           }
       }
   }
+  double
+  last_value (size_t voice) const
+  {
+    if (unison_voices.size() > 1)
+      return lane_groups_[voice / LANES].last_value[voice % LANES];
+    else
+      return single_voice_.last_value[0];
+  }
   void
   reset_master (UnisonVoice& voice, double master_phase)
   {
@@ -139,6 +165,7 @@ public:
     const bool unison_voices_changed = unison_voices.size() != n_voices;
 
     unison_voices.resize (n_voices);
+    lane_groups_.resize (n_voices > 1 ? (n_voices + LANES - 1) / LANES : 0);
 
     bool left_channel = true; /* start spreading voices at the left channel */
     for (size_t i = 0; i < unison_voices.size(); i++)
@@ -365,53 +392,65 @@ public:
 
     const double dc = (dc_base * (int) sync_factor + dc_sync) / sync_factor;
 
-    for (auto& voice : unison_voices)
+    auto clear_state = [] (auto& lanes) {
+      lanes.master_phase = lanes.slave_phase = lanes.last_value = lanes.current_level = decltype (lanes.last_value) {};
+      lanes.state = decltype (lanes.state) {};
+    };
+    for (auto& lanes : lane_groups_)
+      clear_state (lanes);
+    clear_state (single_voice_);
+    for (size_t v = 0; v < unison_voices.size(); v++)
       {
-        double dest_phase = voice.master_phase;
+        const double master_phase = unison_voices[v].master_phase;
+        double dest_phase = master_phase;
 
         double last_value; /* leaky integrator state */
+        State  state;
 
         dest_phase *= sync_factor;
         dest_phase -= (int) dest_phase;
 
-        voice.slave_phase = dest_phase;
-
         /* compute voice state and initial value without dc */
         if (dest_phase < bound_a)
           {
             double frac = (bound_a - dest_phase) / bound_a;
             last_value = a1 * frac + a2 * (1 - frac);
 
-            voice.state = State::A;
+            state = State::A;
           }
         else if (dest_phase < bound_b)
           {
             double frac = (bound_b - dest_phase) / (bound_b - bound_a);
             last_value = b1 * frac + b2 * (1 - frac);
 
-            voice.state = State::B;
+            state = State::B;
           }
         else if (dest_phase < bound_c)
           {
             double frac = (bound_c - dest_phase) / (bound_c - bound_b);
             last_value = c1 * frac + c2 * (1 - frac);
 
-            voice.state = State::C;
+            state = State::C;
           }
         else
           {
             double frac = (bound_d - dest_phase) / (bound_d - bound_c);
             last_value = d1 * frac + d2 * (1 - frac);
 
-            voice.state = State::D;
+            state = State::D;
           }
-        voice.last_value    = last_value - dc;
-        voice.last_dc       = dc;
-        voice.current_level = last_value - 1;
+        with_voice_lane (v, [&] (auto& lanes, int l) {
+            lanes.master_phase[l]  = master_phase;
+            lanes.slave_phase[l]   = dest_phase;
+            lanes.state[l]         = int (state);
+            lanes.last_value[l]    = last_value - dc;
+            lanes.current_level[l] = last_value - 1;
+          });
       }
+    last_dc_ = dc;
   }
-  void
-  insert_blep (UnisonVoice& voice, double frac, double weight)
+  template<class Lanes> void
+  insert_blep (Lanes& lanes, int lane, int future_pos, double frac, double weight)
   {
     int pos = frac * OVERSAMPLE;
     const float inter_frac = frac * OVERSAMPLE - pos;
@@ -423,16 +462,11 @@ public:
 
     for (int i = 0; i < WIDTH; i++)
       {
-        voice.future[i + voice.future_pos] += blep_table[pos] * weight_left + blep_table[pos + 1] * weight_right;
+        lanes.future[i + future_pos][lane] += blep_table[pos] * weight_left + blep_table[pos + 1] * weight_right;
 
         pos += OVERSAMPLE;
       }
   }
-  void
-  insert_future_delta (UnisonVoice& voice, double weight)
-  {
-    voice.future[voice.future_pos + WSHIFT] += weight;
-  }
 
   double
   clamp (double d, double min, double max)
@@ -446,14 +480,14 @@ public:
    * before master oscillator sync
    */
   bool
-  check_slave_before_master (UnisonVoice& voice, double target_phase, double sync_factor)
+  check_slave_before_master (double master_phase, double slave_phase, double target_phase, double sync_factor)
   {
-    if (voice.slave_phase > target_phase)
+    if (slave_phase > target_phase)
       {
-        if (voice.master_phase > 1)
+        if (master_phase > 1)
           {
-            const double slave_frac = (voice.slave_phase - target_phase) / sync_factor;
-            const double master_frac = voice.master_phase - 1;
+            const double slave_frac = (slave_phase - target_phase) / sync_factor;
+            const double master_frac = master_phase - 1;
 
             return master_frac < slave_frac;
           }
@@ -462,6 +496,236 @@ public:
       }
     return false;
   }
+  /* handle state changes and master sync of a single voice, inserting bleps for all jumps */
+  template<class Lanes> void
+  process_state_changes (Lanes& lanes, int lane, int future_pos, double master_inc, double slave_inc, double saw_delta,
+                         double shape, double pulse_width, double sub, double sub_width, double sync_factor)
+  {
+    double master_phase  = lanes.master_phase[lane];
+    double slave_phase   = lanes.slave_phase[lane];
+    double current_level = lanes.current_level[lane];
+    State  state         = State (lanes.state[lane]);
+
+    bool state_changed;
+    do
+      {
+        state_changed = false;
+
+        if (state == State::A)
+          {
+            const double bound_a = sub_width * pulse_width;
+
+            if (check_slave_before_master (master_phase, slave_phase, bound_a, sync_factor))
+              {
+                const double slave_frac = (slave_phase - bound_a) / slave_inc;
+
+                const double jump_a = 2.0 * (shape * (1 - sub) - sub);
+                const double saw = -4.0 * (shape + 1) * (1 - sub) * bound_a;
+                const double blep_height = jump_a + saw - (current_level + (1 - slave_frac) * saw_delta);
+
+                insert_blep (lanes, lane, future_pos, slave_frac, blep_height);
+                current_level += blep_height;
+                state = State::B;
+                state_changed = true;
+              }
+          }
+        if (state == State::B)
+          {
+            const double bound_b = 2 * sub_width * pulse_width + 1 - sub_width - pulse_width;
+
+            if (check_slave_before_master (master_phase, slave_phase, bound_b, sync_factor))
+              {
+                const double slave_frac = (slave_phase - bound_b) / slave_inc;
+
+                const double jump_ab = 2.0 * ((shape + 1) * (1 - sub) - sub);
+                const double saw = -4.0 * (shape + 1) * (1 - sub) * bound_b;
+                const double blep_height = jump_ab + saw - (current_level + (1 - slave_frac) * saw_delta);
+
+                insert_blep (lanes, lane, future_pos, slave_frac, blep_height);
+                current_level += blep_height;
+                state = State::C;
+                state_changed = true;
+              }
+          }
+        if (state == State::C)
+          {
+            const double bound_c = sub_width * pulse_width + (1 - sub_width);
+
+            if (check_slave_before_master (master_phase, slave_phase, bound_c, sync_factor))
+              {
+                const double slave_frac = (slave_phase - bound_c) / slave_inc;
+
+                const double jump_abc = 2.0 * (2 * shape + 1) * (1 - sub);
+                const double saw = -4.0 * (shape + 1) * (1 - sub) * bound_c;
+                const double blep_height = jump_abc + saw - (current_level + (1 - slave_frac) * saw_delta);
+
+                insert_blep (lanes, lane, future_pos, slave_frac, blep_height);
+                current_level += blep_height;
+                state = State::D;
+                state_changed = true;
+              }
+          }
+        if (state == State::D)
+          {
+            if (check_slave_before_master (master_phase, slave_phase, 1, sync_factor))
+              {
+                slave_phase -= 1;
+
+                const double slave_frac = slave_phase / slave_inc;
+
+                current_level += (1 - slave_frac) * saw_delta;
+
+                insert_blep (lanes, lane, future_pos, slave_frac, -current_level);
+
+                current_level = saw_delta * slave_frac - saw_delta;
+                state = State::A;
+                state_changed = true;
+              }
+          }
+        if (!state_changed && master_phase > 1)
+          {
+            master_phase -= 1;
+
+            const double master_frac = master_phase / master_inc;
+
+            const double new_slave_phase = master_phase * sync_factor;
+
+            current_level += (1 - master_frac) * saw_delta;
+
+            insert_blep (lanes, lane, future_pos, master_frac, -current_level);
+
+            current_level = saw_delta * master_frac - saw_delta;
+            slave_phase = new_slave_phase;
+
+            state = State::A;
+            state_changed = true;
+          }
+      }
+    while (state_changed); // rerun all state checks if state was modified
+
+    lanes.master_phase[lane]  = master_phase;
+    lanes.slave_phase[lane]   = slave_phase;
+    lanes.current_level[lane] = current_level;
+    lanes.state[lane]         = int (state);
+  }
+  /* parameters shared by all unison voices, computed once per sample */
+  struct SampleParams
+  {
+    double master_freq, master_mod, shape, pulse_width, sub, sub_width, sync_factor;
+  };
+  template<bool CONSTANT_PARAMS, bool FREQ_MOD, class Lanes> void
+  process_lanes (Lanes& lanes, size_t first_voice, typename Lanes::VDouble *left_sums, typename Lanes::VDouble *right_sums,
+                 unsigned int n_values, const SampleParams *sample_params, const double *dc_deltas)
+  {
+    typedef typename Lanes::VDouble VDouble;
+    typedef typename Lanes::VInt    VInt;
+
+    /* unused lanes have zero frequency and volume */
+    VDouble master_freq2inc = {}, left_factor = {}, right_factor = {};
+    for (size_t l = 0, v = first_voice; l < Lanes::SIZE && v < unison_voices.size(); l++, v++)
+      {
+        master_freq2inc[l] = 0.5 / rate_ * unison_voices[v].freq_factor;
+        left_factor[l]     = unison_voices[v].left_factor;
+        right_factor[l]    = unison_voices[v].right_factor;
+      }
+
+    /* keep voice state in registers, state changes are rare and handled per voice */
+    VDouble master_phase  = lanes.master_phase;
+    VDouble slave_phase   = lanes.slave_phase;
+    VDouble last_value    = lanes.last_value;
+    VDouble current_level = lanes.current_level;
+    VInt    state         = lanes.state;
+    int     future_pos    = future_pos_;
+
+    const SampleParams constant_params = sample_params[0];
+    for (unsigned int n = 0; n < n_values; n++)
+      {
+        const SampleParams& p = CONSTANT_PARAMS ? constant_params : sample_params[n];
+
+        VDouble master_inc = p.master_freq * master_freq2inc;
+        if (FREQ_MOD)
+          master_inc *= p.master_mod;
+
+        const VDouble slave_inc = master_inc * p.sync_factor;
+        const VDouble saw_delta = -4.0 * slave_inc * (p.shape + 1) * (1 - p.sub);
+
+        master_phase += master_inc;
+        slave_phase  += slave_inc;
+
+        const double bound_a = p.sub_width * p.pulse_width;
+        const double bound_b = 2 * p.sub_width * p.pulse_width + 1 - p.sub_width - p.pulse_width;
+        const double bound_c = p.sub_width * p.pulse_width + (1 - p.sub_width);
+        const VDouble bound = state == int (State::A) ? VDouble {} + bound_a :
+                              state == int (State::B) ? VDouble {} + bound_b :
+                              state == int (State::C) ? VDouble {} + bound_c : VDouble {} + 1.0;
+        const VInt changes = (slave_phase > bound) | (master_phase > 1.0);
+        if (BSE_UNLIKELY (any_lane (changes)))
+          {
+            lanes.master_phase = master_phase;
+            lanes.slave_phase = slave_phase;
+            lanes.current_level = current_level;
+            lanes.state = state;
+            for (int l = 0; l < Lanes::SIZE; l++)
+              if (changes[l])
+                process_state_changes (lanes, l, future_pos, master_inc[l], slave_inc[l], saw_delta[l],
+                                       p.shape, p.pulse_width, p.sub, p.sub_width, p.sync_factor);
+            master_phase = lanes.master_phase;
+            slave_phase = lanes.slave_phase;
+            current_level = lanes.current_level;
+            state = lanes.state;
+          }
+
+        current_level += saw_delta;
+        lanes.future[future_pos + WSHIFT] += saw_delta + dc_deltas[n]; // align with the impulses
+
+        /* leaky integration */
+        const VDouble value = leaky_a * last_value + lanes.future[future_pos++];
+        last_value = value;
+        if (future_pos == WIDTH)
+          {
+            for (int i = 0; i < WIDTH; i++)
+              {
+                lanes.future[i] = lanes.future[WIDTH + i];
+                lanes.future[WIDTH + i] = VDouble {};
+              }
+            future_pos = 0;
+          }
+
+        left_sums[n] += value * left_factor;
+        right_sums[n] += value * right_factor;
+      }
+    lanes.master_phase = master_phase;
+    lanes.slave_phase = slave_phase;
+    lanes.last_value = last_value;
+    lanes.current_level = current_level;
+    lanes.state = state;
+  }
+  template<class Lanes> void
+  process_groups (Lanes *groups, size_t n_groups, float *left_out, float *right_out, unsigned int n_values,
+                  bool constant_params, bool freq_mod, const SampleParams *sample_params, const double *dc_deltas)
+  {
+    typedef typename Lanes::VDouble VDouble;
+
+    /* sum up voices per lane first, so only one horizontal sum per sample is needed */
+    VDouble left_sums[n_values], right_sums[n_values];
+    std::fill_n (left_sums, n_values, VDouble {});
+    std::fill_n (right_sums, n_values, VDouble {});
+    for (size_t g = 0; g < n_groups; g++)
+      {
+        if (constant_params)
+          process_lanes<true, false> (groups[g], g * Lanes::SIZE, left_sums, right_sums, n_values, sample_params, dc_deltas);
+        else if (freq_mod)
+          process_lanes<false, true> (groups[g], g * Lanes::SIZE, left_sums, right_sums, n_values, sample_params, dc_deltas);
+        else
+          process_lanes<false, false> (groups[g], g * Lanes::SIZE, left_sums, right_sums, n_values, sample_params, dc_deltas);
+      }
+    for (unsigned int n = 0; n < n_values; n++)
+      {
+        left_out[n] = sum_lanes (left_sums[n]);
+        right_out[n] = sum_lanes (right_sums[n]);
+      }
+  }
+public:
   void
   process_sample_stereo (float *left_out, float *right_out, unsigned int n_values,
                          const float *freq_in = nullptr,
@@ -472,181 +736,85 @@ public:
                          const float *pulse_mod_in = nullptr,
                          const float *sub_width_mod_in = nullptr)
   {
-    Block::fill (n_values, left_out, 0.0);
-    Block::fill (n_values, right_out, 0.0);
-
     double master_freq = frequency_factor * frequency_base;
     double pulse_width = clamp (pulse_width_base, 0.01, 0.99);
     double sub         = clamp (sub_base, 0.0, 1.0);
     double sub_width   = clamp (sub_width_base, 0.01, 0.99);
     double shape       = clamp (shape_base, -1.0, 1.0);
     double sync_factor = fast_exp2 (clamp (sync_base, 0.0, 60.0) / 12);
+    double master_mod  = 1;
 
     /* dc substampling according to control frequency (cpu/quality trade off) */
     const int dc_steps = max (bse_ftoi (rate_ / 4000), 1);
 
-    for (auto& voice : unison_voices)
+    /* parameters and dc are the same for all unison voices, so unlike voice state, they
+     * are computed once per sample; without modulation inputs, parameters stay constant
+     */
+    const bool constant_params = !freq_in && !freq_mod_in && !shape_mod_in && !sub_mod_in &&
+                                 !sync_mod_in && !pulse_mod_in && !sub_width_mod_in;
+    SampleParams sample_params[constant_params ? 1 : n_values];
+    for (unsigned int n = 0; n < (constant_params ? 1 : n_values); n++)
       {
-        const double master_freq2inc = 0.5 / rate_ * voice.freq_factor;
-
-        for (unsigned int n = 0; n < n_values; n++)
-          {
-            if (freq_in)
-              master_freq = frequency_factor * BSE_SIGNAL_TO_FREQ (freq_in[n]);
-
-            double master_inc = master_freq * master_freq2inc;
-            if (freq_mod_in)
-              master_inc *= fast_exp2 (freq_mod_in[n] * freq_mod_octaves);
+        if (freq_in)
+          master_freq = frequency_factor * BSE_SIGNAL_TO_FREQ (freq_in[n]);
 
-            if (shape_mod_in)
-              shape = clamp (shape_base + shape_mod * shape_mod_in[n], -1.0, 1.0);
+        if (freq_mod_in)
+          master_mod = fast_exp2 (freq_mod_in[n] * freq_mod_octaves);
 
-            if (sub_mod_in)
-              sub = clamp (sub_base + sub_mod * sub_mod_in[n], 0.0, 1.0);
+        if (shape_mod_in)
+          shape = clamp (shape_base + shape_mod * shape_mod_in[n], -1.0, 1.0);
 
-            if (sync_mod_in)
-              sync_factor = fast_exp2 (clamp (sync_base + sync_mod * sync_mod_in[n], 0.0, 60.0) / 12);
+        if (sub_mod_in)
+          sub = clamp (sub_base + sub_mod * sub_mod_in[n], 0.0, 1.0);
 
-            if (pulse_mod_in)
-              pulse_width = clamp (pulse_width_base + pulse_width_mod * pulse_mod_in[n], 0.01, 0.99);
-
-            if (sub_width_mod_in)
-              sub_width = clamp (sub_width_base + sub_width_mod * sub_width_mod_in[n], 0.01, 0.99);
-
-            /* reset needs parameters, so we need to do it here */
-            if (need_reset_voice_state)
-              {
-                reset_voice_state (shape, pulse_width, sub, sub_width, sync_factor);
-                need_reset_voice_state = false;
-              }
+        if (sync_mod_in)
+          sync_factor = fast_exp2 (clamp (sync_base + sync_mod * sync_mod_in[n], 0.0, 60.0) / 12);
 
-            const double slave_inc = master_inc * sync_factor;
-            const double saw_delta = -4.0 * slave_inc * (shape + 1) * (1 - sub);
+        if (pulse_mod_in)
+          pulse_width = clamp (pulse_width_base + pulse_width_mod * pulse_mod_in[n], 0.01, 0.99);
 
-            voice.master_phase += master_inc;
-            voice.slave_phase  += slave_inc;
+        if (sub_width_mod_in)
+          sub_width = clamp (sub_width_base + sub_width_mod * sub_width_mod_in[n], 0.01, 0.99);
 
-            bool state_changed;
-            do
-              {
-                state_changed = false;
-
-                if (voice.state == State::A)
-                  {
-                    const double bound_a = sub_width * pulse_width;
-
-                    if (check_slave_before_master (voice, bound_a, sync_factor))
-                      {
-                        const double slave_frac = (voice.slave_phase - bound_a) / slave_inc;
-
-                        const double jump_a = 2.0 * (shape * (1 - sub) - sub);
-                        const double saw = -4.0 * (shape + 1) * (1 - sub) * bound_a;
-                        const double blep_height = jump_a + saw - (voice.current_level + (1 - slave_frac) * saw_delta);
-
-                        insert_blep (voice, slave_frac, blep_height);
-                        voice.current_level += blep_height;
-                        voice.state = State::B;
-                        state_changed = true;
-                      }
-                  }
-                if (voice.state == State::B)
-                  {
-                    const double bound_b = 2 * sub_width * pulse_width + 1 - sub_width - pulse_width;
-
-                    if (check_slave_before_master (voice, bound_b, sync_factor))
-                      {
-                        const double slave_frac = (voice.slave_phase - bound_b) / slave_inc;
-
-                        const double jump_ab = 2.0 * ((shape + 1) * (1 - sub) - sub);
-                        const double saw = -4.0 * (shape + 1) * (1 - sub) * bound_b;
-                        const double blep_height = jump_ab + saw - (voice.current_level + (1 - slave_frac) * saw_delta);
-
-                        insert_blep (voice, slave_frac, blep_height);
-                        voice.current_level += blep_height;
-                        voice.state = State::C;
-                        state_changed = true;
-                      }
-                  }
-                if (voice.state == State::C)
-                  {
-                    const double bound_c = sub_width * pulse_width + (1 - sub_width);
-
-                    if (check_slave_before_master (voice, bound_c, sync_factor))
-                      {
-                        const double slave_frac = (voice.slave_phase - bound_c) / slave_inc;
-
-                        const double jump_abc = 2.0 * (2 * shape + 1) * (1 - sub);
-                        const double saw = -4.0 * (shape + 1) * (1 - sub) * bound_c;
-                        const double blep_height = jump_abc + saw - (voice.current_level + (1 - slave_frac) * saw_delta);
-
-                        insert_blep (voice, slave_frac, blep_height);
-                        voice.current_level += blep_height;
-                        voice.state = State::D;
-                        state_changed = true;
-                      }
-                  }
-                if (voice.state == State::D)
-                  {
-                    if (check_slave_before_master (voice, 1, sync_factor))
-                      {
-                        voice.slave_phase -= 1;
-
-                        const double slave_frac = voice.slave_phase / slave_inc;
-
-                        voice.current_level += (1 - slave_frac) * saw_delta;
-
-                        insert_blep (voice, slave_frac, -voice.current_level);
-
-                        voice.current_level = saw_delta * slave_frac - saw_delta;
-                        voice.state = State::A;
-                        state_changed = true;
-                      }
-                  }
-                if (!state_changed && voice.master_phase > 1)
-                  {
-                    voice.master_phase -= 1;
-
-                    const double master_frac = voice.master_phase / master_inc;
-
-                    const double new_slave_phase = voice.master_phase * sync_factor;
-
-                    voice.current_level += (1 - master_frac) * saw_delta;
-
-                    insert_blep (voice, master_frac, -voice.current_level);
-
-                    voice.current_level = saw_delta * master_frac - saw_delta;
-                    voice.slave_phase = new_slave_phase;
-
-                    voice.state = State::A;
-                    state_changed = true;
-                  }
-              }
-            while (state_changed); // rerun all state checks if state was modified
-
-            if (voice.dc_steps > 0)
-              {
-                voice.dc_steps--;
-              }
-            else
-              {
-                const double dc = estimate_dc (shape, pulse_width, sub, sub_width, sync_factor);
-
-                voice.dc_steps = dc_steps - 1;
-                voice.dc_delta = (voice.last_dc - dc) / dc_steps;
-                voice.last_dc = dc;
-              }
+        sample_params[n] = { master_freq, master_mod, shape, pulse_width, sub, sub_width, sync_factor };
+      }
 
-            voice.current_level += saw_delta;
-            insert_future_delta (voice, saw_delta + voice.dc_delta); // align with the impulses
+    /* reset needs parameters, so we need to do it here */
+    if (need_reset_voice_state)
+      {
+        const SampleParams& p = sample_params[0];
+        reset_voice_state (p.shape, p.pulse_width, p.sub, p.sub_width, p.sync_factor);
+        need_reset_voice_state = false;
+      }
 
-            /* leaky integration */
-            double value = leaky_a * voice.last_value + voice.pop_future();
-            voice.last_value = value;
+    /* dc is estimated every dc_steps samples and interpolated in between */
+    double dc_deltas[n_values], dc = 0;
+    uint   n_dc_estimates = 0;
+    for (unsigned int n = 0; n < n_values; )
+      {
+        if (dc_steps_ == 0)
+          {
+            const SampleParams& p = sample_params[constant_params ? 0 : n];
+            if (!constant_params || n_dc_estimates++ == 0)
+              dc = estimate_dc (p.shape, p.pulse_width, p.sub, p.sub_width, p.sync_factor);
 
-            left_out[n] += value * voice.left_factor;
-            right_out[n] += value * voice.right_factor;
+            dc_steps_ = dc_steps;
+            dc_delta_ = (last_dc_ - dc) / dc_steps;
+            last_dc_ = dc;
           }
+        const unsigned int n_steps = std::min<unsigned int> (dc_steps_, n_values - n);
+        std::fill_n (dc_deltas + n, n_steps, dc_delta_);
+        dc_steps_ -= n_steps;
+        n += n_steps;
       }
+
+    if (unison_voices.size() > 1)
+      process_groups (lane_groups_.data(), lane_groups_.size(), left_out, right_out, n_values,
+                      constant_params, freq_mod_in, sample_params, dc_deltas);
+    else
+      process_groups (&single_voice_, 1, left_out, right_out, n_values,
+                      constant_params, freq_mod_in, sample_params, dc_deltas);
+    future_pos_ = (future_pos_ + n_values) % WIDTH;
   }
 };
 
@@ -682,7 +850,7 @@ public:
     osc_impl.reset_master (osc_impl.unison_voices[0], phase);  // jump to phase
 
     process_sample(); // propagate parameters & perform reset
-    return osc_impl.unison_voices[0].last_value;
+    return osc_impl.last_value (0);
   }
   double
   process_sample()
@@ -263,9 +263,10 @@ class BlepSynth : public AudioSignal::Processor {
 
     BlepUtils::OscImpl osc1_;
     BlepUtils::OscImpl osc2_;
-    LadderVCFNonLinear vcf_;
+    LadderVCFVoicesNonLinear::Voice vcf_;
   };
   std::vector<Voice>    voices_;
+  LadderVCFVoicesNonLinear vcf_voices_;
   std::vector<Voice *>  active_voices_;
   std::vector<Voice *>  idle_voices_;
   void
@@ -541,101 +542,130 @@ class BlepSynth : public AudioSignal::Processor {
     floatfill (left_out, 0.f, n_frames);
     floatfill (right_out, 0.f, n_frames);
 
-    for (auto& voice : active_voices_)
-      {
-        float osc1_left_out[n_frames];
-        float osc1_right_out[n_frames];
-        float osc2_left_out[n_frames];
-        float osc2_right_out[n_frames];
-
-        update_osc (voice->osc1_, osc_params[0]);
-        update_osc (voice->osc2_, osc_params[1]);
-        voice->osc1_.process_sample_stereo (osc1_left_out, osc1_right_out, n_frames);
-        voice->osc2_.process_sample_stereo (osc2_left_out, osc2_right_out, n_frames);
-
-        // apply volume envelope & mix
-        float mix_left_out[n_frames];
-        float mix_right_out[n_frames];
-        const float mix_norm = get_param (pid_mix_) * 0.01;
-        const float v1 = 1 - mix_norm;
-        const float v2 = mix_norm;
-        for (uint i = 0; i < n_frames; i++)
-          {
-            mix_left_out[i]  = osc1_left_out[i] * v1 + osc2_left_out[i] * v2;
-            mix_right_out[i] = osc1_right_out[i] * v1 + osc2_right_out[i] * v2;
-          }
-        bool run_filter = true;
-        switch (bse_ftoi (get_param (pid_mode_)))
-          {
-          case 4: voice->vcf_.set_mode (LadderVCFMode::LP4);
-            break;
-          case 3: voice->vcf_.set_mode (LadderVCFMode::LP3);
-            break;
-          case 2: voice->vcf_.set_mode (LadderVCFMode::LP2);
-            break;
-          case 1: voice->vcf_.set_mode (LadderVCFMode::LP1);
-            break;
-          default: run_filter = false;
-            break;
-          }
-        /* --------- run ladder filter - processing in place is ok --------- */
-
-        /* TODO: under some conditions we could enable SSE in LadderVCF (alignment and block_size) */
-        const float *inputs[2]  = { mix_left_out, mix_right_out };
-        float       *outputs[2] = { mix_left_out, mix_right_out };
-        double cutoff = get_param (pid_cutoff_) * inyquist();
-        double resonance = get_param (pid_resonance_) * 0.01;
-        double key_track = get_param (pid_key_track_) * 0.01;
+    const float mix_norm = get_param (pid_mix_) * 0.01;
+    const float v1 = 1 - mix_norm;
+    const float v2 = mix_norm;
 
-        if (fabs (voice->last_cutoff_ - cutoff) > 1e-7 || fabs (voice->last_key_track_ - key_track) > 1e-7)
-          {
-            const bool reset = voice->last_cutoff_ < -1000;
+    bool run_filter = true;
+    switch (bse_ftoi (get_param (pid_mode_)))
+      {
+      case 4: vcf_voices_.set_mode (LadderVCFMode::LP4);
+        break;
+      case 3: vcf_voices_.set_mode (LadderVCFMode::LP3);
+        break;
+      case 2: vcf_voices_.set_mode (LadderVCFMode::LP2);
+        break;
+      case 1: vcf_voices_.set_mode (LadderVCFMode::LP1);
+        break;
+      default: run_filter = false;
+        break;
+      }
+    vcf_voices_.set_drive (get_param (pid_drive_));
 
-            // original strategy for key tracking: cutoff * exp (amount * log (key / 261.63))
-            // but since cutoff_smooth_ is already in log2-frequency space, we can do it better
+    const double cutoff = get_param (pid_cutoff_) * inyquist();
+    const double resonance = get_param (pid_resonance_) * 0.01;
+    const double key_track = get_param (pid_key_track_) * 0.01;
+    const double cut_mod = get_param (pid_fil_cut_mod_) / 12.; /* convert semitones to octaves */
 
-            voice->cutoff_smooth_.set (fast_log2 (cutoff) + key_track * fast_log2 (voice->freq_ / 261.63), reset);
-            voice->last_cutoff_ = cutoff;
-            voice->last_key_track_ = key_track;
-          }
-        double cut_mod = get_param (pid_fil_cut_mod_) / 12.; /* convert semitones to octaves */
-        if (fabs (voice->last_cut_mod_ - cut_mod) > 1e-7)
-          {
-            const bool reset = voice->last_cut_mod_ < -1000;
+    /* voices are filtered in groups, one SIMD lane per voice channel */
+    constexpr uint GROUP = LadderVCFVoicesNonLinear::VOICES;
+    for (size_t first = 0; first < active_voices_.size(); first += GROUP)
+      {
+        const uint n_group = std::min<size_t> (GROUP, active_voices_.size() - first);
 
-            voice->cut_mod_smooth_.set (cut_mod, reset);
-            voice->last_cut_mod_ = cut_mod;
-          }
-        /* TODO: possible improvements:
-         *  - exponential smoothing (get rid of exp2f)
-         *  - don't do anything if cutoff_smooth_->steps_ == 0 (add accessor)
-         */
-        float freq_in[n_frames];
-        for (uint i = 0; i < n_frames; i++)
-          freq_in[i] = fast_exp2 (voice->cutoff_smooth_.get_next() + voice->fil_envelope_.get_next() * voice->cut_mod_smooth_.get_next());
-        voice->vcf_.set_drive (get_param (pid_drive_));
+        float mix_out[2 * GROUP * n_frames];
+        float no_out[2 * GROUP * n_frames];
+        float freq_in[GROUP * n_frames];
+        const float *inputs[2 * GROUP];
+        float       *outputs[2 * GROUP];
+        const float *freq_ins[GROUP];
+        LadderVCFVoicesNonLinear::Voice *vcfs[GROUP];
 
-        float no_out[n_frames];
-        if (!run_filter)
+        for (uint v = 0; v < n_group; v++)
           {
-            // we keep running the filter even if it is disabled in order to have
-            // sane filter signal to switch to when the filter is enabled again
-            outputs[0] = no_out;
-            outputs[1] = no_out;
+            Voice *voice = active_voices_[first + v];
+            float osc1_left_out[n_frames];
+            float osc1_right_out[n_frames];
+            float osc2_left_out[n_frames];
+            float osc2_right_out[n_frames];
+
+            update_osc (voice->osc1_, osc_params[0]);
+            update_osc (voice->osc2_, osc_params[1]);
+            voice->osc1_.process_sample_stereo (osc1_left_out, osc1_right_out, n_frames);
+            voice->osc2_.process_sample_stereo (osc2_left_out, osc2_right_out, n_frames);
+
+            // mix oscillators
+            float *mix_left_out  = &mix_out[(2 * v) * n_frames];
+            float *mix_right_out = &mix_out[(2 * v + 1) * n_frames];
+            for (uint i = 0; i < n_frames; i++)
+              {
+                mix_left_out[i]  = osc1_left_out[i] * v1 + osc2_left_out[i] * v2;
+                mix_right_out[i] = osc1_right_out[i] * v1 + osc2_right_out[i] * v2;
+              }
+            inputs[2 * v]     = mix_left_out;
+            inputs[2 * v + 1] = mix_right_out;
+            if (run_filter)
+              {
+                /* processing in place is ok */
+                outputs[2 * v]     = mix_left_out;
+                outputs[2 * v + 1] = mix_right_out;
+              }
+            else
+              {
+                // we keep running the filter even if it is disabled in order to have
+                // sane filter signal to switch to when the filter is enabled again
+                outputs[2 * v]     = &no_out[(2 * v) * n_frames];
+                outputs[2 * v + 1] = &no_out[(2 * v + 1) * n_frames];
+              }
+
+            if (fabs (voice->last_cutoff_ - cutoff) > 1e-7 || fabs (voice->last_key_track_ - key_track) > 1e-7)
+              {
+                const bool reset = voice->last_cutoff_ < -1000;
+
+                // original strategy for key tracking: cutoff * exp (amount * log (key / 261.63))
+                // but since cutoff_smooth_ is already in log2-frequency space, we can do it better
+
+                voice->cutoff_smooth_.set (fast_log2 (cutoff) + key_track * fast_log2 (voice->freq_ / 261.63), reset);
+                voice->last_cutoff_ = cutoff;
+                voice->last_key_track_ = key_track;
+              }
+            if (fabs (voice->last_cut_mod_ - cut_mod) > 1e-7)
+              {
+                const bool reset = voice->last_cut_mod_ < -1000;
+
+                voice->cut_mod_smooth_.set (cut_mod, reset);
+                voice->last_cut_mod_ = cut_mod;
+              }
+            /* TODO: possible improvements:
+             *  - exponential smoothing (get rid of exp2f)
+             *  - don't do anything if cutoff_smooth_->steps_ == 0 (add accessor)
+             */
+            float *voice_freq_in = &freq_in[v * n_frames];
+            for (uint i = 0; i < n_frames; i++)
+              voice_freq_in[i] = fast_exp2 (voice->cutoff_smooth_.get_next() + voice->fil_envelope_.get_next() * voice->cut_mod_smooth_.get_next());
+            freq_ins[v] = voice_freq_in;
+            vcfs[v] = &voice->vcf_;
           }
-        voice->vcf_.run_block (n_frames, cutoff, resonance, inputs, outputs, true, true, freq_in, nullptr, nullptr, nullptr);
+        /* --------- run ladder filter for all voices of the group --------- */
+        vcf_voices_.run_block (n_group, vcfs, n_frames, resonance, inputs, outputs, freq_ins);
 
         // apply volume envelope
-        for (uint i = 0; i < n_frames; i++)
-          {
-            float amp = 0.25 * voice->envelope_.get_next();
-            left_out[i] += mix_left_out[i] * amp;
-            right_out[i] += mix_right_out[i] * amp;
-          }
-        if (voice->envelope_.done())
+        for (uint v = 0; v < n_group; v++)
           {
-            voice->state_ = Voice::IDLE;
-            need_free = true;
+            Voice *voice = active_voices_[first + v];
+            const float *mix_left_out  = &mix_out[(2 * v) * n_frames];
+            const float *mix_right_out = &mix_out[(2 * v + 1) * n_frames];
+            for (uint i = 0; i < n_frames; i++)
+              {
+                float amp = 0.25 * voice->envelope_.get_next();
+                left_out[i] += mix_left_out[i] * amp;
+                right_out[i] += mix_right_out[i] * amp;
+              }
+            if (voice->envelope_.done())
+              {
+                voice->state_ = Voice::IDLE;
+                need_free = true;
+              }
           }
       }
     if (need_free)
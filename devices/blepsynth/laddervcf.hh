@@ -323,12 +323,250 @@ public:
   }
 };
 
+/* Ladder filter for polyphonic use, same model as LadderVCF
+ *
+ * The state of each voice is kept in a separate Voice object, and run_block() filters up to
+ * VOICES stereo voices at once, using a structure-of-arrays layout with one SIMD lane per
+ * voice channel. Mode, drive and resonance are shared by all voices, cutoff is per voice.
+ */
+template<bool OVERSAMPLE, bool NON_LINEAR>
+class LadderVCFVoices
+{
+public:
+  static constexpr uint VOICES = 4;
+  static constexpr uint LANES = 2 * VOICES;
+  class Voice {
+    friend class LadderVCFVoices;
+    float x1[2], x2[2], x3[2], x4[2];
+    float y1[2], y2[2], y3[2], y4[2];
+
+    // NOTE: Bse currently doesn't enforce SSE alignment so we force FPU resampling
+    Resampler2 res_up[2]   { { Resampler2::UP,   Resampler2::PREC_48DB, false }, { Resampler2::UP,   Resampler2::PREC_48DB, false } };
+    Resampler2 res_down[2] { { Resampler2::DOWN, Resampler2::PREC_48DB, false }, { Resampler2::DOWN, Resampler2::PREC_48DB, false } };
+  public:
+    Voice()
+    {
+      reset();
+    }
+    void
+    reset()
+    {
+      for (uint c = 0; c < 2; c++)
+        {
+          x1[c] = x2[c] = x3[c] = x4[c] = 0;
+          y1[c] = y2[c] = y3[c] = y4[c] = 0;
+
+          res_up[c].reset();
+          res_down[c].reset();
+        }
+    }
+  };
+private:
+  /* smaller groups use narrower vectors, so a single voice does not pay for unused lanes */
+  template<uint N>
+  struct Lanes
+  {
+    typedef float FloatV __attribute__ ((vector_size (N * sizeof (float))));
+  };
+
+  LadderVCFMode mode = LadderVCFMode::LP4;
+  float pre_scale = 1, post_scale = 1;
+  float rate = 48000;
+
+  template<class FloatV> static FloatV
+  distort (FloatV x)
+  {
+    if (NON_LINEAR)
+      {
+        /* shaped somewhat similar to tanh() and others, but faster */
+        x = x < -1.0f ? FloatV {} - 1.0f : x;
+        x = x > 1.0f ? FloatV {} + 1.0f : x;
+
+        return x - x * x * x * (1.0f / 3);
+      }
+    else
+      {
+        return x;
+      }
+  }
+  template<LadderVCFMode MODE, uint N> void
+  run_lanes (typename Lanes<N>::FloatV *values, const typename Lanes<N>::FloatV *cutoff, uint n_samples, double res,
+             Voice **voices, uint n_voices)
+  {
+    typedef typename Lanes<N>::FloatV FloatV;
+
+    FloatV x1, x2, x3, x4, y1, y2, y3, y4;
+    for (uint l = 0; l < N; l++)
+      {
+        const Voice *v = l / 2 < n_voices ? voices[l / 2] : nullptr;
+        const uint c = l & 1;
+        x1[l] = v ? v->x1[c] : 0; x2[l] = v ? v->x2[c] : 0; x3[l] = v ? v->x3[c] : 0; x4[l] = v ? v->x4[c] : 0;
+        y1[l] = v ? v->y1[c] : 0; y2[l] = v ? v->y2[c] : 0; y3[l] = v ? v->y3[c] : 0; y4[l] = v ? v->y4[c] : 0;
+      }
+    constexpr uint oversample_count = OVERSAMPLE ? 2 : 1;
+    for (uint i = 0; i < n_samples; i++)
+      {
+        const FloatV fc = float (M_PI) * cutoff[i];
+        const FloatV g = 0.9892f * fc - 0.4342f * fc * fc + 0.1381f * fc * fc * fc - 0.0202f * fc * fc * fc * fc;
+        const FloatV gg = g * g;
+        const FloatV r = float (res) * (1.0029f + 0.0526f * fc - 0.0926f * fc * fc + 0.0218f * fc * fc * fc);
+        const FloatV g1 = 1.0f - g;
+
+        for (uint os = 0; os < oversample_count; os++)
+          {
+            FloatV& value = values[i * oversample_count + os];
+            const FloatV x = value * pre_scale;
+            const float g_comp = 0.5; // passband gain correction
+            const FloatV x0 = distort (x - (y4 - g_comp * x) * r * 4.0f) * gg * gg * float (1.0 / 1.3 / 1.3 / 1.3 / 1.3);
+
+            y1 = x0 + x1 * 0.3f + y1 * g1;
+            x1 = x0;
+
+            y2 = y1 + x2 * 0.3f + y2 * g1;
+            x2 = y1;
+
+            y3 = y2 + x3 * 0.3f + y3 * g1;
+            x3 = y2;
+
+            y4 = y3 + x4 * 0.3f + y4 * g1;
+            x4 = y3;
+
+            switch (MODE)
+              {
+                case LadderVCFMode::LP1:
+                  value = y1 / (gg * g * float (1.0 / (1.3 * 1.3 * 1.3))) * post_scale;
+                  break;
+                case LadderVCFMode::LP2:
+                  value = y2 / (gg * float (1.0 / (1.3 * 1.3))) * post_scale;
+                  break;
+                case LadderVCFMode::LP3:
+                  value = y3 / (g * float (1.0 / 1.3)) * post_scale;
+                  break;
+                case LadderVCFMode::LP4:
+                  value = y4 * post_scale;
+                  break;
+              }
+          }
+      }
+    for (uint l = 0; l < 2 * n_voices; l++)
+      {
+        Voice *v = voices[l / 2];
+        const uint c = l & 1;
+        v->x1[c] = x1[l]; v->x2[c] = x2[l]; v->x3[c] = x3[l]; v->x4[c] = x4[l];
+        v->y1[c] = y1[l]; v->y2[c] = y2[l]; v->y3[c] = y3[l]; v->y4[c] = y4[l];
+      }
+  }
+public:
+  void
+  set_mode (LadderVCFMode new_mode)
+  {
+    mode = new_mode;
+  }
+  void
+  set_drive (double drive_db)
+  {
+    const double drive_delta_db = 36;
+
+    pre_scale = bse_db_to_factor (drive_db - drive_delta_db);
+    post_scale = std::max (1 / pre_scale, 1.0f);
+  }
+  void
+  set_rate (double r)
+  {
+    rate = r;
+  }
+private:
+  template<uint N> void
+  run_voices (uint           n_voices,
+              Voice        **voices,
+              uint           n_samples,
+              double         res,
+              const float  **inputs,
+              float        **outputs,
+              const float  **freq_in)
+  {
+    typedef typename Lanes<N>::FloatV FloatV;
+
+    constexpr uint oversample_count = OVERSAMPLE ? 2 : 1;
+    const float freq_scale = OVERSAMPLE ? 0.5 : 1.0;
+    const float nyquist    = rate * 0.5;
+
+    /* transpose per channel blocks into one vector per (over)sample */
+    FloatV values[oversample_count * n_samples], cutoff[n_samples];
+    float  over_samples[oversample_count * n_samples];
+    for (uint l = 0; l < N; l++)
+      {
+        if (l >= 2 * n_voices)
+          {
+            for (uint i = 0; i < oversample_count * n_samples; i++)
+              values[i][l] = 0;
+            continue;
+          }
+        const float *lane_values = inputs[l];
+        if (OVERSAMPLE)
+          {
+            voices[l / 2]->res_up[l & 1].process_block (inputs[l], n_samples, over_samples);
+            lane_values = over_samples;
+          }
+        for (uint i = 0; i < oversample_count * n_samples; i++)
+          values[i][l] = lane_values[i];
+      }
+    for (uint l = 0; l < N; l += 2)
+      for (uint i = 0; i < n_samples; i++)
+        {
+          float fc = l / 2 < n_voices ? BSE_SIGNAL_TO_FREQ (freq_in[l / 2][i]) * freq_scale / nyquist : 0;
+          fc = std::clamp (fc, 0.f, 1.f);
+          cutoff[i][l] = fc;
+          cutoff[i][l + 1] = fc;
+        }
+    switch (mode)
+      {
+      case LadderVCFMode::LP4: run_lanes<LadderVCFMode::LP4, N> (values, cutoff, n_samples, res, voices, n_voices);     break;
+      case LadderVCFMode::LP3: run_lanes<LadderVCFMode::LP3, N> (values, cutoff, n_samples, res, voices, n_voices);     break;
+      case LadderVCFMode::LP2: run_lanes<LadderVCFMode::LP2, N> (values, cutoff, n_samples, res, voices, n_voices);     break;
+      case LadderVCFMode::LP1: run_lanes<LadderVCFMode::LP1, N> (values, cutoff, n_samples, res, voices, n_voices);     break;
+      }
+    for (uint l = 0; l < 2 * n_voices; l++)
+      {
+        float *lane_values = OVERSAMPLE ? over_samples : outputs[l];
+        for (uint i = 0; i < oversample_count * n_samples; i++)
+          lane_values[i] = values[i][l];
+        if (OVERSAMPLE)
+          voices[l / 2]->res_down[l & 1].process_block (over_samples, 2 * n_samples, outputs[l]);
+      }
+  }
+public:
+  /* filter `n_voices <= VOICES` stereo voices, inputs and outputs hold the left and right
+   * channel for each voice, freq_in the cutoff per voice (see LadderVCF::run_block())
+   */
+  void
+  run_block (uint           n_voices,
+             Voice        **voices,
+             uint           n_samples,
+             double         res,
+             const float  **inputs,
+             float        **outputs,
+             const float  **freq_in)
+  {
+    BSE_ASSERT_RETURN (n_voices <= VOICES);
+    if (n_voices == 1)
+      run_voices<2> (n_voices, voices, n_samples, res, inputs, outputs, freq_in);
+    else if (n_voices == 2)
+      run_voices<4> (n_voices, voices, n_samples, res, inputs, outputs, freq_in);
+    else
+      run_voices<LANES> (n_voices, voices, n_samples, res, inputs, outputs, freq_in);
+  }
+};
+
 // fast linear model of the filter
 typedef LadderVCF<false, false> LadderVCFLinear;
 
 // slow but accurate non-linear model of the filter (uses oversampling)
 typedef LadderVCF<true,  true>  LadderVCFNonLinear;
 
+// slow but accurate non-linear model for several voices at once (uses oversampling)
+typedef LadderVCFVoices<true, true> LadderVCFVoicesNonLinear;
+
 // fast non-linear version (no oversampling), may have aliasing
 typedef LadderVCF<false, true>  LadderVCFNonLinearCheap;
 
@@ -0,0 +1,283 @@
+// This Source Code Form is licensed MPL-2.0: http://mozilla.org/MPL/2.0
+#ifndef __BSE_DEVICES_CONVOLUTION_HH__
+#define __BSE_DEVICES_CONVOLUTION_HH__
+
+#include <bse/processor.hh>
+#include <bse/gslfft.hh>
+#include <bse/profiler.hh>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <limits.h>
+#include <thread>
+
+namespace Bse {
+namespace ConvolverUtils {
+
+/* Non-uniformly partitioned convolution.
+ * The impulse response is split into segments of growing partition size. Each segment runs
+ * a uniformly partitioned overlap-save convolution with a frequency domain delay line (FDL).
+ * The head segment uses partitions of MAX_RENDER_BLOCK_SIZE and is computed in the render
+ * thread, so no latency is added. A segment with partition size L starts at an IR offset of
+ * 2 * L, which gives its worker thread a full partition period to compute a chunk before
+ * the result is due, so tail segments with large, cheap partitions run concurrently.
+ * The render thread never waits for a worker, a chunk that is not ready in time is dropped
+ * and counted as xrun.
+ */
+enum : uint {
+  HEAD_SIZE   = AudioSignal::MAX_RENDER_BLOCK_SIZE,     // partition size computed in the render thread
+  TAIL1_SIZE  = 2048,                   // covers [2 * TAIL1_SIZE, 2 * TAIL2_SIZE)
+  TAIL2_SIZE  = 16384,                  // covers [2 * TAIL2_SIZE, end)
+  MAX_SECONDS = 30,                     // truncate longer impulse responses
+};
+
+static inline void
+futex_wait (std::atomic<int> &state, int value)
+{
+  static_assert (sizeof (state) == sizeof (int), "");
+  syscall (SYS_futex, &state, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+static inline void
+futex_wake_all (std::atomic<int> &state)
+{
+  syscall (SYS_futex, &state, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+// Uniformly partitioned overlap-save convolution of a single channel.
+class PartitionedConvolver {
+  const GslFftPlan  *plan_ = nullptr;   // real transform of 2 * psize_ values
+  uint               psize_ = 0, n_parts_ = 0, fdl_pos_ = 0;
+  std::vector<float> spectra_;          // n_parts_ IR partition spectra
+  std::vector<float> fdl_;              // n_parts_ input spectra, fdl_pos_ is the latest
+  std::vector<float> frame_;            // previous and current input partition
+  std::vector<float> acc_, tmp_;
+public:
+  void
+  setup (const GslFftPlan *plan, const float *ir, uint ir_length)
+  {
+    plan_ = plan;
+    const uint fftsize = gsl_fft_plan_n_values (plan);
+    psize_ = fftsize / 2;
+    n_parts_ = (ir_length + psize_ - 1) / psize_;
+    spectra_.assign (n_parts_ * fftsize, 0);
+    fdl_.assign (n_parts_ * fftsize, 0);
+    frame_.assign (fftsize, 0);
+    acc_.resize (fftsize);
+    tmp_.resize (fftsize);
+    for (uint p = 0; p < n_parts_; p++)
+      {
+        const uint n = std::min (psize_, ir_length - p * psize_);
+        std::fill (tmp_.begin(), tmp_.end(), 0);
+        std::copy (ir + p * psize_, ir + p * psize_ + n, tmp_.begin());
+        gsl_fft_plan_fftar (plan_, tmp_.data(), &spectra_[p * fftsize]);
+      }
+    fdl_pos_ = 0;
+  }
+  void
+  reset ()
+  {
+    std::fill (fdl_.begin(), fdl_.end(), 0);
+    std::fill (frame_.begin(), frame_.end(), 0);
+  }
+  // Convolve the next psize_ input values into psize_ output values.
+  void
+  process (const float *input, float *output)
+  {
+    const uint fftsize = 2 * psize_;
+    std::copy (frame_.begin() + psize_, frame_.end(), frame_.begin());
+    std::copy (input, input + psize_, frame_.begin() + psize_);
+    fdl_pos_ = fdl_pos_ + 1 < n_parts_ ? fdl_pos_ + 1 : 0;
+    gsl_fft_plan_fftar (plan_, frame_.data(), &fdl_[fdl_pos_ * fftsize]);
+    std::fill (acc_.begin(), acc_.end(), 0);
+    float *__restrict acc = acc_.data();
+    for (uint p = 0, x = fdl_pos_; p < n_parts_; p++, x = x ? x - 1 : n_parts_ - 1)
+      {
+        const float *__restrict X = &fdl_[x * fftsize], *__restrict H = &spectra_[p * fftsize];
+        acc[0] += X[0] * H[0];  // DC
+        acc[1] += X[1] * H[1];  // Nyquist
+        for (uint i = 2; i < fftsize; i += 2)
+          {
+            acc[i]     += X[i] * H[i]     - X[i + 1] * H[i + 1];
+            acc[i + 1] += X[i] * H[i + 1] + X[i + 1] * H[i];
+          }
+      }
+    gsl_fft_plan_fftsr_scale (plan_, acc, tmp_.data());
+    std::copy (tmp_.begin() + psize_, tmp_.end(), output);
+  }
+};
+
+// Stereo convolution of an impulse response, possibly spread across worker threads.
+class Convolution {
+  struct Segment {
+    GslFftPlan          *plan = nullptr;
+    PartitionedConvolver conv[2];
+    explicit Segment (uint psize) : plan (gsl_fft_plan_new (2 * psize)) {}
+    virtual ~Segment () { gsl_fft_plan_free (plan); }
+  };
+  // Tail segments are double buffered, chunk `c` is convolved while chunk `c + 1` is recorded.
+  struct Tail : Segment {
+    const uint          psize;
+    std::vector<float>  buffers[2][2][2]; // [chunk & 1][input,output][channel]
+    uint64              chunk = 0;
+    uint                pos = 0;
+    bool                late = false;   // the worker missed the current chunk
+    std::atomic<int64>  dropped[2] = { -1, -1 };  // chunk whose input was not recorded
+    std::atomic<int>    posted = 0, done = 0;
+    std::atomic<bool>   quit = false;
+    std::thread         thread;
+    explicit
+    Tail (uint psize_) :
+      Segment (psize_), psize (psize_)
+    {
+      for (auto &io : buffers)
+        for (auto &channels : io)
+          for (auto &b : channels)
+            b.resize (psize);
+    }
+    ~Tail ()
+    {
+      quit = true;
+      posted++;
+      futex_wake_all (posted);
+      if (thread.joinable())
+        thread.join();
+    }
+    void
+    worker ()
+    {
+      Bse::this_thread_set_name ("Convolver-" + string_from_int (psize));
+      int job = 0;
+      for (;;)
+        {
+          const int p = posted.load (std::memory_order_acquire);
+          if (quit)
+            break;
+          if (p == job)
+            {
+              futex_wait (posted, p);
+              continue;
+            }
+          auto &io = buffers[job & 1];
+          if (dropped[job & 1].load (std::memory_order_relaxed) == job)
+            for (uint c = 0; c < 2; c++)        // convolve silence in place of the dropped chunk
+              std::fill (io[0][c].begin(), io[0][c].end(), 0);
+          for (uint c = 0; c < 2; c++)
+            conv[c].process (io[0][c].data(), io[1][c].data());
+          job++;
+          done.store (job, std::memory_order_release);
+          futex_wake_all (done);
+        }
+    }
+    void
+    wait_done (int job)
+    {
+      for (int d = done.load (std::memory_order_acquire); d - job < 0; d = done.load (std::memory_order_acquire))
+        futex_wait (done, d);
+    }
+  };
+  Segment                           head_ { HEAD_SIZE };
+  std::vector<std::unique_ptr<Tail>> tails_;
+  uint                              ir_length_ = 0;
+public:
+  explicit
+  Convolution (std::vector<float> ir[2])
+  {
+    ir_length_ = ir[0].size();
+    const uint offsets[] = { 0, 2 * TAIL1_SIZE, 2 * TAIL2_SIZE, UINT_MAX };
+    const uint sizes[] = { HEAD_SIZE, TAIL1_SIZE, TAIL2_SIZE };
+    for (uint s = 0; s < 3 && ir_length_ > offsets[s]; s++)
+      {
+        const uint n = std::min (ir_length_, offsets[s + 1]) - offsets[s];
+        Segment *segment = &head_;
+        if (s)
+          {
+            tails_.push_back (std::make_unique<Tail> (sizes[s]));
+            segment = tails_.back().get();
+          }
+        for (uint c = 0; c < 2; c++)
+          segment->conv[c].setup (segment->plan, &ir[c][offsets[s]], n);
+      }
+    for (auto &tail : tails_)
+      tail->thread = std::thread (&Tail::worker, tail.get());
+  }
+  uint
+  ir_length () const
+  {
+    return ir_length_;
+  }
+  // Wait for the workers to complete all posted chunks, RT-Unsafe.
+  void
+  sync ()
+  {
+    for (auto &tail : tails_)
+      tail->wait_done (tail->posted);
+  }
+  // Wait for the workers to go idle, then clear all convolution state, RT-Unsafe.
+  void
+  reset ()
+  {
+    sync();
+    for (auto &tail : tails_)
+      for (auto &io : tail->buffers)
+        for (auto &channels : io)
+          for (auto &b : channels)
+            std::fill (b.begin(), b.end(), 0);
+    for (uint c = 0; c < 2; c++)
+      {
+        head_.conv[c].reset();
+        for (auto &tail : tails_)
+          tail->conv[c].reset();
+      }
+  }
+  // Convolve HEAD_SIZE frames of `input` into `output`.
+  void
+  process (const float *input[2], float *output[2])
+  {
+    if (ir_length_ == 0)
+      {
+        floatfill (output[0], 0.0, HEAD_SIZE);
+        floatfill (output[1], 0.0, HEAD_SIZE);
+        return;
+      }
+    for (uint c = 0; c < 2; c++)
+      head_.conv[c].process (input[c], output[c]);
+    for (auto &tail : tails_)
+      {
+        if (tail->pos == 0)
+          {
+            // the buffers of chunk - 2 are reused, the worker must have completed it
+            const int job = tail->chunk - 1;
+            tail->late = tail->chunk >= 2 && tail->done.load (std::memory_order_acquire) - job < 0;
+            if (BSE_UNLIKELY (tail->late))
+              Profiler::count_xrun();
+          }
+        if (BSE_ISLIKELY (!tail->late))
+          {
+            auto &buffers = tail->buffers[tail->chunk & 1];
+            for (uint c = 0; c < 2; c++)
+              {
+                floatcopy (&buffers[0][c][tail->pos], input[c], HEAD_SIZE);
+                const float *tailout = &buffers[1][c][tail->pos];
+                for (uint i = 0; i < HEAD_SIZE; i++)
+                  output[c][i] += tailout[i];
+              }
+          }
+        tail->pos += HEAD_SIZE;
+        if (tail->pos == tail->psize)
+          {
+            tail->pos = 0;
+            if (tail->late)
+              tail->dropped[tail->chunk & 1].store (tail->chunk, std::memory_order_relaxed);
+            tail->chunk++;
+            tail->posted.fetch_add (1, std::memory_order_release);
+            futex_wake_all (tail->posted);
+          }
+      }
+  }
+};
+
+} // ConvolverUtils
+} // Bse
+
+#endif // __BSE_DEVICES_CONVOLUTION_HH__
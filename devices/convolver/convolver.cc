@@ -0,0 +1,237 @@
+// This Source Code Form is licensed MPL-2.0: http://mozilla.org/MPL/2.0
+#include "bse/processor.hh"
+#include "devices/convolver/convolution.hh"
+#include "bse/bseblockutils.hh"
+#include "bse/gsldatahandle.hh"
+#include "bse/bseloader.hh"
+#include "bse/bsemain.hh"
+#include "bse/sfifilecrawler.hh"
+#include "bse/path.hh"
+#include "bse/internal.hh"
+
+#define CDEBUG(...)     Bse::debug ("convolver", __VA_ARGS__)
+
+namespace {
+
+using namespace Bse;
+using namespace Bse::ConvolverUtils;
+using namespace AudioSignal;
+
+// Load an impulse response as stereo channels at `mix_freq`, normalized to unit energy.
+static String
+load_impulse (const String &filename, uint mix_freq, std::vector<float> ir[2])
+{
+  Bse::Error error = Bse::Error::NONE;
+  BseWaveFileInfo *wfi = bse_wave_file_info_load (filename.c_str(), &error);
+  BseWaveDsc *wdsc = wfi ? bse_wave_dsc_load (wfi, 0, FALSE, &error) : nullptr;
+  GslDataHandle *dhandle = wdsc ? bse_wave_handle_create (wdsc, 0, &error) : nullptr;
+  if (dhandle)
+    error = gsl_data_handle_open (dhandle);
+  if (dhandle && error == Bse::Error::NONE)
+    {
+      const uint n_channels = gsl_data_handle_n_channels (dhandle);
+      const double ratio = gsl_data_handle_mix_freq (dhandle) / mix_freq;
+      const int64 n_frames = gsl_data_handle_length (dhandle) / n_channels;
+      std::vector<float> values (n_frames * n_channels);
+      for (int64 offset = 0; offset < int64 (values.size()); )
+        {
+          const int64 l = gsl_data_handle_read (dhandle, offset, values.size() - offset, &values[offset]);
+          if (l <= 0)
+            {
+              values.resize (offset - offset % n_channels);
+              break;
+            }
+          offset += l;
+        }
+      const int64 n_values = values.size() / n_channels;
+      const int64 n_output = std::min (int64 (n_values / ratio), int64 (MAX_SECONDS) * mix_freq);
+      double max_energy = 0;
+      for (uint c = 0; c < 2; c++)
+        {
+          const uint ic = std::min (c, n_channels - 1);
+          ir[c].resize (n_output);
+          double energy = 0;
+          for (int64 i = 0; i < n_output; i++)   // linear interpolation if rates differ
+            {
+              const double pos = i * ratio;
+              const int64 j = pos;
+              const double frac = pos - j;
+              const float v0 = values[j * n_channels + ic];
+              const float v1 = j + 1 < n_values ? values[(j + 1) * n_channels + ic] : 0;
+              ir[c][i] = v0 + frac * (v1 - v0);
+              energy += ir[c][i] * ir[c][i];
+            }
+          max_energy = std::max (max_energy, energy);
+        }
+      if (max_energy > 0)
+        for (uint c = 0; c < 2; c++)
+          bse_block_scale_floats (ir[c].size(), ir[c].data(), ir[c].data(), 1.0 / std::sqrt (max_energy));
+      gsl_data_handle_close (dhandle);
+    }
+  if (dhandle)
+    gsl_data_handle_unref (dhandle);
+  if (wdsc)
+    bse_wave_dsc_free (wdsc);
+  if (wfi)
+    bse_wave_file_info_unref (wfi);
+  return error == Bse::Error::NONE ? "" : bse_error_blurb (error);
+}
+
+class Convolver : public AudioSignal::Processor {
+  IBusId stereoin;
+  OBusId stereout;
+  float  dry_ = 1, wet_ = 1;
+  uint   mix_freq_ = 0;
+  StringVector impulses_;                       // files listed by IMPULSE choices
+  Convolution *current_ = nullptr;              // owned by the render thread
+  std::atomic<Convolution*> pending_ = nullptr; // loader -> render thread
+  std::atomic<Convolution*> retired_ = nullptr; // render thread -> loader
+  std::atomic<int>  impulse_ = 0;
+  std::atomic<int>  loader_seq_ = 0;
+  std::atomic<bool> loader_quit_ = false;
+  std::thread       loader_;
+  void
+  query_info (ProcessorInfo &info) override
+  {
+    info.uri = "Bse.Convolver";
+    info.version = "0";
+    info.label = "Convolver";
+    info.category = "Reverb";
+    info.website_url = "https://beast.testbit.eu";
+  }
+  enum Params { IMPULSE = 1, DRY, WET };
+  void
+  initialize () override
+  {
+    mix_freq_ = sample_rate();
+    String sample_path = Bse::config_string ("override-sample-path");
+    if (sample_path.empty())
+      sample_path = Path::searchpath_join (Bse::runpath (Bse::RPath::SAMPLEDIR), Bse::global_prefs->sample_path);
+    SfiRing *files = sfi_file_crawler_list_files (Path::searchpath_multiply (sample_path, "Impulses").c_str(),
+                                                  "*.wav", G_FILE_TEST_IS_REGULAR);
+    for (SfiRing *walk = files; walk; walk = sfi_ring_walk (files, walk))
+      {
+        char *fname = (char*) walk->data;
+        impulses_.push_back (fname);
+        g_free (fname);
+      }
+    sfi_ring_free (files);
+    std::sort (impulses_.begin(), impulses_.end());
+
+    ChoiceEntries centries;
+    centries += { "None", "Pass the dry signal only" };
+    for (const auto &fname : impulses_)
+      centries += { Path::basename (fname), fname };
+    start_param_group ("Impulse Response");
+    add_param (IMPULSE, "Impulse", "IR", std::move (centries), 0, "", "Impulse response found in the Impulses/ sample directories");
+
+    start_param_group ("Levels");
+    add_param (DRY, "Dry level", "Dry", -96, 24, 0, "dB");
+    add_param (WET, "Wet level", "Wet", -96, 24, -6, "dB");
+
+    loader_ = std::thread (&Convolver::loader_thread, this);
+  }
+  void
+  loader_thread ()
+  {
+    Bse::this_thread_set_name ("ConvolverLoader");
+    int seen = 0, loaded = -1;
+    while (!loader_quit_)
+      {
+        const int seq = loader_seq_.load();
+        if (seq == seen)
+          {
+            futex_wait (loader_seq_, seq);
+            continue;
+          }
+        seen = seq;
+        delete retired_.exchange (nullptr);
+        const int impulse = impulse_;
+        if (impulse == loaded)
+          continue;
+        loaded = impulse;
+        std::vector<float> ir[2];
+        if (impulse > 0 && impulse <= int (impulses_.size()))
+          {
+            const String err = load_impulse (impulses_[impulse - 1], mix_freq_, ir);
+            if (!err.empty())
+              Bse::info ("%s: failed to load impulse response: %s: %s", debug_name(), impulses_[impulse - 1], err);
+            else
+              CDEBUG ("%s: loaded impulse response: %s: %zu frames", debug_name(), impulses_[impulse - 1], ir[0].size());
+          }
+        delete pending_.exchange (new Convolution (ir));
+      }
+  }
+  void
+  wake_loader ()
+  {
+    loader_seq_++;
+    futex_wake_all (loader_seq_);
+  }
+  void
+  configure (uint n_ibusses, const SpeakerArrangement *ibusses, uint n_obusses, const SpeakerArrangement *obusses) override
+  {
+    remove_all_buses();
+    stereoin = add_input_bus  ("Stereo In",  SpeakerArrangement::STEREO);
+    stereout = add_output_bus ("Stereo Out", SpeakerArrangement::STEREO);
+  }
+  void
+  adjust_param (Id32 tag) override
+  {
+    switch (Params (tag.id))
+      {
+      case DRY:         dry_ = bse_db_to_factor (get_param (tag));      break;
+      case WET:         wet_ = bse_db_to_factor (get_param (tag));      break;
+      case IMPULSE:
+        impulse_ = bse_ftoi (get_param (tag));
+        wake_loader();
+        break;
+      }
+  }
+  void
+  reset () override
+  {
+    adjust_params (true);
+    if (current_)
+      current_->reset();
+  }
+  void
+  render (uint n_frames) override
+  {
+    adjust_params (false);
+    if (BSE_UNLIKELY (pending_.load (std::memory_order_relaxed)) && !retired_.load (std::memory_order_relaxed))
+      {
+        retired_.store (current_, std::memory_order_relaxed);
+        current_ = pending_.exchange (nullptr, std::memory_order_acq_rel);
+        wake_loader();
+      }
+    const float *input[2] = { ifloats (stereoin, 0), ifloats (stereoin, 1) };
+    float *output[2] = { oblock (stereout, 0), oblock (stereout, 1) };
+    if (!current_ || current_->ir_length() == 0)
+      {
+        for (uint c = 0; c < 2; c++)
+          bse_block_scale_floats (n_frames, output[c], input[c], dry_);
+        return;
+      }
+    current_->process (input, output);
+    for (uint c = 0; c < 2; c++)
+      for (uint i = 0; i < n_frames; i++)
+        output[c][i] = dry_ * input[c][i] + wet_ * output[c][i];
+  }
+public:
+  ~Convolver ()
+  {
+    if (loader_.joinable())
+      {
+        loader_quit_ = true;
+        wake_loader();
+        loader_.join();
+      }
+    delete current_;
+    delete pending_.exchange (nullptr);
+    delete retired_.exchange (nullptr);
+  }
+};
+static auto convolver = Bse::enroll_asp<Convolver>();
+
+} // Anon
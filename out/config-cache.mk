@@ -0,0 +1 @@
+out/config-cache.mk: FORCE
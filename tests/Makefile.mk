@@ -12,6 +12,7 @@ tests/suite.sources		::= $(strip	\
 	tests/benchmarks.cc			\
 	tests/blocktests.cc			\
 	tests/checkserialize.cc			\
+	tests/devicetests.cc			\
 	tests/explore-tests.cc			\
 	tests/filterdesign.cc			\
 	tests/filtertest.cc			\
@@ -2,7 +2,16 @@
 #include <bse/testing.hh>
 #include <bse/unicode.hh>
 #include <bse/memory.hh>
+#include <bse/storage.hh>
+#include <bse/path.hh>
+#include <bse/gsloscillator.hh>
+#include <bse/bsemathsignal.hh>
+#include <bse/bseengineschedule.hh>
+#include <bse/bseengineutils.hh>
+#include <bse/bseenginemaster.hh>
 #include <cmath>
+#include <sys/stat.h>
+#include <unistd.h>
 
 static constexpr size_t RUNS = 1;
 static constexpr double MAXTIME = 0.15;
@@ -369,3 +378,258 @@ aligned_allocator_bench31_fast_mem_alloc()
 TEST_BENCH (aligned_allocator_bench31_fast_mem_alloc);
 
 } // Anon
+
+// == DSP Scheduler Benchmarks ==
+namespace { // Anon
+using namespace Bse;
+
+/* DSP graph of engine modules, sorted by level where each module reads from modules of the
+ * previous level. Blocks are rendered through the engine's task schedule and node queue, i.e.
+ * _engine_schedule_secure(), _engine_set_schedule(), _engine_pop_unprocessed_node() and
+ * _engine_push_processed_node(), as done by the master and slave threads.
+ */
+static void
+sched_bench_process (BseModule *module, uint n_values)
+{
+  float *block = BSE_MODULE_OBUFFER (module, 0);
+  for (uint r = 0; r < 16; r++)
+    for (uint i = 0; i < n_values; i++)
+      {
+        float accu = block[i] * 0.5;
+        for (uint j = 0; j < BSE_MODULE_N_ISTREAMS (module); j++)
+          if (BSE_MODULE_ISTREAM (module, j).connected)
+            accu += BSE_MODULE_IBUFFER (module, j)[i] * 0.25;
+        block[i] = accu + 0.001 * i;
+      }
+}
+
+struct SchedBenchGraph {
+  std::vector<BseModule*> modules;
+  EngineSchedule         *schedule = NULL;
+  SchedBenchGraph (uint n_levels, uint width)
+  {
+    static const BseModuleClass sched_bench_class = {
+      3, 0, 1,                  // n_istreams, n_jstreams, n_ostreams
+      sched_bench_process, NULL, NULL, NULL, Bse::ModuleFlag::NORMAL,
+    };
+    quick_rand32_seed = 2654435769;
+    for (uint l = 0; l < n_levels; l++)
+      for (uint w = 0; w < width; w++)
+        {
+          BseModule *module = bse_module_new (&sched_bench_class, NULL);
+          const uint n_inputs = l ? 1 + quick_rand32() % 3 : 0;
+          for (uint i = 0; i < n_inputs; i++)
+            connect (module, i, modules[(l - 1) * width + quick_rand32() % width]);
+          module->is_consumer = l + 1 == n_levels;
+          modules.push_back (module);
+        }
+    // schedule like master_reschedule_flow()
+    schedule = _engine_schedule_new();
+    for (BseModule *module : modules)
+      if (BSE_MODULE_IS_CONSUMER (module))
+        _engine_schedule_consumer_node (schedule, module);
+    _engine_schedule_secure (schedule);
+  }
+  ~SchedBenchGraph()
+  {
+    _engine_schedule_unsecure (schedule);
+    _engine_schedule_destroy (schedule);
+    for (BseModule *module : modules)
+      {
+        sfi_ring_free (module->output_nodes);
+        module->output_nodes = NULL;
+        delete module;
+      }
+  }
+  // like ENGINE_JOB_ICONNECT
+  static void
+  connect (BseModule *module, uint istream, BseModule *src_module)
+  {
+    module->inputs[istream].src_node = src_module;
+    module->inputs[istream].src_stream = 0;
+    src_module->outputs[0].n_outputs += 1;
+    src_module->output_nodes = sfi_ring_append (src_module->output_nodes, module);
+  }
+  // like master_process_locked_node() for scheduled inputs that are already processed
+  static void
+  render (BseModule *module, uint64 stamp)
+  {
+    for (uint i = 0; i < BSE_MODULE_N_ISTREAMS (module); i++)
+      {
+        BseModule *inode = module->inputs[i].real_node;
+        module->istreams[i].values = inode ? inode->outputs[module->inputs[i].real_stream].buffer :
+                                     bse_engine_const_zeros (BSE_ENGINE_MAX_BLOCK_SIZE);
+      }
+    module->ostreams[0].values = module->outputs[0].buffer;
+    module->process (bse_engine_block_size());
+    module->counter = stamp;
+  }
+  // like thread_process_nodes()
+  static void
+  run (uint worker, uint64 stamp)
+  {
+    if (!_engine_process_enter())
+      return;
+    for (BseModule *module = _engine_pop_unprocessed_node (worker); module; module = _engine_pop_unprocessed_node (worker))
+      {
+        render (module, stamp);
+        _engine_push_processed_node (worker, module);
+      }
+    _engine_process_leave();
+  }
+  void
+  render_blocks (uint64 first_stamp, uint n_blocks)
+  {
+    const uint n_workers = _engine_n_workers();
+    std::atomic<uint64> block { 0 };
+    std::atomic<uint> done { 0 };
+    std::atomic<bool> quit { false };
+    std::vector<std::thread> threads;
+    for (uint w = 1; w < n_workers; w++)
+      threads.push_back (std::thread ([&, w] () {
+            uint64 last = 0;
+            for (;;)
+              {
+                while (block == last && !quit)
+                  std::this_thread::yield();
+                if (quit)
+                  break;
+                last = block;
+                run (w, last);
+                done += 1;
+              }
+          }));
+    for (uint64 stamp = first_stamp; stamp < first_stamp + n_blocks; stamp++)
+      {
+        // like master_process_flow()
+        _engine_schedule_restart (schedule);
+        _engine_set_schedule (schedule);
+        done = 0;
+        block = stamp;
+        run (0, stamp);
+        _engine_wait_on_unprocessed();
+        _engine_unset_schedule (schedule);
+        while (done < n_workers - 1)
+          std::this_thread::yield();
+      }
+    quit = true;
+    for (auto &thread : threads)
+      thread.join();
+  }
+};
+
+static void
+engine_scheduler_bench()
+{
+  const uint n_blocks = 64;
+  SchedBenchGraph graph (8, 64);
+  // the DSP slave threads own the worker deques 1..n, keep them idle while the graph is rendered
+  BseInternal::engine_stop_slaves();
+  Bse::Test::Timer timer (MAXTIME);
+  uint64 stamp = 1;
+  const double bench_time = timer.benchmark ([&] () {
+      graph.render_blocks (stamp, n_blocks);
+      stamp += n_blocks;
+    });
+  BseInternal::engine_start_slaves();
+  Bse::printerr ("  BENCH    Engine node queue:    %u threads, %u nodes: %8.1f usecs/block\n",
+                 _engine_n_workers(), graph.schedule->n_tasks, bench_time * M / n_blocks);
+  for (uint i = 0; i < graph.schedule->n_tasks; i++)
+    TASSERT (graph.schedule->tasks[i].node->counter == stamp - 1);
+}
+TEST_BENCH (engine_scheduler_bench);
+
+
+// == Project Storage Benchmarks ==
+static void
+storage_save_bench()
+{
+  // project-like payload: s-expression text plus incompressible sample data, as in FLAC blobs
+  std::string scm, flac;
+  uint32_t r = 0x12345678;
+  while (scm.size() < 8 * 1024 * 1024)
+    {
+      r = r * 1664525 + 1013904223;
+      scm += Bse::string_format ("    (insert-note %u 0x%02x %d)\n", r >> 12, (r >> 4) & 0x7f, int (r & 0xf) - 8);
+    }
+  while (flac.size() < 16 * 1024 * 1024)
+    {
+      r = r * 1664525 + 1013904223;
+      flac += char (r >> 24);
+    }
+  const std::string filename = Bse::Path::join (Bse::beastbse_cachedir_current(), "storage-bench.bse");
+  Bse::Storage storage;
+  TASSERT (storage.set_mimetype_bse());
+  int fd = storage.store_file_fd ("bse_storage.scm");
+  TASSERT (fd >= 0 && write (fd, scm.data(), scm.size()) == ssize_t (scm.size()));
+  close (fd);
+  TASSERT (storage.store_file_buffer ("sample.flac", flac));
+  Bse::Test::Timer timer (1.0);
+  const double bench_time = timer.benchmark ([&] () { TASSERT (storage.export_as (filename)); });
+  const size_t n_bytes = scm.size() + flac.size();
+  struct stat st = { 0, };
+  TASSERT (stat (filename.c_str(), &st) == 0);
+  Bse::printerr ("  BENCH    Storage::export_as:   %u threads: %8.1f MB/s, %.1f%% of %u MB\n",
+                 std::max (1, this_thread_online_cpus()), n_bytes / bench_time / M,
+                 st.st_size * 100.0 / n_bytes, n_bytes / (1024 * 1024));
+  Bse::Storage reader;
+  TASSERT (reader.import_from (filename));
+  TASSERT (reader.fetch_file_buffer ("mimetype") == "application/x-bse");
+  TASSERT (reader.fetch_file_buffer ("bse_storage.scm") == scm);
+  TASSERT (reader.fetch_file_buffer ("sample.flac") == flac);
+  unlink (filename.c_str());
+}
+TEST_BENCH (storage_save_bench);
+
+// == Oscillator Benchmarks ==
+static void
+gsl_osc_bench()
+{
+  const float table_freqs[] = { 27.5, 55, 110, 220, 440, 880, 1760, 3520, 7040 };
+  GslOscTable *table = gsl_osc_table_create (48000, GSL_OSC_WAVE_SAW_RISE, bse_window_blackman,
+                                             G_N_ELEMENTS (table_freqs), table_freqs);
+  TASSERT (table != NULL);
+  const uint n_oscs = 64, n_values = 128;
+  float freq_in[n_values], mod_in[n_values], mono_out[n_values];
+  for (uint i = 0; i < n_values; i++)
+    {
+      freq_in[i] = BSE_SIGNAL_FROM_FREQ (440);
+      mod_in[i] = 0.5 * sin (i * 0.1);
+    }
+  struct OscCase { const char *name; const float *ifreq, *imod; bool exponential_fm; };
+  const OscCase cases[] = {
+    { "free running",   NULL,    NULL,   false },
+    { "freq input",     freq_in, NULL,   false },
+    { "linear fm",      NULL,    mod_in, false },
+    { "exponential fm", NULL,    mod_in, true },
+  };
+  std::vector<GslOscData> oscs (n_oscs);
+  Bse::Test::Timer timer (MAXTIME);
+  for (const OscCase &c : cases)
+    {
+      for (uint k = 0; k < n_oscs; k++)
+        {
+          GslOscConfig config = { 0, };
+          config.table = table;
+          config.exponential_fm = c.exponential_fm;
+          config.fm_strength = c.exponential_fm ? 1 : 0.25;
+          config.cfreq = 110 + k * 7;
+          config.transpose_factor = 1;
+          gsl_osc_reset (&oscs[k]);
+          gsl_osc_config (&oscs[k], &config);
+        }
+      auto loop_oscs = [&] () {
+        for (GslOscData &osc : oscs)
+          gsl_osc_process (&osc, n_values, c.ifreq, c.imod, NULL, mono_out, NULL);
+      };
+      const double bench_time = timer.benchmark (loop_oscs);
+      Bse::printerr ("  BENCH    GslOsc %-14s %-4s %3u oscillators: %8.1f MSamples/s\n",
+                     c.name, gsl_osc_impl_name(), n_oscs, n_oscs * n_values / bench_time / M);
+      for (uint i = 0; i < n_values; i++)
+        TASSERT (fabs (mono_out[i]) <= 1.01);
+    }
+  gsl_osc_table_free (table);
+}
+TEST_BENCH (gsl_osc_bench);
+
+} // Anon
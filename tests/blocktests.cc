@@ -209,6 +209,30 @@ test_scale (void)
   TPASS ("BlockScale");
 }
 
+static void
+test_interleave2 (void)
+{
+  float fblock1[1024], fblock2[2 * 1024];
+  for (int i = 0; i < 1024; i++)
+    fblock1[i] = i;
+  Bse::Block::fill (2 * 1024, fblock2, -1.f);
+  Bse::Block::interleave2 (1023, fblock2, fblock1 + 1, 1);   // odd length exercises the tails
+  for (int i = 0; i < 1023; i++)
+    {
+      TCMP (fblock2[2 * i], ==, -1.f);
+      TCMP (fblock2[2 * i + 1], ==, i + 1.f);
+    }
+  TCMP (fblock2[2 * 1023 + 1], ==, -1.f);
+  Bse::Block::interleave2 (1024, fblock2, fblock1, 0);
+  Bse::Block::interleave2_add (1024, fblock2, fblock1, 1);
+  for (int i = 0; i < 1023; i++)
+    {
+      TCMP (fblock2[2 * i], ==, float (i));
+      TCMP (fblock2[2 * i + 1], ==, 2 * i + 1.f);
+    }
+  TPASS ("BlockInterleave2");
+}
+
 #define RUNS        11
 #define MAX_SECONDS 0.1
 const int BLOCK_SIZE = 1024;
@@ -225,7 +249,7 @@ bench_fill ()
   };
   Bse::Test::Timer timer (MAX_SECONDS);
   const double bench_time = timer.benchmark (loop);
-  TPASS ("Block::fill       # timing: fastest=%fs throughput=%.1fMB/s\n", bench_time, bytes_per_loop / bench_time / 1048576.);
+  TPASS ("%-6s Block::fill       # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
 }
 
 static inline void
@@ -242,7 +266,7 @@ bench_copy (void)
   };
   Bse::Test::Timer timer (MAX_SECONDS);
   const double bench_time = timer.benchmark (loop);
-  TPASS ("Block::copy       # timing: fastest=%fs throughput=%.1fMB/s\n", bench_time, bytes_per_loop / bench_time / 1048576.);
+  TPASS ("%-6s Block::copy       # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
 }
 
 static inline void
@@ -259,7 +283,7 @@ bench_add (void)
   };
   Bse::Test::Timer timer (MAX_SECONDS);
   const double bench_time = timer.benchmark (loop);
-  TPASS ("Block::add        # timing: fastest=%fs throughput=%.1fMB/s\n", bench_time, bytes_per_loop / bench_time / 1048576.);
+  TPASS ("%-6s Block::add        # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
 }
 
 static inline void
@@ -276,7 +300,7 @@ bench_sub (void)
   };
   Bse::Test::Timer timer (MAX_SECONDS);
   const double bench_time = timer.benchmark (loop);
-  TPASS ("Block::sub        # timing: fastest=%fs throughput=%.1fMB/s\n", bench_time, bytes_per_loop / bench_time / 1048576.);
+  TPASS ("%-6s Block::sub        # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
 }
 
 static inline void
@@ -293,7 +317,7 @@ bench_mul (void)
   };
   Bse::Test::Timer timer (MAX_SECONDS);
   const double bench_time = timer.benchmark (loop);
-  TPASS ("Block::mul        # timing: fastest=%fs throughput=%.1fMB/s\n", bench_time, bytes_per_loop / bench_time / 1048576.);
+  TPASS ("%-6s Block::mul        # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
 }
 
 static inline void
@@ -310,7 +334,47 @@ bench_scale (void)
   };
   Bse::Test::Timer timer (MAX_SECONDS);
   const double bench_time = timer.benchmark (loop);
-  TPASS ("Block::scale      # timing: fastest=%fs throughput=%.1fMB/s\n", bench_time, bytes_per_loop / bench_time / 1048576.);
+  TPASS ("%-6s Block::scale      # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
+}
+
+static inline void
+bench_interleave2 (void)
+{
+  float fblock1[BLOCK_SIZE], fblock2[2 * BLOCK_SIZE];
+  Bse::Block::fill (BLOCK_SIZE, fblock1, 2.f);
+  Bse::Block::fill (2 * BLOCK_SIZE, fblock2, 0.f);
+
+  const uint bytes_per_loop = sizeof (fblock1) * 2 * RUNS;
+  auto loop = [&fblock1, &fblock2] () {
+    for (uint j = 0; j < RUNS; j++)
+      {
+        Bse::Block::interleave2 (BLOCK_SIZE, fblock2, fblock1, 0);
+        Bse::Block::interleave2 (BLOCK_SIZE, fblock2, fblock1, 1);
+      }
+  };
+  Bse::Test::Timer timer (MAX_SECONDS);
+  const double bench_time = timer.benchmark (loop);
+  TPASS ("%-6s Block::interleave2 # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
+}
+
+static inline void
+bench_interleave2_add (void)
+{
+  float fblock1[BLOCK_SIZE], fblock2[2 * BLOCK_SIZE];
+  Bse::Block::fill (BLOCK_SIZE, fblock1, 2.f);
+  Bse::Block::fill (2 * BLOCK_SIZE, fblock2, 0.f);
+
+  const uint bytes_per_loop = sizeof (fblock1) * 2 * RUNS;
+  auto loop = [&fblock1, &fblock2] () {
+    for (uint j = 0; j < RUNS; j++)
+      {
+        Bse::Block::interleave2_add (BLOCK_SIZE, fblock2, fblock1, 0);
+        Bse::Block::interleave2_add (BLOCK_SIZE, fblock2, fblock1, 1);
+      }
+  };
+  Bse::Test::Timer timer (MAX_SECONDS);
+  const double bench_time = timer.benchmark (loop);
+  TPASS ("%-6s Block::interleave2+ # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
 }
 
 static inline void
@@ -335,7 +399,7 @@ bench_range (void)
   const double bench_time = timer.benchmark (loop);
   assert_return (min_value == correct_min_value);
   assert_return (max_value == correct_max_value);
-  TPASS ("Block::range      # timing: fastest=%fs throughput=%.1fMB/s\n", bench_time, bytes_per_loop / bench_time / 1048576.);
+  TPASS ("%-6s Block::range      # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
 }
 
 static inline void
@@ -351,7 +415,7 @@ bench_square_sum (void)
   };
   Bse::Test::Timer timer (MAX_SECONDS);
   const double bench_time = timer.benchmark (loop);
-  TPASS ("Block::sum²       # timing: fastest=%fs throughput=%.1fMB/s\n", bench_time, bytes_per_loop / bench_time / 1048576.);
+  TPASS ("%-6s Block::sum²       # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
 }
 
 static inline void
@@ -376,7 +440,7 @@ bench_range_and_square_sum (void)
   const double bench_time = timer.benchmark (loop);
   assert_return (min_value == correct_min_value);
   assert_return (max_value == correct_max_value);
-  TPASS ("Block::range+sum² # timing: fastest=%fs throughput=%.1fMB/s\n", bench_time, bytes_per_loop / bench_time / 1048576.);
+  TPASS ("%-6s Block::range+sum² # timing: fastest=%fs throughput=%.1fMB/s\n", Bse::Block::impl_name(), bench_time, bytes_per_loop / bench_time / 1048576.);
 }
 
 static void
@@ -388,6 +452,7 @@ run_tests()
   test_sub();
   test_mul();
   test_scale();
+  test_interleave2();
   /* the next two functions test the range_and_square_sum function, too */
   test_range();
   test_square_sum();
@@ -398,6 +463,8 @@ run_tests()
   bench_sub();
   bench_mul();
   bench_scale();
+  bench_interleave2();
+  bench_interleave2_add();
   bench_range();
   bench_square_sum();
   bench_range_and_square_sum();
@@ -410,16 +477,16 @@ test_blockutils()
   Bse::String machine = sv.size() >= 2 ? sv[1] : "Unknown";
   printout ("  NOTE     Running on: %s+%s\n", machine.c_str(), bse_block_impl_name());
 
-  TNOTE ("Running Default Block Ops");
-  TASSERT (Bse::Block::default_singleton() == Bse::Block::current_singleton());
-  run_tests(); /* run tests on FPU */
-
-  /* check for possible specialization */
-  if (Bse::Block::default_singleton() == Bse::Block::current_singleton())
-    return;   /* nothing changed */
-
-  TNOTE ("Running Intrinsic Block Ops");
-  TASSERT (Bse::Block::default_singleton() != Bse::Block::current_singleton());
-  run_tests(); /* run tests with intrinsics */
+  /* the widest kernels are selected at startup, test and benchmark all usable ones */
+  Bse::Block::Impl *const current = Bse::Block::current_singleton();
+  const std::vector<Bse::Block::Impl*> impls = Bse::Block::available_impls();
+  TASSERT (impls.back() == Bse::Block::default_singleton());
+  for (Bse::Block::Impl *impl : impls)
+    {
+      Bse::Block::substitute (impl);
+      TNOTE ("Running %s Block Ops", Bse::Block::impl_name());
+      run_tests();
+    }
+  Bse::Block::substitute (current);
 }
 TEST_ADD (test_blockutils);
@@ -50,6 +50,76 @@ test_serializable_configuration()
 }
 TEST_ADD (test_serializable_configuration);
 
+// test_serializable_stream
+struct SerializableConfigurations : public virtual Xms::SerializableInterface {
+  std::vector<Preferences> configs_;
+protected:
+  void
+  xml_serialize (Xms::SerializationNode &xs) override
+  {
+    xs["configs"] & configs_;
+  }
+};
+
+static SerializableConfigurations
+make_configurations (size_t n)
+{
+  SerializableConfigurations cfgs;
+  for (size_t i = 0; i < n; i++)
+    {
+      Preferences p;
+      p.synth_latency = 1 + i % 3000;
+      p.invert_sustain = i & 1;
+      p.author_default = string_format ("Author <%u> & \"Co\"\tTab", i);
+      p.sample_path = string_format ("/usr/share/samples/%u;~/samples", i);
+      cfgs.configs_.push_back (p);
+    }
+  return cfgs;
+}
+
+static void
+test_serializable_stream()
+{
+  SerializableConfigurations cfgs1 = make_configurations (7), cfgs2;
+  String xmltext;
+  {
+    Xms::XmlWriter xw (xmltext);
+    xw.begin ("Root");
+    xw.save ("configs", cfgs1.configs_);
+    xw.end();
+  }
+  Xms::SerializationNode xs;
+  TASSERT (Bse::Error::NONE == xs.parse_xml ("Root", xmltext, nullptr));
+  xs.load (cfgs2);
+  TASSERT (cfgs1.configs_ == cfgs2.configs_);
+  // printout ("%s\n", xmltext);
+}
+TEST_ADD (test_serializable_stream);
+
+static void
+bench_serializable_stream()
+{
+  SerializableConfigurations cfgs = make_configurations (512);
+  String xmltext;
+  Bse::Test::Timer timer (0.5);
+  const double dom_time = timer.benchmark ([&] () {
+      Xms::SerializationNode xs;
+      xs.save (cfgs);
+      xmltext = xs.write_xml ("Root");
+    });
+  const size_t dom_size = xmltext.size();
+  const double stream_time = timer.benchmark ([&] () {
+      xmltext.clear();                                  // keeps capacity
+      Xms::XmlWriter xw (xmltext);
+      xw.begin ("Root");
+      xw.save ("configs", cfgs.configs_);
+    });
+  const double n = cfgs.configs_.size();
+  Bse::printerr ("  BENCH    SerializationNode::write_xml: %11.1f Records/s (%u bytes)\n", n / dom_time, dom_size);
+  Bse::printerr ("  BENCH    Xms::XmlWriter::save:         %11.1f Records/s (%u bytes)\n", n / stream_time, xmltext.size());
+}
+TEST_BENCH (bench_serializable_stream);
+
 // test_serializable_hierarchy
 class FrobnicatorBase : public virtual Xms::SerializableInterface {
 protected:
@@ -0,0 +1,204 @@
+// This Source Code Form is licensed MPL-2.0: http://mozilla.org/MPL/2.0
+#include <bse/testing.hh>
+#include <bse/randomhash.hh>
+#include "devices/convolver/convolution.hh"
+#include "devices/blepsynth/bleposc.hh"
+#include "devices/blepsynth/laddervcf.hh"
+
+using namespace Bse;
+
+// == Convolver ==
+static void
+convolution_partitioning()
+{
+  using namespace Bse::ConvolverUtils;
+  // sparse stereo impulse response with taps at the segment and partition boundaries
+  const uint ir_length = 2 * TAIL2_SIZE + 3000;
+  const uint taps[] = { 0, 1, HEAD_SIZE - 1, HEAD_SIZE, 3 * HEAD_SIZE + 17,
+                        2 * TAIL1_SIZE - 1, 2 * TAIL1_SIZE, 3 * TAIL1_SIZE, 5 * TAIL1_SIZE + 99,
+                        2 * TAIL2_SIZE - 1, 2 * TAIL2_SIZE, ir_length - 1 };
+  std::vector<float> ir[2];
+  std::vector<std::pair<uint, float>> sparse[2];
+  for (uint c = 0; c < 2; c++)
+    {
+      ir[c].resize (ir_length);
+      for (uint t : taps)
+        {
+          ir[c][t] = random_frange (-1, +1);
+          sparse[c].push_back ({ t, ir[c][t] });
+        }
+    }
+  Convolution convolution (ir);
+  TCMP (convolution.ir_length(), ==, ir_length);
+  // convolve a random signal block wise, the workers are never late
+  const uint n_frames = (ir_length + 2 * TAIL2_SIZE) / HEAD_SIZE * HEAD_SIZE;
+  std::vector<float> input[2], output[2];
+  for (uint c = 0; c < 2; c++)
+    {
+      input[c].resize (n_frames);
+      output[c].resize (n_frames);
+      for (uint i = 0; i < n_frames; i++)
+        input[c][i] = random_frange (-1, +1);
+    }
+  for (uint i = 0; i < n_frames; i += HEAD_SIZE)
+    {
+      const float *iblock[2] = { &input[0][i], &input[1][i] };
+      float *oblock[2] = { &output[0][i], &output[1][i] };
+      convolution.sync();
+      convolution.process (iblock, oblock);
+    }
+  // compare against direct convolution, the partitioning adds no latency
+  double max_error = 0;
+  for (uint c = 0; c < 2; c++)
+    for (uint i = 0; i < n_frames; i++)
+      {
+        double sum = 0;
+        for (const auto &tap : sparse[c])
+          if (tap.first <= i)
+            sum += tap.second * input[c][i - tap.first];
+        max_error = std::max (max_error, std::abs (sum - output[c][i]));
+      }
+  TCMP (max_error, <, 1e-4);
+}
+TEST_ADD (convolution_partitioning);
+
+// == BlepSynth ==
+static void
+blep_osc_lanes()
+{
+  using namespace Bse::BlepUtils;
+  // unison voices are rendered in SIMD lanes, compare against the scalar code of single voices
+  const uint n_voices = 5, n_frames = 128;
+  // output of the scalar OscImpl before unison lanes, every 16th stereo frame of some blocks
+  const uint reference_blocks[] = { 0, 1, 49, 50, 99 };
+  const float reference[] = {
+    +0.07246186, -0.14322263, -0.08985360, -0.30072382, +0.62969565, -0.41483158, +0.59469151, +0.38195407,
+    -0.32070059, -0.51110703, -0.54583168, -0.73205227, -0.76523012, -0.94520825, +0.93442595, +0.94763106,
+    +0.12624942, +0.54868603, -0.10821173, +0.30315551, -0.33759663, +0.06421099, +0.63736665, +0.04388604,
+    +0.49251086, +0.21041772, -0.17077734, -0.38594988, -0.39832804, -0.60875070, -0.61967760, -0.82107943,
+    +0.79387754, +0.07713654, +0.51105106, -0.31055769, -0.02076936, -0.33580443, -0.30151227, -0.56973505,
+    -0.35431460, +0.19895279, +0.36548552, +0.90765762, -0.45927867, +0.50931293, +0.19193000, -0.09758388,
+    -0.04690018, -0.34053856, +0.74313915, -0.39756319, +0.21567228, -0.98663300, -0.33521023, +0.02201403,
+    -0.55973399, -0.21131495, -0.60451925, +0.55337042, -0.53735453, +0.63386959, -0.47895285, +0.21531054,
+    +0.92048526, -0.70959508, +0.63140744, -0.96160412, +0.55813164, -0.18706293, -0.01303492, +0.72290665,
+    -0.79824150, +0.37558770, -0.25046721, +0.89098841, -0.51728731, +0.59926051, -0.75208485, +0.30923301,
+  };
+  auto setup = [] (OscImpl &osc) {
+    osc.set_rate (48000);
+    osc.frequency_base = 220;
+    osc.shape_base = -0.3;
+    osc.sub_base = 0.2;
+    osc.sync_base = 7;
+    osc.freq_mod_octaves = 1;
+    osc.pulse_width_mod = 0.3;
+  };
+  OscImpl unison, voices[n_voices];
+  setup (unison);
+  unison.set_unison (n_voices, 9, 0.7);
+  for (uint v = 0; v < n_voices; v++)
+    {
+      const double phase = 0.1 + 0.17 * v;
+      unison.reset_master (unison.unison_voices[v], phase);
+      setup (voices[v]);
+      voices[v].frequency_factor = unison.unison_voices[v].freq_factor;
+      voices[v].reset_master (voices[v].unison_voices[0], phase);
+    }
+  double max_error = 0, max_reference_error = 0;
+  const float *reference_frames = reference;
+  for (uint b = 0; b < 100; b++)
+    {
+      // modulation inputs are only connected for the first half
+      float freq_mod[n_frames], pulse_mod[n_frames];
+      for (uint i = 0; i < n_frames; i++)
+        {
+          freq_mod[i] = 0.1 * sin ((b * n_frames + i) * 0.001);
+          pulse_mod[i] = 0.5 * cos ((b * n_frames + i) * 0.003);
+        }
+      const bool mod = b < 50;
+      float left[n_frames], right[n_frames];
+      unison.process_sample_stereo (left, right, n_frames, nullptr, mod ? freq_mod : nullptr,
+                                    nullptr, nullptr, nullptr, mod ? pulse_mod : nullptr);
+      double expected_left[n_frames] = { 0, }, expected_right[n_frames] = { 0, };
+      for (uint v = 0; v < n_voices; v++)
+        {
+          float voice_left[n_frames], voice_right[n_frames];
+          voices[v].process_sample_stereo (voice_left, voice_right, n_frames, nullptr, mod ? freq_mod : nullptr,
+                                           nullptr, nullptr, nullptr, mod ? pulse_mod : nullptr);
+          for (uint i = 0; i < n_frames; i++)
+            {
+              expected_left[i] += voice_left[i] * unison.unison_voices[v].left_factor;
+              expected_right[i] += voice_right[i] * unison.unison_voices[v].right_factor;
+            }
+        }
+      for (uint i = 0; i < n_frames; i++)
+        {
+          max_error = std::max (max_error, std::abs (expected_left[i] - left[i]));
+          max_error = std::max (max_error, std::abs (expected_right[i] - right[i]));
+        }
+      if (std::find (std::begin (reference_blocks), std::end (reference_blocks), b) != std::end (reference_blocks))
+        for (uint i = 0; i < n_frames; i += 16)
+          {
+            max_reference_error = std::max (max_reference_error, double (std::abs (*reference_frames++ - left[i])));
+            max_reference_error = std::max (max_reference_error, double (std::abs (*reference_frames++ - right[i])));
+          }
+    }
+  TCMP (reference_frames, ==, reference + sizeof (reference) / sizeof (reference[0]));
+  TCMP (max_error, <, 1e-4);
+  TCMP (max_reference_error, <, 1e-4);
+}
+TEST_ADD (blep_osc_lanes);
+
+static void
+ladder_vcf_lanes()
+{
+  // voices are filtered in SIMD lanes, compare against LadderVCF for each group size
+  typedef LadderVCFVoicesNonLinear VCFVoices;
+  const uint n_frames = 128;
+  for (uint n_voices = 1; n_voices <= VCFVoices::VOICES; n_voices++)
+    {
+      VCFVoices vcf_voices;
+      VCFVoices::Voice voices[VCFVoices::VOICES];
+      LadderVCFNonLinear vcfs[VCFVoices::VOICES];
+      vcf_voices.set_mode (LadderVCFMode::LP2);
+      vcf_voices.set_drive (6);
+      for (auto &vcf : vcfs)
+        {
+          vcf.set_mode (LadderVCFMode::LP2);
+          vcf.set_drive (6);
+        }
+      double max_error = 0;
+      for (uint b = 0; b < 50; b++)
+        {
+          float input[2 * VCFVoices::VOICES][n_frames], output[2 * VCFVoices::VOICES][n_frames];
+          float expected[2 * VCFVoices::VOICES][n_frames], freq[VCFVoices::VOICES][n_frames];
+          const float *inputs[2 * VCFVoices::VOICES], *freq_ins[VCFVoices::VOICES];
+          float *outputs[2 * VCFVoices::VOICES];
+          VCFVoices::Voice *voice_ptrs[VCFVoices::VOICES];
+          for (uint v = 0; v < n_voices; v++)
+            {
+              for (uint i = 0; i < n_frames; i++)
+                {
+                  input[2 * v][i] = random_frange (-1, +1);
+                  input[2 * v + 1][i] = random_frange (-1, +1);
+                  freq[v][i] = 0.02 + 0.3 * (0.5 + 0.5 * sin ((b * n_frames + i) * 0.0003 * (v + 1)));
+                }
+              const float *voice_inputs[2] = { input[2 * v], input[2 * v + 1] };
+              float *voice_outputs[2] = { expected[2 * v], expected[2 * v + 1] };
+              vcfs[v].run_block (n_frames, 0.5, 0.6, voice_inputs, voice_outputs, true, true, freq[v], nullptr, nullptr, nullptr);
+              for (uint c = 0; c < 2; c++)
+                {
+                  inputs[2 * v + c] = input[2 * v + c];
+                  outputs[2 * v + c] = output[2 * v + c];
+                }
+              freq_ins[v] = freq[v];
+              voice_ptrs[v] = &voices[v];
+            }
+          vcf_voices.run_block (n_voices, voice_ptrs, n_frames, 0.6, inputs, outputs, freq_ins);
+          for (uint l = 0; l < 2 * n_voices; l++)
+            for (uint i = 0; i < n_frames; i++)
+              max_error = std::max (max_error, double (std::abs (expected[l][i] - output[l][i])));
+        }
+      TCMP (max_error, <, 1e-4);
+    }
+}
+TEST_ADD (ladder_vcf_lanes);
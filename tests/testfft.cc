@@ -136,6 +136,88 @@ test_fft_variants()
 }
 TEST_ADD (test_fft_variants);
 
+static double
+max_float_diff (guint n, const double *a, const float *b, double scale)
+{
+  double d = 0;
+  for (guint i = 0; i < n; i++)
+    d = MAX (d, fabs (a[i] - b[i]) * scale);
+  return d;
+}
+
+static void
+test_fft_plans()
+{
+  const double FLOAT_EPSILON = 4e-6;
+  std::vector<double> din (MAX_FFT_SIZE), dout (MAX_FFT_SIZE), dback (MAX_FFT_SIZE);
+  std::vector<float> fin (MAX_FFT_SIZE), fout (MAX_FFT_SIZE), fback (MAX_FFT_SIZE);
+  // check every kernel set the CPU supports, not just the one picked by default
+  for (const char *impl : { "FPU", "SSE", "AVX2" })
+    {
+      for (guint n = 4; n <= MAX_FFT_SIZE >> 1; n <<= 1)
+        {
+          GslFftPlan *plan = gsl_fft_plan_new_impl (n, impl);
+          if (!plan)
+            break;          // kernels unsupported by CPU or build
+          fill_rand (n << 1, &din[0]);
+          for (guint i = 0; i < n << 1; i++)
+            fin[i] = din[i];
+          // complex variants, errors are relative to the expected spectrum magnitude
+          const double cnorm = 1.0 / sqrt (n);
+          gsl_power2_fftac (n, &din[0], &dout[0]);
+          gsl_fft_plan_fftac (plan, &fin[0], &fout[0]);
+          double d = max_float_diff (n << 1, &dout[0], &fout[0], cnorm);
+          TCHECK (d < FLOAT_EPSILON, "FFT-%u %s plan analysis below epsilon: %g < %g", n, gsl_fft_plan_impl_name (plan), d, FLOAT_EPSILON);
+          gsl_power2_fftsc (n, &din[0], &dback[0]);
+          gsl_fft_plan_fftsc (plan, &fin[0], &fback[0]);
+          d = max_float_diff (n << 1, &dback[0], &fback[0], cnorm);
+          TCHECK (d < FLOAT_EPSILON, "FFT-%u %s plan synthesis below epsilon: %g < %g", n, gsl_fft_plan_impl_name (plan), d, FLOAT_EPSILON);
+          gsl_fft_plan_fftsc_scale (plan, &fout[0], &fback[0]);
+          d = max_float_diff (n << 1, &din[0], &fback[0], 1);
+          TCHECK (d < FLOAT_EPSILON, "FFT-%u %s plan analysis and scaled re-synthesis: %g < %g", n, gsl_fft_plan_impl_name (plan), d, FLOAT_EPSILON);
+          // real variants
+          gsl_power2_fftar (n, &din[0], &dout[0]);
+          gsl_fft_plan_fftar (plan, &fin[0], &fout[0]);
+          d = max_float_diff (n, &dout[0], &fout[0], cnorm);
+          TCHECK (d < FLOAT_EPSILON, "FFT-%u %s plan real analysis below epsilon: %g < %g", n, gsl_fft_plan_impl_name (plan), d, FLOAT_EPSILON);
+          gsl_power2_fftsr (n, &dout[0], &dback[0]);
+          gsl_fft_plan_fftsr (plan, &fout[0], &fback[0]);
+          d = max_float_diff (n, &dback[0], &fback[0], 1.0 / n);
+          TCHECK (d < FLOAT_EPSILON, "FFT-%u %s plan real synthesis below epsilon: %g < %g", n, gsl_fft_plan_impl_name (plan), d, FLOAT_EPSILON);
+          gsl_fft_plan_fftsr_scale (plan, &fout[0], &fback[0]);
+          d = max_float_diff (n, &din[0], &fback[0], 1);
+          TCHECK (d < FLOAT_EPSILON, "FFT-%u %s plan real analysis and scaled re-synthesis: %g < %g", n, gsl_fft_plan_impl_name (plan), d, FLOAT_EPSILON);
+          gsl_fft_plan_free (plan);
+        }
+    }
+}
+TEST_ADD (test_fft_plans);
+
+static void
+bench_fft_plans()
+{
+  std::vector<double> din (MAX_FFT_SIZE), dout (MAX_FFT_SIZE);
+  std::vector<float> fin (MAX_FFT_SIZE), fout (MAX_FFT_SIZE);
+  fill_rand (MAX_FFT_SIZE, &din[0]);
+  for (guint i = 0; i < MAX_FFT_SIZE; i++)
+    fin[i] = din[i];
+  for (guint n = 64; n <= 65536; n <<= 2)
+    {
+      GslFftPlan *plan = gsl_fft_plan_new (n);
+      Bse::Test::Timer timer (0.1);
+      const double gsl_complex = timer.benchmark ([&] () { gsl_power2_fftac (n, &din[0], &dout[0]); });
+      const double plan_complex = timer.benchmark ([&] () { gsl_fft_plan_fftac (plan, &fin[0], &fout[0]); });
+      const double gsl_real = timer.benchmark ([&] () { gsl_power2_fftar (n, &din[0], &dout[0]); });
+      const double plan_real = timer.benchmark ([&] () { gsl_fft_plan_fftar (plan, &fin[0], &fout[0]); });
+      Bse::printerr ("  BENCH    FFT-%-5u complex: gsl_power2_fftac: %9.2fus gsl_fft_plan_fftac (%s): %9.2fus (%.2fx)\n",
+                     n, gsl_complex * 1e6, gsl_fft_plan_impl_name (plan), plan_complex * 1e6, gsl_complex / plan_complex);
+      Bse::printerr ("  BENCH    FFT-%-5u real:    gsl_power2_fftar: %9.2fus gsl_fft_plan_fftar (%s): %9.2fus (%.2fx)\n",
+                     n, gsl_real * 1e6, gsl_fft_plan_impl_name (plan), plan_real * 1e6, gsl_real / plan_real);
+      gsl_fft_plan_free (plan);
+    }
+}
+TEST_BENCH (bench_fft_plans);
+
 static void
 fill_rand (guint   n,
 	   double *a)
@@ -4,6 +4,10 @@
 #include <sys/resource.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <string.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <map>
 
 using namespace Bse;
 using namespace BseTool;
@@ -268,22 +272,47 @@ static CommandRegistry standard_synth_cmd (standard_synth_options, standard_synt
 // == render2wav ==
 static ArgDescription render2wav_options[] = {
   { "-s, --seconds", "<seconds>", "Number of seconds to record", "0" },
+  { "-b, --bits",    "<bits>",    "Sample format: 16, 24 or 32 (float)", "16" },
+  { "--realtime",    "",          "Render in real time through the configured PCM driver", "" },
   { "<bse-file>",    "",          "The BSE file for audio rendering", "" },
   { "<wav-file>",    "",          "The WAV file to use for audio output", "" },
 };
 
+static double
+wav_file_seconds (const String &wavfile)
+{
+  // parse the canonical 44 byte header written by BsePcmWriter
+  uint8 header[44];
+  FILE *file = fopen (wavfile.c_str(), "rb");
+  const bool valid = file && fread (header, sizeof (header), 1, file) == 1 && memcmp (header, "RIFF", 4) == 0;
+  if (file)
+    fclose (file);
+  if (!valid)
+    return 0;
+  auto le32 = [&header] (uint o) { return header[o] | header[o + 1] << 8 | header[o + 2] << 16 | uint32 (header[o + 3]) << 24; };
+  const uint32 byte_rate = le32 (28), data_bytes = le32 (40);
+  return byte_rate ? data_bytes / double (byte_rate) : 0;
+}
+
 static String
 render2wav (const ArgParser &ap)
 {
   const String bsefile = ap["bse-file"];
   const String wavfile = ap["wav-file"];
   const double n_seconds = string_to_double (ap["seconds"]);
+  const int n_bits = string_to_int (ap["bits"]);
+  if (n_bits != 16 && n_bits != 24 && n_bits != 32)
+    return string_format ("invalid number of bits: %s", ap["bits"]);
+  const bool realtime = string_to_bool (ap["realtime"]);
   auto project = BSE_SERVER.create_project (bsefile);
   project->auto_deactivate (0);
   auto err = project->restore_from_file (bsefile);
   if (err != 0)
     return bse_error_blurb (err);
-  BSE_SERVER.start_recording (wavfile, n_seconds);
+  BSE_SERVER.freewheel (!realtime);
+  BSE_SERVER.start_recording (wavfile, n_seconds, n_bits);
+  BSE_SERVER.profile_reset();
+  const uint64 start_usecs = timestamp_realtime();
   err = project->play();
   printq ("Recording %s to %s...\n", bsefile, wavfile);
   printq (".");
@@ -301,13 +330,102 @@ render2wav (const ArgParser &ap)
       counter = (counter + 1) % 50;
     }
   printq ("\n");
-
+  const double elapsed = (timestamp_realtime() - start_usecs) * 0.000001;
+  const ProfileReport report = BSE_SERVER.profile_report();
+  // closing the devices closes the PCM writer, which patches the WAV header length
+  project->deactivate();
+  const double seconds = wav_file_seconds (wavfile);
+  if (seconds > 0 && elapsed > 0)
+    printq ("Rendered %.3f seconds of audio in %.3f seconds: %.2fx real-time\n", seconds, elapsed, seconds / elapsed);
+  if (report.blocks)
+    printq ("DSP load over %u blocks: %.2f%% average, %.2f%% maximum\n", uint (report.blocks),
+            100.0 * report.dsp_load_avg, 100.0 * report.dsp_load_max);
   return "";
 }
 
 static CommandRegistry render2wav_cmd (render2wav_options, render2wav, "render2wav", "Render audio from a .bse file into a WAV file");
 
 
+// == render-batch ==
+static ArgDescription render_batch_options[] = {
+  { "-j, --jobs",    "<jobs>",    "Number of projects to render concurrently", "0" },
+  { "-s, --seconds", "<seconds>", "Number of seconds to record", "0" },
+  { "-b, --bits",    "<bits>",    "Sample format: 16, 24 or 32 (float)", "16" },
+  { "<output-dir>",  "",          "Directory for the rendered WAV files", "" },
+  { "[bse-files...]", "",         "The BSE files for audio rendering", "" },
+};
+
+static String
+render_batch (const ArgParser &ap)
+{
+  // The engine, sequencer, tick stamps and the PCM writer (which records the master
+  // mix of all playing projects) are process wide, so each project is rendered by a
+  // render2wav child process with its own engine, scheduling and WAV output.
+  const String outdir = ap["output-dir"];
+  if (!Path::check (outdir, "d"))
+    return string_format ("not a directory: %s", outdir);
+  const long n_cpus = sysconf (_SC_NPROCESSORS_ONLN);
+  const uint max_jobs = string_to_int (ap["jobs"]) > 0 ? string_to_int (ap["jobs"]) : MAX (1, n_cpus);
+  // output names derive from the input basenames, reject inputs that would overwrite each other
+  std::map<String, String> wavfiles;
+  StringVector jobs;
+  for (const String &bsefile : ap.dynamics())
+    {
+      const String wavfile = Path::join (outdir, Path::split_extension (Path::basename (bsefile), true).first + ".wav");
+      auto it = wavfiles.find (wavfile);
+      if (it != wavfiles.end())
+        return string_format ("conflicting output file %s for: %s %s", wavfile, it->second, bsefile);
+      wavfiles[wavfile] = bsefile;
+      jobs.push_back (wavfile);
+    }
+  const String exe = "/proc/self/exe";
+  std::map<pid_t, String> children;
+  uint n_failed = 0;
+  auto reap_child = [&] () {
+    int status = 0;
+    const pid_t pid = waitpid (-1, &status, 0);
+    auto it = children.find (pid);
+    if (it == children.end())
+      return;
+    if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+      {
+        printerr ("render-batch: failed to render: %s\n", it->second);
+        n_failed++;
+      }
+    children.erase (it);
+  };
+  const uint64 start_usecs = timestamp_realtime();
+  for (const String &wavfile : jobs)
+    {
+      const String &bsefile = wavfiles[wavfile];
+      while (children.size() >= max_jobs)
+        reap_child();
+      StringVector args = { exe, "--quiet", "render2wav", "--seconds", ap["seconds"], "--bits", ap["bits"], bsefile, wavfile };
+      std::vector<char*> argv;
+      for (auto &arg : args)
+        argv.push_back (&arg[0]);
+      argv.push_back (nullptr);
+      pid_t pid = -1;
+      const int err = posix_spawn (&pid, exe.c_str(), nullptr, nullptr, argv.data(), environ);
+      if (err)
+        {
+          printerr ("render-batch: %s: %s\n", bsefile, strerror (err));
+          n_failed++;
+          continue;
+        }
+      printq ("Rendering %s to %s...\n", bsefile, wavfile);
+      children[pid] = bsefile;
+    }
+  while (!children.empty())
+    reap_child();
+  printq ("Rendered %zu projects in %.3f seconds\n", ap.dynamics().size() - n_failed,
+          (timestamp_realtime() - start_usecs) * 0.000001);
+  return n_failed ? string_format ("%u projects failed to render", n_failed) : "";
+}
+
+static CommandRegistry render_batch_cmd (render_batch_options, render_batch, "render-batch", "Render several .bse files concurrently into WAV files");
+
+
 // == check-load ==
 static ArgDescription check_load_options[] = {
   { "<bse-file>",    "",          "The BSE file to load and check for validity", "" },